@@ -12,5 +12,15 @@ unsigned char augeas_extension_yang[] = {
   0x74, 0x20, 0x70, 0x61, 0x74, 0x68, 0x3b, 0x7d, 0x65, 0x78, 0x74, 0x65, 0x6e, 0x73, 0x69, 0x6f,
   0x6e, 0x20, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x2d, 0x79, 0x61, 0x6e, 0x67, 0x2d, 0x70, 0x61, 0x74,
   0x68, 0x7b, 0x61, 0x72, 0x67, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x20, 0x70, 0x61, 0x74, 0x68, 0x3b,
-  0x7d, 0x7d, 0x0a, 0x00
+  0x7d, 0x65, 0x78, 0x74, 0x65, 0x6e, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x6c, 0x61, 0x62, 0x65, 0x6c,
+  0x2d, 0x6c, 0x69, 0x74, 0x65, 0x72, 0x61, 0x6c, 0x73, 0x7b, 0x61, 0x72, 0x67, 0x75, 0x6d, 0x65,
+  0x6e, 0x74, 0x20, 0x6c, 0x69, 0x74, 0x65, 0x72, 0x61, 0x6c, 0x73, 0x3b, 0x7d, 0x65, 0x78, 0x74,
+  0x65, 0x6e, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x61, 0x75, 0x74, 0x6f, 0x6c, 0x6f, 0x61, 0x64, 0x2d,
+  0x6c, 0x65, 0x6e, 0x73, 0x7b, 0x61, 0x72, 0x67, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x20, 0x6c, 0x65,
+  0x6e, 0x73, 0x3b, 0x7d, 0x65, 0x78, 0x74, 0x65, 0x6e, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x61, 0x75,
+  0x74, 0x6f, 0x6c, 0x6f, 0x61, 0x64, 0x2d, 0x69, 0x6e, 0x63, 0x6c, 0x7b, 0x61, 0x72, 0x67, 0x75,
+  0x6d, 0x65, 0x6e, 0x74, 0x20, 0x67, 0x6c, 0x6f, 0x62, 0x3b, 0x7d, 0x65, 0x78, 0x74, 0x65, 0x6e,
+  0x73, 0x69, 0x6f, 0x6e, 0x20, 0x61, 0x75, 0x74, 0x6f, 0x6c, 0x6f, 0x61, 0x64, 0x2d, 0x65, 0x78,
+  0x63, 0x6c, 0x7b, 0x61, 0x72, 0x67, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x20, 0x67, 0x6c, 0x6f, 0x62,
+  0x3b, 0x7d, 0x7d, 0x0a, 0x00
 };
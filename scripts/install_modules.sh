@@ -36,22 +36,41 @@ $SYSREPO_PLUGIND -P "$BINARY_DIR/srplgd_augeas.so"
 # get current modules
 SCTL_MODULES=`$SYSREPOCTL -l`
 
+# install the module with statistics of the augeas DS plugin
+if [ -z "`echo "$SCTL_MODULES" | grep "^augeas-ds-stats \+|[^|]*| I"`" ]; then
+    echo "-- Installing Augeas DS plugin statistics YANG module..."
+    $SYSREPOCTL -s "$YANG_DIR" -i "$YANG_DIR/augeas-ds-stats.yang"
+fi
+
+# collect modules that are not installed yet
+LENSES=""
 for LENS in "$@"; do
-    # check that it is not installed already
     SCTL_MODULE=`echo "$SCTL_MODULES" | grep "^$LENS \+|[^|]*| I"`
-    if [ -n "$SCTL_MODULE" ]; then
-        continue
+    if [ -z "$SCTL_MODULE" ]; then
+        LENSES="$LENSES $LENS"
     fi
+done
+if [ -z "$LENSES" ]; then
+    exit 0
+fi
 
+# store startup data of all the modules in files, Augeas is initialized once per job
+TMPDIR=`mktemp -d`
+JOBS=`nproc 2> /dev/null || echo 1`
+echo "-- Reading current configuration of Augeas YANG modules..."
+SRDS_AUGEAS_STATS= "$BINARY_DIR/ay_startup" -o "$TMPDIR" -j $JOBS $LENSES
+
+for LENS in $LENSES; do
     echo "-- Installing Augeas YANG module $LENS..."
 
-    # store startup data of the module in a file
-    TMPFILE=`mktemp -u`.xml
-    "$BINARY_DIR/ay_startup" $LENS > "$TMPFILE"
+    # install with no data if reading the configuration failed
+    if [ ! -f "$TMPDIR/$LENS.xml" ]; then
+        touch "$TMPDIR/$LENS.xml"
+    fi
 
     # install the YANG module
-    $SYSREPOCTL -s "$YANG_DIR" -i "$YANG_DIR/$LENS.yang" -m "startup:augeas DS" -I "$TMPFILE"
-
-    # remove the tmp file
-    rm "$TMPFILE"
+    $SYSREPOCTL -s "$YANG_DIR" -i "$YANG_DIR/$LENS.yang" -m "startup:augeas DS" -I "$TMPDIR/$LENS.xml"
 done
+
+# remove the tmp files
+rm -rf "$TMPDIR"
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <libyang/libyang.h>
 #include <libyang/tree_edit.h>
@@ -216,6 +217,13 @@ ay_ynode_tree_free(struct ay_ynode *tree)
     root->values = NULL;
     ay_transl_table_free(root->patt_table);
     root->patt_table = NULL;
+    if (root->index) {
+        ay_pindex_clean(&root->index->labels);
+        ay_pindex_clean(&root->index->values);
+        ay_pindex_clean(&root->index->patt_table);
+        free(root->index);
+        root->index = NULL;
+    }
 
     LY_ARRAY_FOR(tree, i) {
         free(tree[i].ident);
@@ -1028,10 +1036,11 @@ augyang_print_input_terms(struct augeas *aug, const char *filename, char **str)
  *
  * @param[in] tree Tree of lnodes. Flag AY_LNODE_KEY_HAS_IDENTS can be set.
  * @param[out] table Translation table of lens patterns. The LY_ARRAY must have enough allocated space.
+ * @param[out] index Initialized hash index of @p table which will be filled.
  * @return 1 on success.
  */
 static int
-ay_transl_create_pattern_table(struct ay_lnode *tree, struct ay_transl *table)
+ay_transl_create_pattern_table(struct ay_lnode *tree, struct ay_transl *table, struct ay_pindex *index)
 {
     int ret;
     LY_ARRAY_COUNT_TYPE i;
@@ -1047,7 +1056,7 @@ ay_transl_create_pattern_table(struct ay_lnode *tree, struct ay_transl *table)
         }
 
         origin = tree[i].lens->regexp->pattern->str;
-        if (ay_transl_find(table, origin)) {
+        if (ay_transl_find(table, index, origin)) {
             /* Pattern is already in table. */
             tree[i].flags |= AY_LNODE_KEY_HAS_IDENTS;
             continue;
@@ -1068,6 +1077,8 @@ ay_transl_create_pattern_table(struct ay_lnode *tree, struct ay_transl *table)
         }
 
         /* Successfully deriving identifiers. */
+        ret = ay_pindex_set(index, origin, LY_ARRAY_COUNT(table));
+        AY_CHECK_RET(ret);
         LY_ARRAY_INCREMENT(table);
         tree[i].flags |= AY_LNODE_KEY_HAS_IDENTS;
     }
@@ -1374,6 +1385,7 @@ ay_ynode_set_root(struct ay_ynode *tree, uint32_t tpatt_size, struct ay_lnode *l
     int ret;
     LY_ARRAY_COUNT_TYPE i;
     struct ay_ynode *iter;
+    struct ay_ynode_root *root;
     uint64_t labcount, valcount;
     enum lens_tag tag;
 
@@ -1401,6 +1413,17 @@ ay_ynode_set_root(struct ay_ynode *tree, uint32_t tpatt_size, struct ay_lnode *l
             valcount++;
         }
     }
+    /* Set hash indexes. */
+    root = (struct ay_ynode_root *)tree;
+    root->index = calloc(1, sizeof *root->index);
+    AY_CHECK_COND(!root->index, AYE_MEMORY);
+    ret = ay_pindex_init(&root->index->labels, labcount);
+    AY_CHECK_RET(ret);
+    ret = ay_pindex_init(&root->index->values, valcount);
+    AY_CHECK_RET(ret);
+    ret = ay_pindex_init(&root->index->patt_table, tpatt_size);
+    AY_CHECK_RET(ret);
+
     /* Set labels. */
     if (labcount) {
         LY_ARRAY_CREATE(NULL, AY_YNODE_ROOT_LABELS(tree), labcount, return AYE_MEMORY);
@@ -1412,7 +1435,7 @@ ay_ynode_set_root(struct ay_ynode *tree, uint32_t tpatt_size, struct ay_lnode *l
 
     /* Create translation table for lens.regexp.pattern. */
     LY_ARRAY_CREATE(NULL, AY_YNODE_ROOT_PATT_TABLE(tree), tpatt_size, return AYE_MEMORY);
-    ret = ay_transl_create_pattern_table(ltree, AY_YNODE_ROOT_PATT_TABLE(tree));
+    ret = ay_transl_create_pattern_table(ltree, AY_YNODE_ROOT_PATT_TABLE(tree), AY_YNODE_ROOT_PATT_INDEX(tree));
     AY_CHECK_RET(ret);
 
     /* Set idcnt. */
@@ -2722,6 +2745,524 @@ ay_ynode_copy_subtree_as_sibling(struct ay_ynode *tree, struct ay_ynode *dst, st
     ay_ynode_copy_subtree_when_ref_correction(copied_subtree, original_subtree);
 }
 
+/**
+ * @brief Kind of edit recorded in the struct ay_ynode_edits.
+ *
+ * The edits have the same effect as the corresponding ay_ynode_insert_* and ay_ynode_copy_subtree_* functions.
+ */
+enum ay_ynode_edit_op {
+    AY_EDIT_WRAPPER = 0,        /**< New parent for the anchor, see ay_ynode_insert_wrapper(). */
+    AY_EDIT_PARENT_FOR_REST,    /**< New parent for the anchor and the nodes behind it,
+                                     see ay_ynode_insert_parent_for_rest(). */
+    AY_EDIT_CHILD,              /**< New first child of the anchor, see ay_ynode_insert_child(). */
+    AY_EDIT_SIBLING,            /**< New node right behind the anchor, see ay_ynode_insert_sibling(). */
+    AY_EDIT_COPY_SIBLING,       /**< Copy of a subtree right behind the anchor. */
+    AY_EDIT_COPY_LAST_CHILD     /**< Copy of a subtree as the last child of the anchor,
+                                     see ay_ynode_copy_subtree_as_last_child(). */
+};
+
+/**
+ * @brief One recorded edit of the ynode tree.
+ *
+ * Nodes are referenced by handles. The handle of a node in the tree is its index, the handle of a new node
+ * is LY_ARRAY_COUNT(tree) + its index in ay_ynode_edits.nodes.
+ */
+struct ay_ynode_edit {
+    uint32_t anchor;            /**< Handle of the node to which the edit applies. */
+    uint32_t src;               /**< Handle of the new node or of the root of the copied subtree. */
+    enum ay_ynode_edit_op op;   /**< Kind of the edit. */
+};
+
+/**
+ * @brief Batch of structural edits of the ynode tree.
+ *
+ * Every ay_ynode_insert_*() or ay_ynode_move_subtree_*() call shifts the tail of the array and corrects all
+ * pointers in the tree, so a transformation which applies many such edits in a loop is quadratic. Instead, the edits
+ * can be recorded while the tree stays unchanged and then the new array is built in one pass
+ * by ay_ynode_edits_apply().
+ *
+ * The edits applied to a node also apply to all copies of this node that are created in the same batch. This is
+ * the same result as if the transformation processed nodes in the order of the array and the copies were processed
+ * later like any other node.
+ */
+struct ay_ynode_edits {
+    struct ay_ynode *tree;              /**< Edited tree. Its structure must not change until the edits are applied. */
+    struct ay_ynode *nodes;             /**< New nodes in LY_ARRAY. Memory is reserved in advance for all free space
+                                             in the tree, so pointers to the new nodes are stable. */
+    struct ay_ynode_edit *list;         /**< Recorded edits in LY_ARRAY in the order of recording. */
+    uint32_t id_first;                  /**< The ay_ynode.id of the first new node. */
+
+    /* Members used only during ay_ynode_edits_apply(). */
+    uint32_t *order;                    /**< Indexes to ay_ynode_edits.list sorted by anchor. */
+    uint32_t *offset;                   /**< For every handle, the first index to ay_ynode_edits.order. */
+    uint32_t *emitted_id;               /**< For every new node, the ay_ynode.id of its last emitted instance. */
+    const struct ay_ynode **copies;     /**< Stack of original subtrees which are just being copied. */
+    uint32_t copies_count;              /**< Number of items in ay_ynode_edits.copies. */
+    struct ay_ynode *out;               /**< Array of ynodes that is being built. */
+    uint32_t out_count;                 /**< Number of ynodes in ay_ynode_edits.out. */
+};
+
+/**
+ * @brief Item of the children sequence during ay_ynode_edits_apply().
+ */
+struct ay_ynode_edit_item {
+    uint32_t handle;            /**< Handle of the node. */
+    uint32_t copied;            /**< If the node is the root of the copied subtree, then the index of the copy edit
+                                     in ay_ynode_edits.list plus one. Otherwise 0. */
+    uint8_t wrapped;            /**< Number of parents which have already been inserted for the node. */
+};
+
+/**
+ * @brief Iterator over the children of some node during ay_ynode_edits_apply().
+ */
+struct ay_ynode_edit_iter {
+    uint32_t handle;                    /**< Handle of the parent. */
+    uint8_t segment;                    /**< 0 for AY_EDIT_CHILD, 1 for the children themselves,
+                                             2 for AY_EDIT_COPY_LAST_CHILD edits. */
+    uint32_t pos;                       /**< Position in the current segment. */
+    const struct ay_ynode *child;       /**< The next child from the tree in segment 1. */
+    struct ay_ynode_edit_item wrapped;  /**< If the parent is a new parent (wrapper), then this is its wrapped node. */
+    struct ay_ynode_edit_iter *rest;    /**< Iterator whose remaining nodes are also adopted by the wrapper. */
+};
+
+/**
+ * @brief Prepare the batch of edits for the @p tree.
+ *
+ * @param[in] tree Tree of ynodes. Its free space (see ay_ynode_root.arrsize) limits the number of new nodes.
+ * @param[out] ed Batch of edits to initialize. It must be released by ay_ynode_edits_free() even on failure.
+ * @return 0 on success.
+ */
+static int
+ay_ynode_edits_init(struct ay_ynode *tree, struct ay_ynode_edits *ed)
+{
+    uint64_t free_space;
+
+    memset(ed, 0, sizeof *ed);
+    ed->tree = tree;
+    ed->id_first = AY_YNODE_ROOT_IDCNT(tree);
+    free_space = AY_YNODE_ROOT_ARRSIZE(tree) - LY_ARRAY_COUNT(tree);
+    LY_ARRAY_CREATE_RET(NULL, ed->nodes, free_space, AYE_MEMORY);
+    /* Every new node and every copy take at least one free item. */
+    LY_ARRAY_CREATE_RET(NULL, ed->list, free_space, AYE_MEMORY);
+
+    return 0;
+}
+
+/**
+ * @brief Release memory of the batch of edits.
+ *
+ * @param[in] ed Batch of edits.
+ */
+static void
+ay_ynode_edits_free(struct ay_ynode_edits *ed)
+{
+    LY_ARRAY_FREE(ed->nodes);
+    LY_ARRAY_FREE(ed->list);
+    free(ed->order);
+    free(ed->offset);
+    free(ed->emitted_id);
+    free(ed->copies);
+    free(ed->out);
+    memset(ed, 0, sizeof *ed);
+}
+
+/**
+ * @brief Get handle of the node.
+ *
+ * @param[in] ed Batch of edits.
+ * @param[in] node Node from the tree or the new node returned by ay_ynode_edit_insert().
+ * @return Handle of the @p node.
+ */
+static uint32_t
+ay_ynode_edit_handle(const struct ay_ynode_edits *ed, const struct ay_ynode *node)
+{
+    if ((node >= ed->tree) && (node < ed->tree + LY_ARRAY_COUNT(ed->tree))) {
+        return AY_INDEX(ed->tree, node);
+    } else {
+        assert((node >= ed->nodes) && (node < ed->nodes + LY_ARRAY_COUNT(ed->nodes)));
+        return LY_ARRAY_COUNT(ed->tree) + AY_INDEX(ed->nodes, node);
+    }
+}
+
+/**
+ * @brief Record the edit.
+ *
+ * @param[in,out] ed Batch of edits.
+ * @param[in] op Kind of the edit.
+ * @param[in] anchor Handle of the node to which the edit applies.
+ * @param[in] src Handle of the new or copied node.
+ */
+static void
+ay_ynode_edit_add(struct ay_ynode_edits *ed, enum ay_ynode_edit_op op, uint32_t anchor, uint32_t src)
+{
+    struct ay_ynode_edit *edit;
+
+    edit = &ed->list[LY_ARRAY_COUNT(ed->list)];
+    LY_ARRAY_INCREMENT(ed->list);
+    edit->anchor = anchor;
+    edit->src = src;
+    edit->op = op;
+}
+
+/**
+ * @brief Record the insertion of a new node.
+ *
+ * @param[in,out] ed Batch of edits.
+ * @param[in] op Kind of the insertion: AY_EDIT_WRAPPER, AY_EDIT_PARENT_FOR_REST, AY_EDIT_CHILD or AY_EDIT_SIBLING.
+ * @param[in] anchor Node from the tree or some new node.
+ * @return The new node. Its data can be set, but the pointers to other nodes are not valid until
+ * the edits are applied. Its ay_ynode.id can be used in ay_ynode.ref of other new nodes.
+ */
+static struct ay_ynode *
+ay_ynode_edit_insert(struct ay_ynode_edits *ed, enum ay_ynode_edit_op op, const struct ay_ynode *anchor)
+{
+    struct ay_ynode *node;
+
+    assert((op == AY_EDIT_WRAPPER) || (op == AY_EDIT_PARENT_FOR_REST) || (op == AY_EDIT_CHILD) ||
+            (op == AY_EDIT_SIBLING));
+
+    node = &ed->nodes[LY_ARRAY_COUNT(ed->nodes)];
+    LY_ARRAY_INCREMENT(ed->nodes);
+    memset(node, 0, sizeof *node);
+    node->id = AY_YNODE_ROOT_IDCNT(ed->tree);
+    AY_YNODE_ROOT_IDCNT_INC(ed->tree);
+    ay_ynode_edit_add(ed, op, ay_ynode_edit_handle(ed, anchor), ay_ynode_edit_handle(ed, node));
+
+    return node;
+}
+
+/**
+ * @brief Record the copy of the subtree.
+ *
+ * @param[in,out] ed Batch of edits.
+ * @param[in] op Kind of the edit: AY_EDIT_COPY_SIBLING or AY_EDIT_COPY_LAST_CHILD.
+ * @param[in] anchor Node from the tree or some new node.
+ * @param[in] subtree Root of the subtree from the tree.
+ */
+static void
+ay_ynode_edit_subtree(struct ay_ynode_edits *ed, enum ay_ynode_edit_op op, const struct ay_ynode *anchor,
+        const struct ay_ynode *subtree)
+{
+    assert((op == AY_EDIT_COPY_SIBLING) || (op == AY_EDIT_COPY_LAST_CHILD));
+    assert((subtree > ed->tree) && (subtree < ed->tree + LY_ARRAY_COUNT(ed->tree)));
+
+    ay_ynode_edit_add(ed, op, ay_ynode_edit_handle(ed, anchor), AY_INDEX(ed->tree, subtree));
+}
+
+/**
+ * @brief Find the edit of kind @p op applied to the node.
+ *
+ * @param[in] ed Batch of edits.
+ * @param[in] handle Handle of the node.
+ * @param[in] op Kind of the edit.
+ * @param[in] since Only edits recorded at this index of ay_ynode_edits.list or later are searched.
+ * @return The edit or NULL.
+ */
+static const struct ay_ynode_edit *
+ay_ynode_edit_find(const struct ay_ynode_edits *ed, uint32_t handle, enum ay_ynode_edit_op op, uint32_t since)
+{
+    uint32_t i;
+
+    for (i = ed->offset[handle]; i < ed->offset[handle + 1]; i++) {
+        if ((ed->list[ed->order[i]].op == op) && (ed->order[i] >= since)) {
+            return &ed->list[ed->order[i]];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Correct ay_ynode.when_ref of a node emitted in the copied subtrees.
+ *
+ * The correction is the same as in the ay_ynode_copy_subtree_when_ref_correction(), but it is evaluated on the
+ * original subtrees. The copies are processed from the outermost. The reference which does not point into the subtree
+ * is set to its last node on purpose, so the result is the same as from the ay_ynode_copy_subtree_as_last_child().
+ *
+ * @param[in] ed Batch of edits.
+ * @param[in] orig Node from the tree or NULL for new node, which is located in all the copies being emitted.
+ * @param[in,out] node Emitted copy of @p orig.
+ */
+static void
+ay_ynode_edit_when_ref_correction(const struct ay_ynode_edits *ed, const struct ay_ynode *orig, struct ay_ynode *node)
+{
+    uint32_t i, j;
+    const struct ay_ynode *subtree, *target;
+
+    for (i = 0; i < ed->copies_count; i++) {
+        subtree = ed->copies[i];
+        if (orig && ((orig <= subtree) || (orig > subtree + subtree->descendants))) {
+            continue;
+        }
+        target = NULL;
+        for (j = 0; j <= subtree->descendants; j++) {
+            target = &subtree[j];
+            if ((node->when_ref == target->id) && (target->flags & AY_WHEN_TARGET)) {
+                break;
+            }
+        }
+        node->when_ref = target->id;
+    }
+}
+
+/**
+ * @brief Get the next item from the children sequence.
+ *
+ * @param[in] ed Batch of edits.
+ * @param[in,out] it Iterator over children.
+ * @param[out] item Next child.
+ * @return 1 if @p item is set, 0 if there are no more children.
+ */
+static ly_bool
+ay_ynode_edit_iter_next(const struct ay_ynode_edits *ed, struct ay_ynode_edit_iter *it,
+        struct ay_ynode_edit_item *item)
+{
+    const struct ay_ynode_edit *edit;
+    uint32_t first, last;
+
+    first = ed->offset[it->handle];
+    last = ed->offset[it->handle + 1];
+    memset(item, 0, sizeof *item);
+
+    /* New first children are in the reverse order of recording. */
+    for ( ; it->segment == 0; it->pos++) {
+        if (first + it->pos == last) {
+            it->segment = 1;
+            it->pos = 0;
+            break;
+        }
+        edit = &ed->list[ed->order[last - 1 - it->pos]];
+        if (edit->op == AY_EDIT_CHILD) {
+            item->handle = edit->src;
+            it->pos++;
+            return 1;
+        }
+    }
+
+    if (it->segment == 1) {
+        if (it->wrapped.wrapped) {
+            /* Children of the wrapper. */
+            if (it->pos++ == 0) {
+                *item = it->wrapped;
+                return 1;
+            } else if (it->rest && ay_ynode_edit_iter_next(ed, it->rest, item)) {
+                return 1;
+            }
+        } else {
+            /* Children from the tree. */
+            if (it->child) {
+                item->handle = AY_INDEX(ed->tree, it->child);
+                it->child = it->child->next;
+                return 1;
+            }
+        }
+        it->segment = 2;
+        it->pos = 0;
+    }
+
+    /* New last children are in the order of recording. */
+    for ( ; first + it->pos < last; it->pos++) {
+        edit = &ed->list[ed->order[first + it->pos]];
+        if (edit->op == AY_EDIT_COPY_LAST_CHILD) {
+            item->handle = edit->src;
+            item->copied = ed->order[first + it->pos] + 1;
+            it->pos++;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void ay_ynode_edit_emit_items(struct ay_ynode_edits *ed, struct ay_ynode_edit_iter *it);
+
+/**
+ * @brief Write node to the output array.
+ *
+ * @param[in,out] ed Batch of edits.
+ * @param[in] handle Handle of the node.
+ * @return Index of the node in the output array.
+ */
+static uint32_t
+ay_ynode_edit_emit_node(struct ay_ynode_edits *ed, uint32_t handle)
+{
+    uint32_t pos, tree_count, k;
+    struct ay_ynode *node;
+
+    tree_count = LY_ARRAY_COUNT(ed->tree);
+    pos = ed->out_count++;
+    assert(ed->out_count <= AY_YNODE_ROOT_ARRSIZE(ed->tree));
+    node = &ed->out[pos];
+
+    if (handle < tree_count) {
+        *node = ed->tree[handle];
+        if (node->when_ref && ed->copies_count) {
+            ay_ynode_edit_when_ref_correction(ed, &ed->tree[handle], node);
+        }
+    } else {
+        /* Every instance of the new node gets its own id. */
+        k = handle - tree_count;
+        *node = ed->nodes[k];
+        if (ed->emitted_id[k]) {
+            node->id = AY_YNODE_ROOT_IDCNT(ed->tree);
+            AY_YNODE_ROOT_IDCNT_INC(ed->tree);
+        }
+        ed->emitted_id[k] = node->id;
+        if (node->when_ref && ed->copies_count) {
+            ay_ynode_edit_when_ref_correction(ed, NULL, node);
+        }
+        /* A reference to another new node refers to its last emitted instance. */
+        if ((node->ref >= ed->id_first) && (node->ref < ed->id_first + LY_ARRAY_COUNT(ed->nodes)) &&
+                ed->emitted_id[node->ref - ed->id_first]) {
+            node->ref = ed->emitted_id[node->ref - ed->id_first];
+        }
+    }
+
+    return pos;
+}
+
+/**
+ * @brief Write the item, its subtree and the nodes inserted behind it to the output array.
+ *
+ * The root of the copied subtree is affected only by those new parents and nodes behind it that were recorded after
+ * the copy. The earlier ones are outside of the copied subtree. Other copies of the same subtree are also not
+ * inserted behind the copy.
+ *
+ * @param[in,out] ed Batch of edits.
+ * @param[in] item Item to emit.
+ * @param[in,out] it Iterator from which the @p item was taken. The new parent inserted by AY_EDIT_PARENT_FOR_REST
+ * adopts the remaining items.
+ */
+static void
+ay_ynode_edit_emit_item(struct ay_ynode_edits *ed, struct ay_ynode_edit_item item, struct ay_ynode_edit_iter *it)
+{
+    const struct ay_ynode_edit *edit;
+    struct ay_ynode_edit_iter sub = {0};
+    struct ay_ynode_edit_item next = {0};
+    uint32_t pos, first, i;
+
+    /* The new parent for the rest is outer than the new parent of the node. */
+    edit = NULL;
+    if (item.wrapped == 0) {
+        edit = ay_ynode_edit_find(ed, item.handle, AY_EDIT_PARENT_FOR_REST, item.copied);
+        item.wrapped = 1;
+    }
+    if (!edit && (item.wrapped == 1)) {
+        edit = ay_ynode_edit_find(ed, item.handle, AY_EDIT_WRAPPER, item.copied);
+        it = edit ? NULL : it;
+        item.wrapped = 2;
+    }
+    if (edit) {
+        pos = ay_ynode_edit_emit_node(ed, edit->src);
+        sub.handle = edit->src;
+        sub.wrapped = item;
+        sub.rest = it;
+        ay_ynode_edit_emit_items(ed, &sub);
+        ed->out[pos].descendants = ed->out_count - pos - 1;
+        item.handle = edit->src;
+        item.copied = 0;
+    } else {
+        if (item.copied) {
+            ed->copies[ed->copies_count++] = &ed->tree[item.handle];
+        }
+        pos = ay_ynode_edit_emit_node(ed, item.handle);
+        sub.handle = item.handle;
+        sub.child = item.handle < LY_ARRAY_COUNT(ed->tree) ? ed->tree[item.handle].child : NULL;
+        ay_ynode_edit_emit_items(ed, &sub);
+        ed->out[pos].descendants = ed->out_count - pos - 1;
+        if (item.copied) {
+            ed->copies_count--;
+        }
+    }
+
+    /* Nodes inserted behind are in the reverse order of recording. */
+    first = ed->offset[item.handle];
+    for (i = ed->offset[item.handle + 1]; i > first; i--) {
+        edit = &ed->list[ed->order[i - 1]];
+        if (((edit->op == AY_EDIT_SIBLING) || (edit->op == AY_EDIT_COPY_SIBLING)) &&
+                (ed->order[i - 1] >= item.copied) && (!item.copied || (edit->src != item.handle))) {
+            next.handle = edit->src;
+            next.copied = edit->op == AY_EDIT_COPY_SIBLING ? ed->order[i - 1] + 1 : 0;
+            ay_ynode_edit_emit_item(ed, next, NULL);
+        }
+    }
+}
+
+/**
+ * @brief Write all items from the iterator to the output array.
+ *
+ * @param[in,out] ed Batch of edits.
+ * @param[in,out] it Iterator over children.
+ */
+static void
+ay_ynode_edit_emit_items(struct ay_ynode_edits *ed, struct ay_ynode_edit_iter *it)
+{
+    struct ay_ynode_edit_item item;
+
+    while (ay_ynode_edit_iter_next(ed, it, &item)) {
+        ay_ynode_edit_emit_item(ed, item, it);
+    }
+}
+
+/**
+ * @brief Apply all recorded edits and build the new array of ynodes in one pass.
+ *
+ * All pointers to ynodes are invalidated.
+ *
+ * @param[in,out] ed Batch of edits.
+ * @return 0 on success.
+ */
+static int
+ay_ynode_edits_apply(struct ay_ynode_edits *ed)
+{
+    struct ay_ynode *tree;
+    struct ay_ynode_edit_item root = {0};
+    uint32_t handles, tree_count, i, sum, cnt;
+
+    tree = ed->tree;
+    tree_count = LY_ARRAY_COUNT(tree);
+    if (!LY_ARRAY_COUNT(ed->list)) {
+        return 0;
+    }
+
+    /* Sort edits by anchor, the order of recording is kept. */
+    handles = tree_count + LY_ARRAY_COUNT(ed->nodes);
+    ed->offset = calloc(handles + 1, sizeof *ed->offset);
+    ed->order = malloc(LY_ARRAY_COUNT(ed->list) * sizeof *ed->order);
+    ed->emitted_id = calloc(LY_ARRAY_COUNT(ed->nodes) + 1, sizeof *ed->emitted_id);
+    ed->copies = malloc(LY_ARRAY_COUNT(ed->list) * sizeof *ed->copies);
+    ed->out = malloc(AY_YNODE_ROOT_ARRSIZE(tree) * sizeof *ed->out);
+    if (!ed->offset || !ed->order || !ed->emitted_id || !ed->copies || !ed->out) {
+        return AYE_MEMORY;
+    }
+    LY_ARRAY_FOR(ed->list, i) {
+        ed->offset[ed->list[i].anchor + 1]++;
+    }
+    for (i = 0, sum = 0; i <= handles; i++) {
+        cnt = ed->offset[i];
+        ed->offset[i] = sum;
+        sum += cnt;
+    }
+    LY_ARRAY_FOR(ed->list, i) {
+        ed->order[ed->offset[ed->list[i].anchor + 1]++] = i;
+    }
+
+    /* Build the new array. */
+    ay_ynode_edit_emit_item(ed, root, NULL);
+    assert(!ed->copies_count);
+
+    /* The root keeps its data, only the number of descendants is changed. */
+    memcpy(tree + 1, ed->out + 1, (ed->out_count - 1) * sizeof *tree);
+    if (ed->out_count < tree_count) {
+        memset(tree + ed->out_count, 0, (tree_count - ed->out_count) * sizeof *tree);
+    }
+    AY_SET_LY_ARRAY_SIZE(tree, ed->out_count);
+    tree->descendants = ed->out_count - 1;
+    ay_ynode_tree_correction(tree);
+
+    return 0;
+}
+
 /**
  * @brief Unite (reset) choice for ynodes.
  *
@@ -3447,12 +3988,14 @@ ay_ynode_set_lv(struct ay_ynode *tree)
         value = tree[i].value;
         next = label;
         while ((next = ay_lnode_next_lv(next, AY_LV_TYPE_LABEL))) {
-            ret = ay_dnode_insert(AY_YNODE_ROOT_LABELS(tree), label, next, ay_dnode_lnode_equal);
+            ret = ay_dnode_insert(AY_YNODE_ROOT_LABELS(tree), AY_YNODE_ROOT_LABELS_INDEX(tree),
+                    label, next, ay_dnode_lnode_equal);
             AY_CHECK_RET(ret);
         }
         next = value;
         while ((next = ay_lnode_next_lv(next, AY_LV_TYPE_VALUE))) {
-            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), value, next, ay_dnode_lnode_equal);
+            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), AY_YNODE_ROOT_VALUES_INDEX(tree),
+                    value, next, ay_dnode_lnode_equal);
             AY_CHECK_RET(ret);
         }
     }
@@ -3670,7 +4213,8 @@ ay_ynode_set_choice_for_value(const struct ay_ynode *tree, struct ay_ynode *node
         }
         return;
     } else if (!node->next ||
-            (!(node->parent->flags & AY_VALUE_IN_CHOICE) && (!choice || ay_dnode_find(values, node->value)))) {
+            (!(node->parent->flags & AY_VALUE_IN_CHOICE) &&
+              (!choice || ay_dnode_find(values, AY_YNODE_ROOT_VALUES_INDEX(tree), node->value)))) {
         return;
     }
 
@@ -3943,18 +4487,22 @@ ay_ynode_insert_case(struct ay_ynode *tree)
  * Function uses ay_ynode.ref, which will be reset.
  *
  * @param[in,out] tree Tree of ynodes.
- * @return 0.
+ * @return 0 on success.
  */
 static int
 ay_ynode_copy_case_nodes(struct ay_ynode *tree)
 {
+    int ret;
     LY_ARRAY_COUNT_TYPE i;
+    struct ay_ynode_edits ed;
     struct ay_ynode *first, *iter, *cas_src, *cas_dst;
-    uint32_t cnt;
 
     assert(tree->ref);
     tree->ref = 0;
 
+    ret = ay_ynode_edits_init(tree, &ed);
+    AY_CHECK_GOTO(ret, cleanup);
+
     for (i = 1; i < LY_ARRAY_COUNT(tree); i++) {
         first = &tree[i];
         if (!first->ref) {
@@ -3962,28 +4510,28 @@ ay_ynode_copy_case_nodes(struct ay_ynode *tree)
         }
 
         /* Insert case. */
-        ay_ynode_insert_wrapper(tree, first);
-        cas_dst = first;
-        first = cas_dst->child;
+        cas_dst = ay_ynode_edit_insert(&ed, AY_EDIT_WRAPPER, first);
         cas_dst->type = YN_CASE;
         cas_dst->choice = first->choice;
         first->choice = NULL;
 
         /* Find nodes to copy. */
-        for (cas_src = cas_dst->next; cas_src && (cas_src->id != first->ref); cas_src = cas_src->next) {}
+        for (cas_src = first->next; cas_src && (cas_src->id != first->ref); cas_src = cas_src->next) {}
         assert(cas_src);
         first->ref = 0;
 
         /* Copy nodes. */
         assert(cas_src->child->next);
         for (iter = cas_src->child->next; iter; iter = iter->next) {
-            cnt = iter->descendants + 1;
-            ay_ynode_copy_subtree_as_last_child(tree, cas_dst, iter);
-            iter += cnt;
+            ay_ynode_edit_subtree(&ed, AY_EDIT_COPY_LAST_CHILD, cas_dst, iter);
         }
     }
 
-    return 0;
+    ret = ay_ynode_edits_apply(&ed);
+
+cleanup:
+    ay_ynode_edits_free(&ed);
+    return ret;
 }
 
 /**
@@ -4239,7 +4787,8 @@ ay_ynode_merge_cases_(struct ay_ynode *tree, struct ay_ynode *br1, struct ay_yno
     if (first1->child && !first2->child) {
         /* Merge values. */
         if (first1->value && first2->value && !ay_lnode_lense_equal(first1->value->lens, first2->value->lens)) {
-            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), first1->value, first2->value, ay_dnode_lnode_equal);
+            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), AY_YNODE_ROOT_VALUES_INDEX(tree),
+                    first1->value, first2->value, ay_dnode_lnode_equal);
             AY_CHECK_RET(ret);
             /* All children in first1 are not mandatory. */
             first1->flags |= AY_CHILDREN_MAND_FALSE;
@@ -4254,7 +4803,8 @@ ay_ynode_merge_cases_(struct ay_ynode *tree, struct ay_ynode *br1, struct ay_yno
     } else if (!first1->child && first2->child) {
         /* Merge values. */
         if (first1->value && first2->value && !ay_lnode_lense_equal(first1->value->lens, first2->value->lens)) {
-            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), first1->value, first2->value, ay_dnode_lnode_equal);
+            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), AY_YNODE_ROOT_VALUES_INDEX(tree),
+                    first1->value, first2->value, ay_dnode_lnode_equal);
             AY_CHECK_RET(ret);
             first1->flags |= AY_CHILDREN_MAND_FALSE;
         } else if (first1->value && !first2->value) {
@@ -4276,7 +4826,8 @@ ay_ynode_merge_cases_(struct ay_ynode *tree, struct ay_ynode *br1, struct ay_yno
 
         /* Merge values. */
         if (first1->value && first2->value && !ay_lnode_lense_equal(first1->value->lens, first2->value->lens)) {
-            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), first1->value, first2->value, ay_dnode_lnode_equal);
+            ret = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), AY_YNODE_ROOT_VALUES_INDEX(tree),
+                    first1->value, first2->value, ay_dnode_lnode_equal);
             AY_CHECK_RET(ret);
         } else if (first1->value && !first2->value) {
             first1->flags |= AY_VALUE_MAND_FALSE;
@@ -4385,7 +4936,8 @@ ay_ynode_merge_cases_only_by_value(struct ay_ynode *tree, struct ay_ynode *br1,
 
     if (first1->value && first2->value && !ay_lnode_lense_equal(first1->value->lens, first2->value->lens)) {
         /* values are different, update dictionary for values. */
-        *err = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), first1->value, first2->value, ay_dnode_lnode_equal);
+        *err = ay_dnode_insert(AY_YNODE_ROOT_VALUES(tree), AY_YNODE_ROOT_VALUES_INDEX(tree),
+                first1->value, first2->value, ay_dnode_lnode_equal);
     } else if (first1->value && !first2->value) {
         first1->flags |= AY_VALUE_MAND_FALSE;
     } else if (!first1->value && first2->value) {
@@ -4601,7 +5153,7 @@ ay_ynode_delete_useless_choice(struct ay_ynode *tree)
 
         /* Get all possible values for target. */
         values = AY_YNODE_ROOT_VALUES(tree);
-        key = ay_dnode_find(values, target->value);
+        key = ay_dnode_find(values, AY_YNODE_ROOT_VALUES_INDEX(tree), target->value);
         if (!key) {
             continue;
         }
@@ -4776,7 +5328,7 @@ ay_ynode_dependence_on_value(struct ay_ynode *tree)
             continue;
         }
 
-        key = ay_dnode_find(values, vnode->value);
+        key = ay_dnode_find(values, AY_YNODE_ROOT_VALUES_INDEX(tree), vnode->value);
         if (!key) {
             /* YN_VALUE node with no YANG union-stmt. */
             continue;
@@ -5407,25 +5959,142 @@ ay_ynode_create_groupings_recursive_form(struct ay_ynode *tree)
     return 0;
 }
 
+/**
+ * @brief Get ay_ynode_splitted_seq_index() of the node as if the grouping inserted for its parent already existed.
+ *
+ * @param[in] node Node to check.
+ * @param[in] parent_grouped Flag set if the inner nodes of the @p node parent are moved to the new grouping.
+ * The YN_KEY and YN_VALUE nodes remain outside of the grouping, so they are not counted.
+ * @return Sequence index of @p node.
+ */
+static uint64_t
+ay_ynode_node_split_seq_index(const struct ay_ynode *node, ly_bool parent_grouped)
+{
+    uint64_t node_idx;
+    const struct ay_ynode *iter, *inner_nodes;
+
+    node_idx = ay_ynode_splitted_seq_index(node);
+    if (!node_idx || !parent_grouped) {
+        return node_idx;
+    }
+
+    inner_nodes = ay_ynode_inner_nodes(node->parent);
+    for (iter = node->parent->child; iter != inner_nodes; iter = iter->next) {
+        if (AY_LABEL_LENS(iter) && (AY_LABEL_LENS(iter)->regexp == AY_LABEL_LENS(node)->regexp)) {
+            node_idx--;
+        }
+    }
+
+    return node_idx;
+}
+
+/**
+ * @brief Check if some 'when' in the subtree refers to the node outside of the subtree.
+ *
+ * The copies of such subtree have ay_ynode.when_ref corrected, see ay_ynode_copy_subtree_when_ref_correction().
+ *
+ * @param[in] subtree Root of the subtree. His own ay_ynode.when_ref is not checked.
+ * @return 1 if some descendant of @p subtree refers outside of the @p subtree.
+ */
+static ly_bool
+ay_ynode_subtree_when_ref_is_outside(const struct ay_ynode *subtree)
+{
+    uint32_t i, j;
+
+    for (i = 1; i <= subtree->descendants; i++) {
+        if (!subtree[i].when_ref) {
+            continue;
+        }
+        for (j = 0; j <= subtree->descendants; j++) {
+            if ((subtree[i].when_ref == subtree[j].id) && (subtree[j].flags & AY_WHEN_TARGET)) {
+                break;
+            }
+        }
+        if (j > subtree->descendants) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Insert a new node for the ay_ynode_node_split().
+ *
+ * @param[in,out] tree Tree of ynodes, modified only if @p ed is NULL.
+ * @param[in,out] ed Batch of edits to record the insertion or NULL to insert the node right away.
+ * @param[in] op Kind of the insertion: AY_EDIT_PARENT_FOR_REST, AY_EDIT_CHILD or AY_EDIT_SIBLING.
+ * @param[in] anchor Node to which the insertion applies.
+ * @return The new node.
+ */
+static struct ay_ynode *
+ay_ynode_node_split_insert(struct ay_ynode *tree, struct ay_ynode_edits *ed, enum ay_ynode_edit_op op,
+        struct ay_ynode *anchor)
+{
+    if (ed) {
+        return ay_ynode_edit_insert(ed, op, anchor);
+    }
+
+    switch (op) {
+    case AY_EDIT_PARENT_FOR_REST:
+        ay_ynode_insert_parent_for_rest(tree, anchor);
+        return anchor;
+    case AY_EDIT_CHILD:
+        ay_ynode_insert_child(tree, anchor);
+        return anchor->child;
+    default:
+        assert(op == AY_EDIT_SIBLING);
+        ay_ynode_insert_sibling(tree, anchor);
+        return anchor->next;
+    }
+}
+
 /**
  * @brief Split node if his pattern consists of identifiers in sequence.
  *
  * Example: [key "a" | "b"] -> list a {} list b {}
  *
+ * The modifications are recorded in the batch of edits and applied at once. But if the subtree to be copied has 'when'
+ * referring outside of it, the decisions of the following splits must be made on the corrected copies, which the batch
+ * cannot reproduce. Then the batch is dropped and the tree is modified right away, one modification at a time.
+ *
  * @param[in,out] tree Tree of ynodes.
- * @return 0.
+ * @return 0 on success.
  */
 static int
 ay_ynode_node_split(struct ay_ynode *tree)
 {
+    int ret;
     uint64_t idents_count, i, j, grouping_id;
-    struct ay_ynode *node, *node_new, *grouping, *inner_nodes, *key, *value;
-    ly_bool rec_form, valid_when;
+    struct ay_ynode_edits ed, *batch;
+    struct ay_ynode *node, *node_new, *grouping, *uses, *child, *inner_nodes, *key, *value, **grouped;
+    uint32_t grouped_count;
+    ly_bool rec_form, valid_when, parent_grouped;
+
+    grouped = NULL;
+    grouped_count = 0;
+    ret = ay_ynode_edits_init(tree, &ed);
+    AY_CHECK_GOTO(ret, cleanup);
+    batch = &ed;
+    /* Stack of nodes for which the grouping is inserted, used only with the batch. */
+    grouped = malloc(LY_ARRAY_COUNT(tree) * sizeof *grouped);
+    if (!grouped) {
+        ret = AYE_MEMORY;
+        goto cleanup;
+    }
 
     for (i = 1; i < LY_ARRAY_COUNT(tree); i++) {
         node = &tree[i];
 
-        if (!ay_ynode_rule_node_is_splittable(tree, node) || (ay_ynode_splitted_seq_index(node) != 0)) {
+        parent_grouped = 0;
+        if (batch) {
+            while (grouped_count && (node > grouped[grouped_count - 1] + grouped[grouped_count - 1]->descendants)) {
+                grouped_count--;
+            }
+            parent_grouped = grouped_count && (grouped[grouped_count - 1] == node->parent);
+        }
+        if (!ay_ynode_rule_node_is_splittable(tree, node) ||
+                (ay_ynode_node_split_seq_index(node, parent_grouped) != 0)) {
             continue;
         }
 
@@ -5443,21 +6112,31 @@ ay_ynode_node_split(struct ay_ynode *tree)
         inner_nodes = ay_ynode_inner_nodes(node);
         rec_form = ay_ynode_subtree_contains_type(node, YN_LEAFREF) ? 1 : 0;
         valid_when = ay_ynode_when_paths_are_valid(node, 0);
+        if (batch && (rec_form || !valid_when) && ay_ynode_subtree_when_ref_is_outside(node)) {
+            /* The copies will differ from the original. Nothing from the batch has been applied yet, only the ids
+             * are taken back, and the tree is processed again from the beginning without the batch. */
+            AY_YNODE_ROOT_IDCNT(tree) = ed.id_first;
+            batch = NULL;
+            i = 0;
+            continue;
+        }
         if (inner_nodes && (inner_nodes->type == YN_USES) && !inner_nodes->next) {
             grouping_id = inner_nodes->ref;
         } else if (inner_nodes && (inner_nodes->type == YN_GROUPING)) {
             grouping_id = inner_nodes->id;
         } else if (inner_nodes && !rec_form && valid_when) {
             /* Create grouping. */
-            ay_ynode_insert_parent_for_rest(tree, inner_nodes);
-            grouping = inner_nodes;
+            grouping = ay_ynode_node_split_insert(tree, batch, AY_EDIT_PARENT_FOR_REST, inner_nodes);
             grouping->type = YN_GROUPING;
-            grouping->snode = grouping->parent->snode;
+            grouping->snode = node->snode;
             grouping_id = grouping->id;
             /* Create YN_USES node. */
-            ay_ynode_insert_sibling(tree, grouping);
-            grouping->next->type = YN_USES;
-            grouping->next->ref = grouping_id;
+            uses = ay_ynode_node_split_insert(tree, batch, AY_EDIT_SIBLING, grouping);
+            uses->type = YN_USES;
+            uses->ref = grouping_id;
+            if (batch) {
+                grouped[grouped_count++] = node;
+            }
         }
 
         key = ay_ynode_parent_has_child(node, YN_KEY);
@@ -5466,31 +6145,41 @@ ay_ynode_node_split(struct ay_ynode *tree)
         /* Split node. */
         for (j = 0; j < (idents_count - 1); j++) {
             if (rec_form || !valid_when) {
-                ay_ynode_copy_subtree_as_sibling(tree, node, node);
+                if (batch) {
+                    ay_ynode_edit_subtree(batch, AY_EDIT_COPY_SIBLING, node, node);
+                } else {
+                    ay_ynode_copy_subtree_as_sibling(tree, node, node);
+                }
             } else {
                 /* insert new node */
-                ay_ynode_insert_sibling(tree, node);
-                node_new = node->next;
+                node_new = ay_ynode_node_split_insert(tree, batch, AY_EDIT_SIBLING, node);
                 ay_ynode_copy_data(node_new, node);
                 if (grouping_id) {
                     /* Insert YN_USES node. */
-                    ay_ynode_insert_child(tree, node_new);
-                    node_new->child->type = YN_USES;
-                    node_new->child->ref = grouping_id;
+                    child = ay_ynode_node_split_insert(tree, batch, AY_EDIT_CHILD, node_new);
+                    child->type = YN_USES;
+                    child->ref = grouping_id;
                 }
                 if (value) {
-                    ay_ynode_insert_child(tree, node_new);
-                    ay_ynode_copy_data(node_new->child, value);
+                    child = ay_ynode_node_split_insert(tree, batch, AY_EDIT_CHILD, node_new);
+                    ay_ynode_copy_data(child, value);
                 }
                 if (key) {
-                    ay_ynode_insert_child(tree, node_new);
-                    ay_ynode_copy_data(node_new->child, key);
+                    child = ay_ynode_node_split_insert(tree, batch, AY_EDIT_CHILD, node_new);
+                    ay_ynode_copy_data(child, key);
                 }
             }
         }
     }
 
-    return 0;
+    if (batch) {
+        ret = ay_ynode_edits_apply(batch);
+    }
+
+cleanup:
+    free(grouped);
+    ay_ynode_edits_free(&ed);
+    return ret;
 }
 
 /**
@@ -5833,6 +6522,7 @@ ay_ynode_groupings_ahead(struct ay_ynode *tree)
     struct ay_ynode *last, *gr, *us, *iter;
     uint32_t *sort = NULL;
     struct ay_dnode *dict = NULL, *key;
+    struct ay_pindex index = {0};
     uint64_t cnt, keys;
     ly_bool inserted, key_resolv, val_resolv;
 
@@ -5853,6 +6543,8 @@ ay_ynode_groupings_ahead(struct ay_ynode *tree)
 
     LY_ARRAY_CREATE_GOTO(NULL, dict, keys * 2 + cnt, ret, cleanup);
     LY_ARRAY_CREATE_GOTO(NULL, sort, keys, ret, cleanup);
+    ret = ay_pindex_init(&index, keys + cnt);
+    AY_CHECK_GOTO(ret, cleanup);
 
     /* Fill 'dict'. Key is YN_GROUPING and values are YN_USES. */
     for (i = 1; i < LY_ARRAY_COUNT(tree); i++) {
@@ -5864,7 +6556,7 @@ ay_ynode_groupings_ahead(struct ay_ynode *tree)
                 if (iter->type == YN_USES) {
                     /* Connect YN_USES to the 'gr'. */
                     inserted = 1;
-                    ret = ay_dnode_insert(dict, gr, iter, NULL);
+                    ret = ay_dnode_insert(dict, &index, gr, iter, NULL);
                     AY_CHECK_GOTO(ret, cleanup);
                 } else if (iter->type == YN_GROUPING) {
                     /* Skip inner YN_GROUPING. */
@@ -5873,7 +6565,7 @@ ay_ynode_groupings_ahead(struct ay_ynode *tree)
             }
             if (!inserted) {
                 /* Insert YN_GROUPING which does not have YN_USES nodes. */
-                ret = ay_dnode_insert(dict, gr, NULL, NULL);
+                ret = ay_dnode_insert(dict, &index, gr, NULL, NULL);
                 AY_CHECK_GOTO(ret, cleanup);
             }
         }
@@ -5941,6 +6633,7 @@ ay_ynode_groupings_ahead(struct ay_ynode *tree)
 cleanup:
     LY_ARRAY_FREE(dict);
     LY_ARRAY_FREE(sort);
+    ay_pindex_clean(&index);
 
     return ret;
 }
@@ -5952,14 +6645,20 @@ cleanup:
  * See ay_ynode_grouping_reduction().
  *
  * @param[in,out] tree Tree of ynodes. Only flags can be modified.
- * @return Number of nodes that must be inserted if grouping reduction is applied.
+ * @param[out] new_nodes Number of nodes that must be inserted if grouping reduction is applied.
+ * @return 0 on success.
  */
-static uint64_t
-ay_ynode_grouping_reduction_count(struct ay_ynode *tree)
+static int
+ay_ynode_grouping_reduction_count(struct ay_ynode *tree, uint64_t *new_nodes)
 {
+    int ret;
     LY_ARRAY_COUNT_TYPE i;
     struct ay_ynode *gr, *uses;
-    uint64_t new_nodes, dupl_count;
+    struct ay_ident_occur *table;
+    uint64_t dupl_count;
+
+    ret = ay_ident_table_create(tree, &table);
+    AY_CHECK_RET(ret);
 
     /* For each top-level grouping, set gr->ref and gr->flags. */
     for (gr = tree->child; gr->type == YN_GROUPING; gr = gr->next) {
@@ -5985,24 +6684,25 @@ ay_ynode_grouping_reduction_count(struct ay_ynode *tree)
                 continue;
             }
             /* Explore all siblings of this YN_USES. */
-            ay_yang_ident_duplications(tree, uses, gr->child->ident, NULL, &dupl_count);
+            ay_yang_ident_duplications(tree, table, uses, gr->child->ident, NULL, &dupl_count);
             if (dupl_count) {
                 /* Name collision found. Grouping must be reduced. */
                 gr->flags |= AY_GROUPING_REDUCTION;
             }
         }
     }
+    ay_ident_table_free(table);
 
     /* Calculate how many new nodes must be inserted into the tree due to the reductions in groupings. */
-    new_nodes = 0;
+    *new_nodes = 0;
     for (gr = tree->child; gr->type == YN_GROUPING; gr = gr->next) {
         if (gr->flags & AY_GROUPING_REDUCTION) {
-            new_nodes += gr->ref - 1;
+            *new_nodes += gr->ref - 1;
             gr->ref = 0;
         }
     }
 
-    return new_nodes;
+    return 0;
 }
 
 /**
@@ -6106,6 +6806,7 @@ ay_ynode_insert_container_in_choice(struct ay_ynode *tree)
     int ret = 0;
     LY_ARRAY_COUNT_TYPE i;
     struct ay_ynode *cas, *iter, *first;
+    struct ay_ident_occur *table = NULL;
     const struct ay_lnode *choice;
     uint64_t dupl_count;
     ly_bool insert_cont;
@@ -6117,11 +6818,17 @@ ay_ynode_insert_container_in_choice(struct ay_ynode *tree)
             continue;
         }
 
+        /* The table is created again only if the tree has been modified. */
+        if (!table) {
+            ret = ay_ident_table_create(tree, &table);
+            AY_CHECK_RET(ret);
+        }
+
         /* Check if some YN_CASE node has name collision. */
         insert_cont = 0;
         for (iter = cas->child; iter; iter = iter->next) {
-            ret = ay_yang_ident_duplications(tree, iter, iter->ident, NULL, &dupl_count);
-            AY_CHECK_RET(ret);
+            ret = ay_yang_ident_duplications(tree, table, iter, iter->ident, NULL, &dupl_count);
+            AY_CHECK_GOTO(ret, cleanup);
             if (dupl_count) {
                 /* Name collision. */
                 insert_cont = 1;
@@ -6133,6 +6840,8 @@ ay_ynode_insert_container_in_choice(struct ay_ynode *tree)
         }
 
         /* Let's insert containers for better readability. */
+        ay_ident_table_free(table);
+        table = NULL;
         first = ay_ynode_get_first_in_choice(cas->parent, cas->choice);
         choice = cas->choice;
         for (iter = first; iter && (iter->choice == choice); iter = iter->next) {
@@ -6153,6 +6862,9 @@ ay_ynode_insert_container_in_choice(struct ay_ynode *tree)
         }
     }
 
+cleanup:
+    ay_ident_table_free(table);
+
     return ret;
 }
 
@@ -6186,6 +6898,110 @@ ay_ynode_set_type(struct ay_ynode *tree)
     }
 }
 
+/**
+ * @brief Statistics of one ynode transformation, see AYO_TRANS_STATS.
+ */
+struct ay_trans_stat {
+    const char *name;           /**< Name of the transformation function. */
+    uint64_t usec;              /**< Wall time of the transformation in microseconds. */
+    uint64_t nodes;             /**< Number of ynodes in the tree after the transformation. */
+    uint64_t arrsize;           /**< Allocated size of the ynode array after the transformation. */
+};
+
+/**
+ * @brief Statistics collected during augyang_print_yang() if AYO_TRANS_STATS is set.
+ */
+struct ay_trans_stats {
+    struct timespec lap;        /**< Time of the last measurement. */
+    uint64_t lnodes;            /**< Number of lnodes. */
+    uint64_t ynodes;            /**< Number of ynodes before the transformations. */
+    uint64_t ltree_usec;        /**< Time to create the lnode tree. */
+    uint64_t ptree_usec;        /**< Time to create the pnode tree. */
+    uint64_t ytree_usec;        /**< Time to create the ynode tree. */
+    uint64_t trans_usec;        /**< Time of all the transformations. */
+    uint64_t print_usec;        /**< Time to print the YANG module. */
+    uint64_t yang_size;         /**< Length of the printed YANG module. */
+    struct ay_trans_stat *trans;    /**< Statistics of the transformations in LY_ARRAY. */
+};
+
+/**
+ * @brief Get the time since the last measurement and start a new one.
+ *
+ * @param[in,out] stats Statistics with the time of the last measurement. If NULL, nothing happens.
+ * @return Number of microseconds since the last measurement.
+ */
+static uint64_t
+ay_trans_stats_lap(struct ay_trans_stats *stats)
+{
+    struct timespec now;
+    int64_t usec;
+
+    if (!stats) {
+        return 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    usec = (int64_t)(now.tv_sec - stats->lap.tv_sec) * 1000000 + (now.tv_nsec - stats->lap.tv_nsec) / 1000;
+    stats->lap = now;
+
+    return usec > 0 ? usec : 0;
+}
+
+/**
+ * @brief Record statistics of the transformation which has just finished.
+ *
+ * @param[in,out] stats Statistics to which the record is added. If NULL, nothing happens.
+ * @param[in] name Name of the transformation.
+ * @param[in] tree Tree of ynodes after the transformation.
+ * @return 0 on success.
+ */
+static int
+ay_trans_stats_add(struct ay_trans_stats *stats, const char *name, const struct ay_ynode *tree)
+{
+    struct ay_trans_stat *stat;
+
+    if (!stats) {
+        return 0;
+    }
+
+    LY_ARRAY_NEW_RET(NULL, stats->trans, stat, AYE_MEMORY);
+    stat->name = name;
+    stat->usec = ay_trans_stats_lap(stats);
+    stat->nodes = LY_ARRAY_COUNT(tree);
+    stat->arrsize = AY_YNODE_ROOT_ARRSIZE(tree);
+
+    return 0;
+}
+
+/**
+ * @brief Print the statistics as one line in the JSON format to stderr.
+ *
+ * @param[in] mod Augeas module for which the statistics were collected.
+ * @param[in] stats Statistics to print.
+ */
+static void
+ay_trans_stats_print(const struct module *mod, const struct ay_trans_stats *stats)
+{
+    LY_ARRAY_COUNT_TYPE i;
+    uint64_t arrsize;
+
+    fprintf(stderr, "{\"module\":\"%s\",\"lnodes\":%" PRIu64 ",\"ynodes\":%" PRIu64 ",", mod->name,
+            stats->lnodes, stats->ynodes);
+    fprintf(stderr, "\"ltree_usec\":%" PRIu64 ",\"ptree_usec\":%" PRIu64 ",\"ytree_usec\":%" PRIu64 ",",
+            stats->ltree_usec, stats->ptree_usec, stats->ytree_usec);
+    fprintf(stderr, "\"trans_usec\":%" PRIu64 ",\"print_usec\":%" PRIu64 ",\"yang_size\":%" PRIu64 ",",
+            stats->trans_usec, stats->print_usec, stats->yang_size);
+    fprintf(stderr, "\"transformations\":[");
+    arrsize = stats->ynodes;
+    LY_ARRAY_FOR(stats->trans, i) {
+        fprintf(stderr, "%s{\"name\":\"%s\",\"usec\":%" PRIu64 ",\"nodes\":%" PRIu64 ",\"arrsize\":%" PRIu64
+                ",\"growth\":%" PRIu64 "}", i ? "," : "", stats->trans[i].name, stats->trans[i].usec,
+                stats->trans[i].nodes, stats->trans[i].arrsize, stats->trans[i].arrsize - arrsize);
+        arrsize = stats->trans[i].arrsize;
+    }
+    fprintf(stderr, "]}\n");
+}
+
 /**
  * @brief Wrapper for calling some insert function.
  *
@@ -6250,16 +7066,19 @@ ay_ynode_trans_ident_insert(struct yprinter_ctx *ctx, int (*insert)(struct ay_yn
  *
  * @param[in] mod Augeas module.
  * @param[in,out] tree Tree of ynodes.
+ * @param[in,out] stats Optional statistics of the transformations.
  * @return 0 on success.
  */
 static int
-ay_ynode_transformations_ident(struct module *mod, struct ay_ynode **tree)
+ay_ynode_transformations_ident(struct module *mod, struct ay_ynode **tree, struct ay_trans_stats *stats)
 {
     int ret;
-    struct yprinter_ctx ctx;
+    struct yprinter_ctx ctx = {0};
+    uint64_t new_nodes;
 
 #define TRANSF(FUNC, REQ_SPACE) \
-    AY_CHECK_RV(ay_ynode_trans_ident_insert(&ctx, FUNC, REQ_SPACE))
+    AY_CHECK_RV(ay_ynode_trans_ident_insert(&ctx, FUNC, REQ_SPACE)); \
+    AY_CHECK_RV(ay_trans_stats_add(stats, #FUNC, ctx.tree))
 
     ctx.aug = ay_get_augeas_ctx1(mod);
     ctx.mod = mod;
@@ -6268,10 +7087,12 @@ ay_ynode_transformations_ident(struct module *mod, struct ay_ynode **tree)
     ctx.tree = *tree;
     ret = ay_ynode_idents(&ctx, 0);
     AY_CHECK_RET(ret);
+    AY_CHECK_RV(ay_trans_stats_add(stats, "ay_ynode_idents", ctx.tree));
 
     TRANSF(ay_ynode_insert_container_in_choice, ay_ynode_summary(*tree, ay_ynode_rule_insert_container_in_choice));
 
-    TRANSF(ay_ynode_grouping_reduction, ay_ynode_grouping_reduction_count(ctx.tree));
+    AY_CHECK_RV(ay_ynode_grouping_reduction_count(ctx.tree, &new_nodes));
+    TRANSF(ay_ynode_grouping_reduction, new_nodes);
 
     ret = ay_ynode_idents(&ctx, 1);
     AY_CHECK_RET(ret);
@@ -6288,15 +7109,21 @@ ay_ynode_transformations_ident(struct module *mod, struct ay_ynode **tree)
  *
  * @param[in] mod Module containing lenses for printing.
  * @param[in,out] tree Tree of ynodes. The memory address of the tree will be changed.
+ * @param[in,out] stats Optional statistics of the transformations.
  * @return 0 on success.
  */
 static int
-ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
+ay_ynode_transformations(struct module *mod, struct ay_ynode **tree, struct ay_trans_stats *stats)
 {
     int ret = 0;
 
 #define TRANSF(FUNC, REQ_SPACE) \
-    AY_CHECK_RV(ay_ynode_trans_insert(tree, FUNC, REQ_SPACE))
+    AY_CHECK_RV(ay_ynode_trans_insert(tree, FUNC, REQ_SPACE)); \
+    AY_CHECK_RV(ay_trans_stats_add(stats, #FUNC, *tree))
+
+#define PASS(FUNC) \
+    FUNC(*tree); \
+    AY_CHECK_RV(ay_trans_stats_add(stats, #FUNC, *tree))
 
     assert((*tree)->type == YN_ROOT);
 
@@ -6304,24 +7131,24 @@ ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
     TRANSF(ay_ynode_insert_implicit_list, ay_ynode_rule_insert_implicit_list(*tree));
 
     /* set type */
-    ay_ynode_set_type(*tree);
+    PASS(ay_ynode_set_type);
 
-    ay_delete_type_unknown(*tree);
+    PASS(ay_delete_type_unknown);
 
     /* lns . (sep . lns)*   -> lns*
      * (sep . lns)* . lns   -> lns*
      */
-    ay_ynode_delete_build_list(*tree);
+    PASS(ay_ynode_delete_build_list);
 
     /* Reset choice for siblings. */
-    ay_ynode_unite_choice(*tree);
+    PASS(ay_ynode_unite_choice);
 
     /* [ (key lns1 | key lns2) lns3 ]    -> node { type union { pattern lns1; pattern lns2; }}
      * store to YN_ROOT.labels
      * [ key lns1 (store lns2 | store lns3)) ]    -> node { type union { pattern lns2; pattern lns3; }}
      * store to YN_ROOT.values
      */
-    ay_ynode_set_lv(*tree);
+    PASS(ay_ynode_set_lv);
 
     /* [ key lns1 | key lns2 ... ] -> [ key lns1 ] | [ key lns2 ] ... */
     TRANSF(ay_ynode_more_keys_for_node, ay_ynode_rule_more_keys_for_node(*tree));
@@ -6338,7 +7165,7 @@ ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
     TRANSF(ay_ynode_copy_case_nodes, ay_ynode_rule_copy_case_nodes(*tree));
 
     /* If some choice branch is repeated, it is useless and is deleted. */
-    ay_ynode_delete_equal_cases(*tree);
+    PASS(ay_ynode_delete_equal_cases);
 
     /* ... | [key lns1 . lns2] . lns3 | [key lns1 . lns2] . lns4 | ... ->
      * ... | [key lns1 . lns2] . (lns3 | lns4) | ... */
@@ -6348,7 +7175,7 @@ ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
     /* Choice is useless if it has all branches the same except for the different when-stmt,
      * which actually cover all possible values. Choice and when-stmt is deleted, one branch is left.
      */
-    ay_ynode_delete_useless_choice(*tree);
+    PASS(ay_ynode_delete_useless_choice);
 
     /* insert top-level list for storing configure file */
     TRANSF(ay_insert_list_files, 1);
@@ -6367,14 +7194,14 @@ ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
 
     /* [label str (store lns | store lns2 . [label str2])] -> [label str2] has 'when' reference to lns2 */
     /* ... */
-    ay_ynode_dependence_on_value(*tree);
+    PASS(ay_ynode_dependence_on_value);
 
-    ay_ynode_tree_set_mandatory(*tree);
+    PASS(ay_ynode_tree_set_mandatory);
 
     /* Decide if the 'or not(...)' should be added into when-stmt.
      * Set if the target node is not mandatory for the given 'when'.
      */
-    ay_ynode_when_ornot(*tree);
+    PASS(ay_ynode_when_ornot);
 
     /* Groupings algorithms. */
 
@@ -6382,11 +7209,11 @@ ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
     TRANSF(ay_ynode_recursive_form_by_copy, ay_ynode_rule_recursive_form_by_copy(*tree));
 
     /* Find groupings for recursive form. */
-    ay_ynode_set_ref_recursive_form(*tree);
+    PASS(ay_ynode_set_ref_recursive_form);
 
     /* Groupings are resolved in functions ay_ynode_set_ref() and ay_ynode_create_groupings_toplevel() */
     /* Link nodes that should be in grouping by number. */
-    ay_ynode_set_ref(*tree);
+    PASS(ay_ynode_set_ref);
 
     /* Create groupings and uses-stmt based on recursive form.  */
     TRANSF(ay_ynode_create_groupings_recursive_form, ay_ynode_rule_create_groupings_recursive_form(*tree));
@@ -6395,7 +7222,7 @@ ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
     TRANSF(ay_ynode_create_groupings_toplevel, ay_ynode_summary(*tree, ay_ynode_rule_create_groupings_toplevel));
 
     /* Delete YN_REC nodes. */
-    ay_ynode_delete_ynrec(*tree);
+    PASS(ay_ynode_delete_ynrec);
 
     /* [key "a" | "b"] -> list a {} list b {} */
     /* It is for generally nodes, not just a list nodes. */
@@ -6403,31 +7230,38 @@ ay_ynode_transformations(struct module *mod, struct ay_ynode **tree)
 
     /* No other groupings will not be added, so move groupings in front of config-file list. */
     AY_CHECK_RV(ay_ynode_groupings_ahead(*tree));
+    AY_CHECK_RV(ay_trans_stats_add(stats, "ay_ynode_groupings_ahead", *tree));
 
     /* Changes based on identifier */
 
-    ay_ynode_snode_unique_pnode(*tree);
+    PASS(ay_ynode_snode_unique_pnode);
 
     /* Transformations based on ynode identifier. */
-    AY_CHECK_RV(ay_ynode_transformations_ident(mod, tree));
+    AY_CHECK_RV(ay_ynode_transformations_ident(mod, tree, stats));
 
+#undef PASS
 #undef TRANSF
 
     return ret;
 }
 
 int
-augyang_print_yang(struct module *mod, uint64_t vercode, char **str)
+augyang_print_yang(struct module *mod, uint64_t vercode, uint64_t options, char **str)
 {
     int ret = 0;
     struct lens *lens;
     struct ay_lnode *ltree = NULL;
     struct ay_ynode *ytree = NULL;
     struct ay_pnode *ptree = NULL;
+    struct ay_trans_stats stats_data = {0}, *stats;
     uint64_t ltree_size = 0, yforest_size = 0, tpatt_size = 0;
+    LY_ARRAY_COUNT_TYPE i;
 
     AY_CHECK_COND(!mod, AYE_LENSE_NOT_FOUND);
 
+    stats = options & AYO_TRANS_STATS ? &stats_data : NULL;
+    ay_trans_stats_lap(stats);
+
     assert(sizeof(struct ay_ynode) == sizeof(struct ay_ynode_root));
 
     lens = ay_lense_get_root(mod);
@@ -6441,35 +7275,69 @@ augyang_print_yang(struct module *mod, uint64_t vercode, char **str)
     ay_lnode_create_tree(ltree, lens, ltree);
     ret = ay_lnode_tree_check(ltree, mod);
     AY_CHECK_GOTO(ret, cleanup);
+    if (stats) {
+        stats->ltree_usec = ay_trans_stats_lap(stats);
+        stats->lnodes = LY_ARRAY_COUNT(ltree);
+    }
     ay_test_lnode_tree(vercode, mod, ltree);
 
     /* Create pnode tree. */
+    ay_trans_stats_lap(stats);
     ret = ay_pnode_create(ay_get_augeas_ctx1(mod), lens->info->filename->str, ltree, &ptree);
     AY_CHECK_GOTO(ret, cleanup);
+    if (stats) {
+        stats->ptree_usec = ay_trans_stats_lap(stats);
+    }
     ay_pnode_print_verbose(vercode, ptree);
 
     /* Create ynode forest. */
+    ay_trans_stats_lap(stats);
     LY_ARRAY_CREATE_GOTO(NULL, ytree, yforest_size + 1, ret, cleanup);
     ay_ynode_create_tree(ltree, tpatt_size, ytree);
     AY_CHECK_GOTO(ret, cleanup);
     /* The ltree is now owned by ytree, so ytree is responsible for freeing memory of ltree. */
     ltree = NULL;
+    if (stats) {
+        stats->ytree_usec = ay_trans_stats_lap(stats);
+        stats->ynodes = LY_ARRAY_COUNT(ytree);
+    }
     /* Print ytree if debugged. */
     ret = ay_debug_ynode_tree(vercode, AYV_YTREE, ytree);
     AY_CHECK_GOTO(ret, cleanup);
 
     /* Apply transformations. */
-    ret = ay_ynode_transformations(mod, &ytree);
+    ay_trans_stats_lap(stats);
+    ret = ay_ynode_transformations(mod, &ytree, stats);
     AY_CHECK_GOTO(ret, cleanup);
+    if (stats) {
+        LY_ARRAY_FOR(stats->trans, i) {
+            stats->trans_usec += stats->trans[i].usec;
+        }
+        stats->trans_usec += ay_trans_stats_lap(stats);
+    }
     ret = ay_debug_ynode_tree(vercode, AYV_YTREE_AFTER_TRANS, ytree);
     AY_CHECK_GOTO(ret, cleanup);
 
-    ret = ay_print_yang(mod, ytree, vercode, str);
+    ay_trans_stats_lap(stats);
+    ret = ay_print_yang(mod, ytree, vercode, options, str);
+    AY_CHECK_GOTO(ret, cleanup);
+    if (stats) {
+        stats->print_usec = ay_trans_stats_lap(stats);
+        stats->yang_size = *str ? strlen(*str) : 0;
+        ay_trans_stats_print(mod, stats);
+    }
 
 cleanup:
+    LY_ARRAY_FREE(stats_data.trans);
     LY_ARRAY_FREE(ltree);
     ay_pnode_free(ptree);
     ay_ynode_tree_free(ytree);
 
     return ret;
 }
+
+int
+augyang_print_shared_types(struct augeas *aug, uint64_t options, char **str)
+{
+    return ay_print_yang_shared_types(aug, options, str);
+}
@@ -23,6 +23,13 @@
 #define AYV_YNODE_ID_IN_YANG    0x08
 #define AYV_PTREE               0x10
 
+/* option flags */
+#define AYO_REGEX_MIN           0x01    /**< Minimize regexes in the YANG patterns. */
+#define AYO_SHARED_TYPES        0x02    /**< Refer to the typedefs in augeas-types instead of printing patterns. */
+#define AYO_LABEL_LITERALS      0x04    /**< Print the list of labels if the label regex has a finite language. */
+#define AYO_TRANS_STATS         0x08    /**< Print time and ynode counts of every transformation as JSON to stderr. */
+#define AYO_AUTOLOAD            0x10    /**< Print the autoloaded lens and its filter for the DS plugin. */
+
 /* error codes */
 #define AYE_MEMORY 1
 #define AYE_LENSE_NOT_FOUND 2
@@ -62,10 +69,24 @@ int augyang_print_input_lenses(struct module *mod, char **str);
  *
  * @param[in] mod Augeas module.
  * @param[in] vercode Verbose code for various debug outputs. See AYV_* constants.
+ * @param[in] options Options of the generated YANG module. See AYO_* constants.
+ * @param[out] str Dynamically allocated output string containing printed yang module.
+ * @return 0 on success. The augyang_get_error_message() is used for the error message.
+ */
+int augyang_print_yang(struct module *mod, uint64_t vercode, uint64_t options, char **str);
+
+/**
+ * @brief Print YANG module augeas-types which contains typedefs shared by the generated YANG modules.
+ *
+ * The typedefs are created from regexes of the augeas modules Rx, Util, Sep, Quote and Build which must be loaded
+ * in the @p aug. The YANG modules printed by augyang_print_yang() with the AYO_SHARED_TYPES flag import this module.
+ *
+ * @param[in] aug Augeas context.
+ * @param[in] options Options for printing the regexes. See AYO_* constants.
  * @param[out] str Dynamically allocated output string containing printed yang module.
  * @return 0 on success. The augyang_get_error_message() is used for the error message.
  */
-int augyang_print_yang(struct module *mod, uint64_t vercode, char **str);
+int augyang_print_shared_types(struct augeas *aug, uint64_t options, char **str);
 
 /**
  * @brief Print error message.
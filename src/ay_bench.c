@@ -0,0 +1,466 @@
+/**
+ * @file ay_bench.c
+ * @author agent <agent@local>
+ * @brief Benchmark of the YANG generation by augyang.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ *
+ * Every augeas module is processed in a separate child process, so that the peak memory of the YANG generation can be
+ * measured by the wait4() for each module and a crash of augyang does not stop the benchmark. The augyang_print_yang()
+ * is called in-process, so the time does not include writing the YANG file or its validation by yanglint.
+ */
+
+#define _GNU_SOURCE
+
+#include "ayg_config.h"
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "augeas.h"
+#include "augyang.h"
+#include "ay_loadpath.h"
+#include "ay_tools.h"
+#include "errcode.h"
+#include "list.h"
+#include "syntax.h"
+
+/**
+ * @brief Name of the program.
+ */
+#define AYB_PROGNAME "ay_bench"
+
+/**
+ * @brief Default number of repetitions for every module.
+ */
+#define AYB_REPEAT 5
+
+/**
+ * @brief Default allowed regression against the baseline in percent.
+ */
+#define AYB_THRESHOLD 20
+
+/**
+ * @brief Result of strlen("/").
+ */
+#define AYB_SLASH_LEN 1
+
+/**
+ * @brief Result of strlen(".aug").
+ */
+#define AYB_SUFF_AUG_LEN 4
+
+/**
+ * @brief Time in microseconds under which the time regression is not reported, because it is just noise.
+ */
+#define AYB_MIN_USEC 1000
+
+/**
+ * @brief Memory in kilobytes under which the memory regression is not reported.
+ */
+#define AYB_MIN_KB 1024
+
+/**
+ * @brief Result of the benchmark for one augeas module.
+ */
+struct ayb_result {
+    char name[64];          /**< Name of the augeas module. */
+    uint64_t min_usec;      /**< The fastest repetition in microseconds. */
+    uint64_t avg_usec;      /**< Average time of the repetitions in microseconds. */
+    uint64_t peak_kb;       /**< Peak memory (maximum resident set size) of the child process in kilobytes. */
+    uint64_t yang_size;     /**< Length of the generated YANG module. */
+};
+
+/**
+ * @brief Parameters of the benchmark of one augeas module.
+ */
+struct ayb_params {
+    char *loadpath;         /**< Directories separated by PATH_SEP_CHAR. */
+    const char *filename;   /**< Path to the augeas module file. */
+    uint32_t repeat;        /**< Number of repetitions. */
+    int cold;               /**< Flag if every repetition compiles the module. */
+};
+
+/**
+ * @brief Print help.
+ */
+static void
+ayb_usage(void)
+{
+    const char *msg =
+            "Usage:\n"
+            "  " AYB_PROGNAME " [OPTIONS] MODULE...\n"
+            "\n"
+            "Measure the generation of YANG modules from the augeas modules (without the .aug suffix).\n"
+            "For every module the time, the peak memory and the length of the generated YANG module are printed.\n"
+            "\nOptions:\n\n"
+            "  -b, --baseline FILE  compare the results with FILE and fail if some module is slower or needs more\n"
+            "                       memory than the threshold allows\n"
+            "  -c, --cold           every repetition also creates the augeas context and compiles the module;\n"
+            "                       otherwise the module is compiled once and the generation is warmed up\n"
+            "  -e, --explicit       default value of the -I parameter is not used\n"
+            "  -I, --include DIR    Search DIR for augeas modules; can be given multiple times;\n"
+            "                       default value: " AUGEAS_LENSES_DIR "\n"
+            "  -r, --repeat NUM     number of repetitions for every module; default value: 5\n"
+            "  -t, --threshold PCT  allowed regression against the baseline in percent; default value: 20\n"
+            "  -w, --write FILE     write the results to FILE which can be used as baseline later\n"
+            "\nExample:\n"
+            AYB_PROGNAME " -r 10 -w baseline.txt passwd hosts\n"
+            AYB_PROGNAME " -r 10 -b baseline.txt passwd hosts\n";
+
+    fprintf(stderr, "%s", msg);
+}
+
+/**
+ * @brief Create augeas context and compile the module.
+ *
+ * @param[in] loadpath Directories separated by PATH_SEP_CHAR.
+ * @param[in] filename Path to the augeas module file.
+ * @param[out] aug Augeas context.
+ * @return Compiled module or NULL.
+ */
+static struct module *
+ayb_load_module(const char *loadpath, const char *filename, struct augeas **aug)
+{
+    struct module *mod = NULL, *mod_iter;
+
+    *aug = aug_init(NULL, loadpath, AUG_NO_MODL_AUTOLOAD | AUG_NO_LOAD);
+    if (!*aug) {
+        fprintf(stderr, "ERROR: aug_init memory exhausted\n");
+        return NULL;
+    }
+
+    if (__aug_load_module_file(*aug, filename) == -1) {
+        fprintf(stderr, "ERROR: %s\n", aug_error_message(*aug));
+        return NULL;
+    }
+
+    /* Get last compiled (current) module form augeas context. */
+    for (mod_iter = (*aug)->modules; mod_iter; mod_iter = mod_iter->next) {
+        mod = mod_iter;
+    }
+
+    return mod;
+}
+
+/**
+ * @brief Run the benchmark of one module. It is called in the child process.
+ *
+ * @param[in] arg Parameters of the benchmark, struct ayb_params.
+ * @param[out] result Measured time and length of the YANG module, struct ayb_result.
+ * @return 0 on success.
+ */
+static int
+ayb_bench_module(void *arg, void *result)
+{
+    int ret = 0, rv;
+    uint32_t i;
+    uint64_t start, usec, total = 0;
+    struct augeas *aug = NULL;
+    struct module *mod = NULL;
+    char *str = NULL;
+    const struct ayb_params *params = arg;
+    struct ayb_result *res = result;
+
+    res->min_usec = UINT64_MAX;
+    for (i = 0; i < params->repeat + !params->cold; i++) {
+        start = ayt_time_usec();
+        if (!mod) {
+            mod = ayb_load_module(params->loadpath, params->filename, &aug);
+            if (!mod) {
+                ret = 1;
+                goto cleanup;
+            }
+        }
+        if (!params->cold) {
+            /* The module is compiled only once. */
+            start = ayt_time_usec();
+        }
+
+        rv = augyang_print_yang(mod, 0, 0, &str);
+        if (rv) {
+            fprintf(stderr, "%s", augyang_get_error_message(rv));
+            ret = 1;
+            goto cleanup;
+        }
+        usec = ayt_time_usec() - start;
+
+        res->yang_size = strlen(str);
+        free(str);
+        str = NULL;
+        if (params->cold) {
+            aug_close(aug);
+            aug = NULL;
+            mod = NULL;
+        } else if (!i) {
+            /* Warm-up run is not measured. */
+            continue;
+        }
+
+        total += usec;
+        res->min_usec = usec < res->min_usec ? usec : res->min_usec;
+    }
+    res->avg_usec = total / params->repeat;
+
+cleanup:
+    free(str);
+    aug_close(aug);
+
+    return ret;
+}
+
+/**
+ * @brief Run the benchmark of one module in the child process.
+ *
+ * @param[in] loadpath Directories separated by PATH_SEP_CHAR.
+ * @param[in] name Name of the augeas module.
+ * @param[in] repeat Number of repetitions.
+ * @param[in] cold Flag if every repetition compiles the module.
+ * @param[out] res Result of the benchmark.
+ * @return 0 on success.
+ */
+static int
+ayb_bench_module_fork(char *loadpath, const char *name, uint32_t repeat, int cold, struct ayb_result *res)
+{
+    int ret;
+    struct ayb_params params = {loadpath, NULL, repeat, cold};
+    const char *dirpath;
+    char *filename;
+
+    memset(res, 0, sizeof *res);
+    snprintf(res->name, sizeof res->name, "%s", name);
+
+    /* "<dirpath>/<name>.aug" */
+    filename = malloc(ay_loadpath_maxpath(loadpath) + AYB_SLASH_LEN + strlen(name) + AYB_SUFF_AUG_LEN + 1);
+    if (!filename) {
+        fprintf(stderr, "ERROR: Allocation of memory failed\n");
+        return 1;
+    }
+    sprintf(filename, "%s.aug", name);
+    dirpath = ay_loadpath_find_module(loadpath, filename);
+    if (!dirpath) {
+        fprintf(stderr, "ERROR: file %s not found in any directory\n", filename);
+        free(filename);
+        return 1;
+    }
+    ay_loadpath_insert_dirpath(dirpath, filename);
+    params.filename = filename;
+
+    ret = ayt_run_fork(ayb_bench_module, &params, res, sizeof *res, &res->peak_kb);
+    if (ret) {
+        fprintf(stderr, "ERROR: benchmark of module %s failed\n", name);
+    }
+    free(filename);
+
+    return ret;
+}
+
+/**
+ * @brief Find the result of the module in the baseline file.
+ *
+ * @param[in] baseline Opened baseline file.
+ * @param[in] name Name of the module.
+ * @param[out] base Result from the baseline.
+ * @return 1 if found, otherwise 0.
+ */
+static int
+ayb_baseline_find(FILE *baseline, const char *name, struct ayb_result *base)
+{
+    char line[256];
+
+    rewind(baseline);
+    while (fgets(line, sizeof line, baseline)) {
+        if ((line[0] == '#') || (sscanf(line, "%63s %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64, base->name,
+                &base->min_usec, &base->avg_usec, &base->peak_kb, &base->yang_size) != 5)) {
+            continue;
+        }
+        if (!strcmp(base->name, name)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check whether the value exceeds the baseline value by more than the threshold.
+ *
+ * @param[in] value Measured value.
+ * @param[in] base Value from the baseline.
+ * @param[in] threshold Allowed regression in percent.
+ * @param[in] min Value under which the regression is ignored.
+ * @return 1 if the value regressed.
+ */
+static int
+ayb_regressed(uint64_t value, uint64_t base, uint32_t threshold, uint64_t min)
+{
+    return (value > min) && (value * 100 > base * (100 + threshold));
+}
+
+/**
+ * @brief Compare the result with the baseline and print the regressions.
+ *
+ * @param[in] baseline Opened baseline file.
+ * @param[in] res Result of the benchmark.
+ * @param[in] threshold Allowed regression in percent.
+ * @return 1 if the module regressed.
+ */
+static int
+ayb_baseline_check(FILE *baseline, const struct ayb_result *res, uint32_t threshold)
+{
+    int ret = 0;
+    struct ayb_result base;
+
+    if (!ayb_baseline_find(baseline, res->name, &base)) {
+        fprintf(stderr, "WARNING: module %s is not in the baseline\n", res->name);
+        return 0;
+    }
+
+    if (ayb_regressed(res->min_usec, base.min_usec, threshold, AYB_MIN_USEC)) {
+        fprintf(stderr, "REGRESSION: module %s time %" PRIu64 " us, baseline %" PRIu64 " us\n", res->name,
+                res->min_usec, base.min_usec);
+        ret = 1;
+    }
+    if (ayb_regressed(res->peak_kb, base.peak_kb, threshold, AYB_MIN_KB)) {
+        fprintf(stderr, "REGRESSION: module %s peak memory %" PRIu64 " kB, baseline %" PRIu64 " kB\n", res->name,
+                res->peak_kb, base.peak_kb);
+        ret = 1;
+    }
+    if (res->yang_size != base.yang_size) {
+        /* The YANG module is compared by the aytest tests, so it is just reported. */
+        fprintf(stderr, "NOTE: module %s YANG length %" PRIu64 ", baseline %" PRIu64 "\n", res->name, res->yang_size,
+                base.yang_size);
+    }
+
+    return ret;
+}
+
+int
+main(int argc, char **argv)
+{
+    int opt, ret = 0, cold = 0, explicit = 0, i;
+    uint32_t repeat = AYB_REPEAT, threshold = AYB_THRESHOLD;
+    char *loadpath = NULL;
+    uint64_t loadpathlen = 0;
+    const char *baseline_path = NULL, *write_path = NULL;
+    FILE *baseline = NULL, *out = NULL;
+    struct ayb_result res;
+    uint64_t total_usec = 0;
+
+    struct option options[] = {
+        {"baseline",  1, 0, 'b'},
+        {"cold",      0, 0, 'c'},
+        {"explicit",  0, 0, 'e'},
+        {"help",      0, 0, 'h'},
+        {"include",   1, 0, 'I'},
+        {"repeat",    1, 0, 'r'},
+        {"threshold", 1, 0, 't'},
+        {"write",     1, 0, 'w'},
+        {0, 0, 0, 0}
+    };
+    int idx;
+
+    while ((opt = getopt_long(argc, argv, "b:cehI:r:t:w:", options, &idx)) != -1) {
+        switch (opt) {
+        case 'b':
+            baseline_path = optarg;
+            break;
+        case 'c':
+            cold = 1;
+            break;
+        case 'e':
+            explicit = 1;
+            break;
+        case 'I':
+            ret |= ay_loadpath_add(&loadpath, &loadpathlen, optarg);
+            break;
+        case 'r':
+            ret |= ayt_get_number(optarg, &repeat);
+            break;
+        case 't':
+            ret |= ayt_get_number(optarg, &threshold);
+            break;
+        case 'w':
+            write_path = optarg;
+            break;
+        case 'h':
+        default:
+            ayb_usage();
+            goto cleanup;
+        }
+    }
+    if (ret) {
+        goto cleanup;
+    }
+
+    if ((optind >= argc) || !repeat) {
+        ayb_usage();
+        ret = 1;
+        goto cleanup;
+    }
+
+    if (!explicit && ay_loadpath_add(&loadpath, &loadpathlen, AUGEAS_LENSES_DIR)) {
+        ret = 1;
+        goto cleanup;
+    }
+
+    if (baseline_path && !(baseline = fopen(baseline_path, "r"))) {
+        fprintf(stderr, "ERROR: failed to open %s\n", baseline_path);
+        ret = 1;
+        goto cleanup;
+    }
+    if (write_path && !(out = fopen(write_path, "w"))) {
+        fprintf(stderr, "ERROR: failed to open %s\n", write_path);
+        ret = 1;
+        goto cleanup;
+    }
+
+    printf("# %s mode, %" PRIu32 " repetitions\n", cold ? "cold" : "warm", repeat);
+    printf("# module min_usec avg_usec peak_kb yang_size\n");
+    if (out) {
+        fprintf(out, "# module min_usec avg_usec peak_kb yang_size\n");
+    }
+    for (i = optind; i < argc; i++) {
+        if (ayb_bench_module_fork(loadpath, argv[i], repeat, cold, &res)) {
+            ret = 1;
+            continue;
+        }
+
+        printf("%s %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", res.name, res.min_usec, res.avg_usec,
+                res.peak_kb, res.yang_size);
+        if (out) {
+            fprintf(out, "%s %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", res.name, res.min_usec,
+                    res.avg_usec, res.peak_kb, res.yang_size);
+        }
+        total_usec += res.min_usec;
+
+        if (baseline && ayb_baseline_check(baseline, &res, threshold)) {
+            ret = 1;
+        }
+    }
+    printf("# total min_usec %" PRIu64 "\n", total_usec);
+
+cleanup:
+    if (baseline) {
+        fclose(baseline);
+    }
+    if (out) {
+        fclose(out);
+    }
+    free(loadpath);
+
+    return ret;
+}
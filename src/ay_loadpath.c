@@ -0,0 +1,174 @@
+/**
+ * @file ay_loadpath.c
+ * @author agent <agent@local>
+ * @brief Search directories of the augeas modules shared by the augyang executables.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ay_loadpath.h"
+#include "internal.h"
+
+/**
+ * @brief Result of strlen("/").
+ */
+#define AY_SLASH_LEN 1
+
+int
+ay_loadpath_add(char **loadpath, uint64_t *loadpathlen, char *item)
+{
+    int ret = 0;
+    uint64_t new_loadpathlen, itemlen;
+    char *new_loadpath;
+
+    if (!*loadpath) {
+        *loadpath = strdup(item);
+        *loadpathlen = strlen(item);
+        ret = *loadpath ? 0 : 1;
+    } else if (item) {
+        /* allocate enough memory space */
+        itemlen = strlen(item);
+        /* loadpathlen + 'null byte' + 'PATH_SEP_CHAR' + itemlen + 'null byte' */
+        new_loadpathlen = *loadpathlen + itemlen + 3;
+        new_loadpath = realloc(*loadpath, new_loadpathlen);
+        if (!new_loadpath) {
+            free(*loadpath);
+            *loadpath = NULL;
+            return 1;
+        }
+        *loadpath = new_loadpath;
+
+        /* copy item to loadpath */
+        (*loadpath)[*loadpathlen] = PATH_SEP_CHAR;
+        strcpy(*loadpath + *loadpathlen + 1, item);
+        *loadpathlen = new_loadpathlen;
+    }
+
+    return ret;
+}
+
+char *
+ay_loadpath_next(const char *loadpath_iter)
+{
+    char *next;
+
+    if (loadpath_iter && (next = strchr(loadpath_iter, PATH_SEP_CHAR))) {
+        return next + 1;
+    } else {
+        return NULL;
+    }
+}
+
+size_t
+ay_loadpath_pathlen(const char *loadpath_item)
+{
+    char *retval;
+
+    if (!loadpath_item) {
+        return 0;
+    } else if ((retval = strchr(loadpath_item, PATH_SEP_CHAR))) {
+        return retval - loadpath_item;
+    } else {
+        return strlen(loadpath_item);
+    }
+}
+
+size_t
+ay_loadpath_maxpath(char *loadpath)
+{
+    size_t ret = 0, len;
+    char *iter;
+
+    for (iter = loadpath; iter; iter = ay_loadpath_next(iter)) {
+        len = ay_loadpath_pathlen(iter);
+        ret = len > ret ? len : ret;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check if the path points to a file.
+ *
+ * @param[in] path Path to check.
+ * @return 1 if path points to existing file, otherwise 0.
+ */
+static bool
+ay_loadpath_file_exists(const char *path)
+{
+    FILE *file;
+
+    file = fopen(path, "r");
+    if (file) {
+        fclose(file);
+        return 1;
+    } else {
+        return 0;
+    }
+}
+
+void
+ay_loadpath_insert_dirpath(const char *dirpath, char *filename)
+{
+    uint64_t dirpathlen;
+
+    dirpathlen = ay_loadpath_pathlen(dirpath),
+    filename[dirpathlen + AY_SLASH_LEN + strlen(filename)] = '\0';
+    memmove(filename + dirpathlen + AY_SLASH_LEN, filename, strlen(filename));
+    memcpy(filename, dirpath, dirpathlen);
+    filename[dirpathlen] = '/';
+}
+
+/**
+ * @brief Remove directory path and leave only the file name.
+ *
+ * This function is opposite of ay_loadpath_insert_dirpath().
+ *
+ * @param[in] dirpath string to remove from @p filename.
+ * @param[in,out] filename Buffer which begins with the string @p dirpath.
+ * The output form will be "filename".
+ */
+static void
+ay_loadpath_remove_dirpath(const char *dirpath, char *filename)
+{
+    uint64_t new_end, dirpathlen;
+
+    dirpathlen = ay_loadpath_pathlen(dirpath),
+    assert(!strncmp(filename, dirpath, dirpathlen));
+    new_end = strlen(filename) - (dirpathlen + AY_SLASH_LEN);
+    memmove(filename, filename + dirpathlen + AY_SLASH_LEN, new_end);
+    filename[new_end] = '\0';
+}
+
+const char *
+ay_loadpath_find_module(char *loadpath, char *filename)
+{
+    bool succ = 0;
+    char *iter, *loadpath_item;
+
+    for (iter = loadpath; !succ && iter; iter = ay_loadpath_next(iter)) {
+        loadpath_item = iter;
+        ay_loadpath_insert_dirpath(iter,  filename);
+        succ = ay_loadpath_file_exists(filename);
+        ay_loadpath_remove_dirpath(iter, filename);
+    }
+
+    return succ ? loadpath_item : NULL;
+}
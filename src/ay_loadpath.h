@@ -0,0 +1,70 @@
+/**
+ * @file ay_loadpath.h
+ * @author agent <agent@local>
+ * @brief Search directories of the augeas modules shared by the augyang executables.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Add path (string item) to the loadpath variable.
+ *
+ * @param[in,out] loadpath Storage of paths (strings) separated by PATH_SEP_CHAR.
+ * @param[in,out] loadpathlen Length of whole loadpath string, excluding the terminating null byte.
+ * @param[in] item Path that will be added to @p loadpath.
+ * @return 0 if operation success.
+ */
+int ay_loadpath_add(char **loadpath, uint64_t *loadpathlen, char *item);
+
+/**
+ * @brief Get next path from the loadpath variable.
+ *
+ * @param[in] loadpath_iter Pointer to some item (path/string) in the loadpath.
+ * @return Next item or NULL.
+ */
+char *ay_loadpath_next(const char *loadpath_iter);
+
+/**
+ * @brief Get length of @p loadpath_item (path/string).
+ *
+ * @param[in] loadpath_item Pointer to some item (path/string) in the loadpath.
+ * @return Length of item.
+ */
+size_t ay_loadpath_pathlen(const char *loadpath_item);
+
+/**
+ * @brief Find the size of the longest path (string) in the loadpath
+ *
+ * @param[in] loadpath Array of strings.
+ * @return The number of characters in the longest string.
+ */
+size_t ay_loadpath_maxpath(char *loadpath);
+
+/**
+ * @brief Insert directory path to the file name.
+ *
+ * @param[in] dirpath String to insert.
+ * @param[in,out] filename Sufficiently large buffer already containing file name.
+ * The output form will be "dirpath<slash>filename".
+ */
+void ay_loadpath_insert_dirpath(const char *dirpath, char *filename);
+
+/**
+ * @brief Find out in which directory path the module @p filename is located.
+ *
+ * @param[in] loadpath Array of paths separated by PATH_SEP_CHAR.
+ * @param[in] filename Buffer containing file name. It is not modified.
+ * @return Directory path from @p loadpath.
+ */
+const char *ay_loadpath_find_module(char *loadpath, char *filename);
@@ -0,0 +1,105 @@
+/**
+ * @file ay_tools.c
+ * @author agent <agent@local>
+ * @brief Helpers shared by the benchmark executables.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ay_tools.h"
+
+uint64_t
+ayt_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int
+ayt_get_number(const char *arg, uint32_t *num)
+{
+    char *endptr;
+    unsigned long val;
+
+    errno = 0;
+    val = strtoul(arg, &endptr, 10);
+    if (errno || (arg[0] == '-') || !arg[0] || *endptr || (val > UINT32_MAX)) {
+        fprintf(stderr, "ERROR: invalid number %s\n", arg);
+        return 1;
+    }
+    *num = val;
+
+    return 0;
+}
+
+int
+ayt_run_fork(ayt_run_cb run, void *arg, void *res, size_t res_size, uint64_t *peak_kb)
+{
+    int fd[2], status;
+    pid_t pid;
+    struct rusage usage;
+    ssize_t len;
+
+    if (pipe(fd) == -1) {
+        fprintf(stderr, "ERROR: pipe failed (%s)\n", strerror(errno));
+        return 1;
+    }
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == -1) {
+        fprintf(stderr, "ERROR: fork failed (%s)\n", strerror(errno));
+        close(fd[0]);
+        close(fd[1]);
+        return 1;
+    } else if (!pid) {
+        /* child */
+        close(fd[0]);
+        status = run(arg, res);
+        if (!status && (write(fd[1], res, res_size) != (ssize_t)res_size)) {
+            status = 1;
+        }
+        close(fd[1]);
+        _exit(status);
+    }
+
+    /* parent */
+    close(fd[1]);
+    len = read(fd[0], res, res_size);
+    close(fd[0]);
+    if (wait4(pid, &status, 0, &usage) == -1) {
+        fprintf(stderr, "ERROR: wait4 failed (%s)\n", strerror(errno));
+        return 1;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) || (len != (ssize_t)res_size)) {
+        return 1;
+    }
+    *peak_kb = usage.ru_maxrss;
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file ay_tools.h
+ * @author agent <agent@local>
+ * @brief Helpers shared by the benchmark executables.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Measurement run in the child process by ayt_run_fork().
+ *
+ * @param[in] arg Argument of the measurement.
+ * @param[out] res Result to pass to the parent process.
+ * @return 0 on success.
+ */
+typedef int (*ayt_run_cb)(void *arg, void *res);
+
+/**
+ * @brief Get monotonic time in microseconds.
+ *
+ * @return Current time.
+ */
+uint64_t ayt_time_usec(void);
+
+/**
+ * @brief Convert the numeric option.
+ *
+ * @param[in] arg String from command line.
+ * @param[out] num Converted number.
+ * @return 0 on success.
+ */
+int ayt_get_number(const char *arg, uint32_t *num);
+
+/**
+ * @brief Run a measurement in a child process.
+ *
+ * The peak memory of the measurement is obtained by the wait4() and a crash of the child process does not stop
+ * the caller.
+ *
+ * @param[in] run Measurement to run.
+ * @param[in] arg Argument of @p run.
+ * @param[in,out] res Result of @p run, it is passed back by a pipe.
+ * @param[in] res_size Size of @p res.
+ * @param[out] peak_kb Peak memory (maximum resident set size) of the child process in kilobytes.
+ * @return 0 on success.
+ */
+int ayt_run_fork(ayt_run_cb run, void *arg, void *res, size_t res_size, uint64_t *peak_kb);
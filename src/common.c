@@ -17,6 +17,8 @@
 #define _GNU_SOURCE
 
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <libyang/libyang.h>
 
@@ -274,31 +276,228 @@ ay_yang_type_is_empty(const struct ay_lnode *lnode)
     return 0;
 }
 
+/**
+ * @brief Get slot index for @p key in the hash table.
+ *
+ * @param[in] index Hash index with non-zero size.
+ * @param[in] key Pointer to hash.
+ * @return Slot index where the probing starts.
+ */
+static uint32_t
+ay_pindex_hash(const struct ay_pindex *index, const void *key)
+{
+    uint64_t hash;
+
+    hash = (uint64_t)(uintptr_t)key;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+
+    return (uint32_t)hash & (index->size - 1);
+}
+
+/**
+ * @brief Find slot which contains @p key or the empty slot where @p key belongs.
+ *
+ * @param[in] index Hash index with non-zero size.
+ * @param[in] key Pointer to find.
+ * @return Slot with @p key or an empty slot.
+ */
+static struct ay_pindex_slot *
+ay_pindex_slot(const struct ay_pindex *index, const void *key)
+{
+    uint32_t i;
+
+    for (i = ay_pindex_hash(index, key); index->slots[i].key && (index->slots[i].key != key);
+            i = (i + 1) & (index->size - 1)) {}
+
+    return &index->slots[i];
+}
+
+/**
+ * @brief Double the number of slots in the hash index.
+ *
+ * @param[in,out] index Index to enlarge.
+ * @return 0 on success.
+ */
+static int
+ay_pindex_grow(struct ay_pindex *index)
+{
+    struct ay_pindex_slot *old;
+    uint32_t i, old_size;
+
+    old = index->slots;
+    old_size = index->size;
+    index->size = old_size ? old_size * 2 : 8;
+    index->slots = calloc(index->size, sizeof *index->slots);
+    if (!index->slots) {
+        index->slots = old;
+        index->size = old_size;
+        return AYE_MEMORY;
+    }
+
+    for (i = 0; i < old_size; i++) {
+        if (old[i].key) {
+            *ay_pindex_slot(index, old[i].key) = old[i];
+        }
+    }
+    free(old);
+
+    return 0;
+}
+
 int
-ay_dnode_insert(struct ay_dnode *dict, const void *key, const void *value, int (*equal)(const void *, const void *))
+ay_pindex_init(struct ay_pindex *index, uint32_t capacity)
+{
+    memset(index, 0, sizeof *index);
+    for (index->size = 8; index->size < (capacity * 2); index->size *= 2) {}
+
+    index->slots = calloc(index->size, sizeof *index->slots);
+    if (!index->slots) {
+        index->size = 0;
+        return AYE_MEMORY;
+    }
+
+    return 0;
+}
+
+void
+ay_pindex_clean(struct ay_pindex *index)
+{
+    if (!index) {
+        return;
+    }
+
+    free(index->slots);
+    memset(index, 0, sizeof *index);
+}
+
+int
+ay_pindex_set(struct ay_pindex *index, const void *key, uint32_t pos)
+{
+    int ret;
+    struct ay_pindex_slot *slot;
+
+    if (!key) {
+        return 0;
+    }
+
+    if ((index->count + 1) * 2 > index->size) {
+        ret = ay_pindex_grow(index);
+        AY_CHECK_RET(ret);
+    }
+
+    slot = ay_pindex_slot(index, key);
+    if (!slot->key) {
+        slot->key = key;
+        index->count++;
+    }
+    slot->pos = pos;
+
+    return 0;
+}
+
+ly_bool
+ay_pindex_get(const struct ay_pindex *index, const void *key, uint32_t *pos)
+{
+    struct ay_pindex_slot *slot;
+
+    if (!key || !index->count) {
+        return 0;
+    }
+
+    slot = ay_pindex_slot(index, key);
+    if (!slot->key) {
+        return 0;
+    }
+    *pos = slot->pos;
+
+    return 1;
+}
+
+/**
+ * @brief Add dnode position to the @p index.
+ *
+ * The VALUE may occur in the dictionary more than once, in which case the index refers to its first occurrence.
+ *
+ * @param[in,out] index Hash index of the dictionary. Can be NULL.
+ * @param[in] kvd The Key or Value Data of the dnode.
+ * @param[in] pos Position of the dnode in the dictionary.
+ * @return 0 on success.
+ */
+static int
+ay_dnode_index_add(struct ay_pindex *index, const void *kvd, uint32_t pos)
+{
+    uint32_t first;
+
+    if (!index || (ay_pindex_get(index, kvd, &first) && (first < pos))) {
+        return 0;
+    }
+
+    return ay_pindex_set(index, kvd, pos);
+}
+
+/**
+ * @brief Shift positions in @p index for the dnodes which will be moved one item to the right.
+ *
+ * Must be called before the dnodes are moved.
+ *
+ * @param[in] dict Dictionary.
+ * @param[in,out] index Hash index of @p dict. Can be NULL.
+ * @param[in] start Position of the first dnode which will be moved.
+ * @return 0 on success.
+ */
+static int
+ay_dnode_index_shift(struct ay_dnode *dict, struct ay_pindex *index, LY_ARRAY_COUNT_TYPE start)
+{
+    int ret;
+    LY_ARRAY_COUNT_TYPE i;
+    uint32_t pos;
+
+    if (!index) {
+        return 0;
+    }
+
+    /* Going backwards, so the shifted position of the first occurrence cannot be mistaken for a later one. */
+    for (i = LY_ARRAY_COUNT(dict); i > start; i--) {
+        if (ay_pindex_get(index, dict[i - 1].kvd, &pos) && (pos == (i - 1))) {
+            ret = ay_pindex_set(index, dict[i - 1].kvd, i);
+            AY_CHECK_RET(ret);
+        }
+    }
+
+    return 0;
+}
+
+int
+ay_dnode_insert(struct ay_dnode *dict, struct ay_pindex *index, const void *key, const void *value,
+        int (*equal)(const void *, const void *))
 {
     int ret = 0;
     struct ay_dnode *dkey, *dval, *gap;
 
-    dkey = ay_dnode_find(dict, key);
-    dval = ay_dnode_find(dict, value);
+    dkey = ay_dnode_find(dict, index, key);
+    dval = value ? ay_dnode_find(dict, index, value) : NULL;
     if ((dkey && (AY_DNODE_IS_VAL(dkey) || !ay_dnode_value_is_unique(dkey, value, equal))) ||
             (equal && !dkey && !dval && equal(key, value))) {
         return ret;
     } else if (dval && AY_DNODE_IS_KEY(dval)) {
         /* The dval will no longer be dictionary key. It will be value of dkey. */
-        ret = ay_dnode_merge_keys(dict, dkey, dval);
+        ret = ay_dnode_merge_keys(dict, index, dkey, dval);
         return ret;
     }
 
     if (dkey) {
         /* insert value */
         gap = dkey + dkey->values_count + 1;
-        memmove(gap + 1, gap, LY_ARRAY_COUNT(dict) - (gap - dict));
+        ret = ay_dnode_index_shift(dict, index, gap - dict);
+        AY_CHECK_RET(ret);
+        memmove(gap + 1, gap, (LY_ARRAY_COUNT(dict) - (gap - dict)) * sizeof *dict);
         gap->kvd = value;
         gap->values_count = 0;
         dkey->values_count++;
         LY_ARRAY_INCREMENT(dict);
+        ret = ay_dnode_index_add(index, value, gap - dict);
     } else if (!dkey) {
         /* insert new pair */
         dkey = dict + LY_ARRAY_COUNT(dict);
@@ -308,15 +507,23 @@ ay_dnode_insert(struct ay_dnode *dict, const void *key, const void *value, int (
         dkey[1].values_count = 0;
         LY_ARRAY_INCREMENT(dict);
         LY_ARRAY_INCREMENT(dict);
+        ret = ay_dnode_index_add(index, key, dkey - dict);
+        AY_CHECK_RET(ret);
+        ret = ay_dnode_index_add(index, value, dkey - dict + 1);
     }
 
     return ret;
 }
 
 struct ay_dnode *
-ay_dnode_find(struct ay_dnode *dict, const void *kvd)
+ay_dnode_find(struct ay_dnode *dict, const struct ay_pindex *index, const void *kvd)
 {
     LY_ARRAY_COUNT_TYPE i;
+    uint32_t pos;
+
+    if (index && kvd) {
+        return ay_pindex_get(index, kvd, &pos) ? &dict[pos] : NULL;
+    }
 
     LY_ARRAY_FOR(dict, i) {
         if (dict[i].kvd == kvd) {
@@ -328,8 +535,9 @@ ay_dnode_find(struct ay_dnode *dict, const void *kvd)
 }
 
 int
-ay_dnode_merge_keys(struct ay_dnode *dict, struct ay_dnode *key1, struct ay_dnode *key2)
+ay_dnode_merge_keys(struct ay_dnode *dict, struct ay_pindex *index, struct ay_dnode *key1, struct ay_dnode *key2)
 {
+    int ret;
     LY_ARRAY_COUNT_TYPE i, j, k;
     struct ay_dnode *buff = NULL;
 
@@ -376,6 +584,19 @@ ay_dnode_merge_keys(struct ay_dnode *dict, struct ay_dnode *key1, struct ay_dnod
     }
 
     LY_ARRAY_FREE(buff);
+
+    if (!index) {
+        return 0;
+    }
+
+    /* All positions may have changed. */
+    memset(index->slots, 0, index->size * sizeof *index->slots);
+    index->count = 0;
+    LY_ARRAY_FOR(dict, i) {
+        ret = ay_dnode_index_add(index, dict[i].kvd, i);
+        AY_CHECK_RET(ret);
+    }
+
     return 0;
 }
 
@@ -398,19 +619,22 @@ ay_dnode_value_is_unique(struct ay_dnode *key, const void *value,  int (*equal)(
 }
 
 struct ay_transl *
-ay_transl_find(struct ay_transl *table, const char *origin)
+ay_transl_find(struct ay_transl *table, const struct ay_pindex *index, const char *origin)
 {
     LY_ARRAY_COUNT_TYPE i;
-    struct ay_transl *ret;
+    uint32_t pos;
+
+    if (index && origin) {
+        return ay_pindex_get(index, origin, &pos) ? &table[pos] : NULL;
+    }
 
-    ret = NULL;
     LY_ARRAY_FOR(table, i) {
         if (table[i].origin == origin) {
             return &table[i];
         }
     }
 
-    return ret;
+    return NULL;
 }
 
 struct ay_ynode *
@@ -366,7 +366,7 @@ struct ay_ynode_root {
                                          in union-stmt. The key in the dictionary is the first label in the
                                          union and values in the dictionary are the remaining labels. */
     struct ay_dnode *values;        /**< Dictionary for values of type lnode. See ynode.labels. */
-    char *choice;                   /**< Not used. */
+    struct ay_ynode_root_index *index;  /**< Hash indexes for the labels, values and patt_table. */
     struct ay_transl *patt_table;   /**< The ay_transl data in LY_ARRAY. Contains a link to lens.regexp.pattern.str
                                          in the form '(pref1|pref2)name1|name2|name3(suf1|suf2)|...' and its parsed
                                          names (pref1name1, pref2name1, name2, name3suf1, name3suf2, ...). */
@@ -386,6 +386,30 @@ struct ay_ynode_root {
 #define AY_YNODE_ROOT_ARRSIZE(TREE) \
     ((struct ay_ynode_root *)(TREE))->arrsize
 
+/**
+ * @brief Get hash index of ay_ynode_root.labels from ynode tree.
+ *
+ * @param[in] TREE Tree of ynodes. First item in the tree must be YN_ROOT.
+ */
+#define AY_YNODE_ROOT_LABELS_INDEX(TREE) \
+    (&((struct ay_ynode_root *)(TREE))->index->labels)
+
+/**
+ * @brief Get hash index of ay_ynode_root.values from ynode tree.
+ *
+ * @param[in] TREE Tree of ynodes. First item in the tree must be YN_ROOT.
+ */
+#define AY_YNODE_ROOT_VALUES_INDEX(TREE) \
+    (&((struct ay_ynode_root *)(TREE))->index->values)
+
+/**
+ * @brief Get hash index of ay_ynode_root.patt_table from ynode tree.
+ *
+ * @param[in] TREE Tree of ynodes. First item in the tree must be YN_ROOT.
+ */
+#define AY_YNODE_ROOT_PATT_INDEX(TREE) \
+    (&((struct ay_ynode_root *)(TREE))->index->patt_table)
+
 /**
  * @brief Get ay_ynode_root.ltree from ynode tree.
  *
@@ -509,6 +533,54 @@ struct ay_transl {
                                  is not yet complete, use ay_ynode_get_ident_from_transl_table(). */
 };
 
+/**
+ * @brief Slot in the pointer-keyed hash index.
+ */
+struct ay_pindex_slot {
+    const void *key;    /**< Indexed pointer. The NULL marks an empty slot. */
+    uint32_t pos;       /**< Position of the item with @p key in the indexed Sized array. */
+};
+
+/**
+ * @brief Pointer-keyed hash index of a Sized array.
+ *
+ * The index maps a pointer stored in an item (ay_dnode.kvd or ay_transl.origin) to the position of that item in
+ * the array, so the item is found without scanning the whole array. The hash table uses open addressing with linear
+ * probing and its size is always a power of two. The NULL pointers are not indexed.
+ */
+struct ay_pindex {
+    struct ay_pindex_slot *slots;   /**< Array of ay_pindex.size slots. */
+    uint32_t size;                  /**< Number of slots. */
+    uint32_t count;                 /**< Number of occupied slots. */
+};
+
+/**
+ * @brief Hash indexes of the dictionaries and the translation table which are stored in ay_ynode_root.
+ */
+struct ay_ynode_root_index {
+    struct ay_pindex labels;        /**< Index of ay_ynode_root.labels. */
+    struct ay_pindex values;        /**< Index of ay_ynode_root.values. */
+    struct ay_pindex patt_table;    /**< Index of ay_ynode_root.patt_table. */
+};
+
+/**
+ * @brief Occurrence of an identifier in the scope where duplicate identifiers are searched.
+ *
+ * The scope is the nearest non-case ancestor. The occurrences are stored in the Sized array sorted by scope, kind,
+ * base and position, so all occurrences of one identifier base in one scope form a continuous block. The base is
+ * the identifier without the numeric suffix, so renaming 'name' to 'name2' keeps the table valid.
+ */
+struct ay_ident_occur {
+    const struct ay_ynode *scope;   /**< Nearest non-case ancestor of the ay_ident_occur.node. */
+    struct ay_ynode *node;          /**< Node which owns the identifier (ay_ynode.ident). */
+    uint32_t pos;                   /**< Index of the node in the ynode array. It is also its order in the scope. */
+    uint16_t base_len;              /**< Length of the identifier without the numeric suffix. */
+    uint8_t kind;                   /**< Kind of the occurrence (AY_IDENT_OCCUR_*). */
+};
+
+#define AY_IDENT_OCCUR_USES 0   /**< Node of type YN_USES whose grouping is also searched. */
+#define AY_IDENT_OCCUR_NAME 1   /**< Node identifier. */
+
 /**
  * @brief Context for the yang printer.
  */
@@ -517,8 +589,12 @@ struct yprinter_ctx {
     struct module *mod;     /**< Current Augeas module. */
     struct ay_ynode *tree;  /**< Pointer to the Sized array. */
     uint64_t vercode;       /**< Verbose options from API to debugging. */
+    uint64_t options;       /**< Options of the printed YANG module, see AYO_* constants. */
+    ly_bool shared_types;   /**< Flag set if some type refers to the typedef in the augeas-types module. */
     struct ly_out *out;     /**< Output to which it is printed. */
     int space;              /**< Current indent. */
+    char **regex_cache;     /**< Standardized regexes in LY_ARRAY which have already been printed. */
+    struct ay_pindex regex_index;   /**< Index of yprinter_ctx.regex_cache by pnode or pattern pointer. */
 };
 
 /**
@@ -584,25 +660,64 @@ struct lens *ay_lense_get_root(struct module *mod);
  */
 const struct ay_lnode *ay_lnode_next_lv(const struct ay_lnode *lv, uint8_t lv_type);
 
+/**
+ * @brief Initialize hash index for @p capacity items.
+ *
+ * @param[out] index Index to initialize.
+ * @param[in] capacity Expected number of indexed items.
+ * @return 0 on success.
+ */
+int ay_pindex_init(struct ay_pindex *index, uint32_t capacity);
+
+/**
+ * @brief Release memory of the hash index.
+ *
+ * @param[in,out] index Index to clean up. Can be NULL.
+ */
+void ay_pindex_clean(struct ay_pindex *index);
+
+/**
+ * @brief Insert @p key into the index or update its position.
+ *
+ * @param[in,out] index Index to modify.
+ * @param[in] key Pointer to insert. NULL is ignored.
+ * @param[in] pos Position of the item with @p key in the indexed array.
+ * @return 0 on success.
+ */
+int ay_pindex_set(struct ay_pindex *index, const void *key, uint32_t pos);
+
+/**
+ * @brief Find position of the item with @p key.
+ *
+ * @param[in] index Index to search in.
+ * @param[in] key Pointer to find.
+ * @param[out] pos Position of the item in the indexed array.
+ * @return 1 if @p key is found.
+ */
+ly_bool ay_pindex_get(const struct ay_pindex *index, const void *key, uint32_t *pos);
+
 /**
  * @brief Insert new KEY and VALUE pair or insert new VALUE for @p key to the dictionary.
  *
  * @param[in,out] dict Dictionary into which it is inserted.
+ * @param[in,out] index Hash index of @p dict. It is updated by the insertion. Can be NULL.
  * @param[in] key The KEY to search or KEY to insert.
  * @param[in] value The VALUE to be added under @p key. If it is not unique, then another will NOT be added.
  * @param[in] equal Function by which the values will be compared.
  * @return 0 on success.
  */
-int ay_dnode_insert(struct ay_dnode *dict, const void *key, const void *value, int (*equal)(const void *, const void *));
+int ay_dnode_insert(struct ay_dnode *dict, struct ay_pindex *index, const void *key, const void *value,
+        int (*equal)(const void *, const void *));
 
 /**
  * @brief Search dnode KEY/VALUE in the dictionary.
  *
  * @param[in] dict Dictionary in which the @p kvd.
+ * @param[in] index Hash index of @p dict. If NULL, then the @p dict is searched sequentially.
  * @param[in] kvd The Key or Value Data to be searched in the dnode.
  * @return The dnode with the same kvd or NULL.
  */
-struct ay_dnode *ay_dnode_find(struct ay_dnode *dict, const void *kvd);
+struct ay_dnode *ay_dnode_find(struct ay_dnode *dict, const struct ay_pindex *index, const void *kvd);
 
 /**
  * @brief Merge @p key2 and its values into @p key1.
@@ -610,11 +725,12 @@ struct ay_dnode *ay_dnode_find(struct ay_dnode *dict, const void *kvd);
  * The @p key2 becomes value of @p key1.
  *
  * @param[in,out] dict Dictionary in which @p key1 and @p key2 is located.
+ * @param[in,out] index Hash index of @p dict. It is rebuilt after the merge. Can be NULL.
  * @param[in] key1 Key which will be enriched with new elements.
  * @param[in] key2 Key which will be moved together with the values.
  * @return 0 on success.
  */
-int ay_dnode_merge_keys(struct ay_dnode *dict, struct ay_dnode *key1, struct ay_dnode *key2);
+int ay_dnode_merge_keys(struct ay_dnode *dict, struct ay_pindex *index, struct ay_dnode *key1, struct ay_dnode *key2);
 
 /**
  * @brief Check if @p value is already in @p key values.
@@ -630,10 +746,11 @@ ly_bool ay_dnode_value_is_unique(struct ay_dnode *key, const void *value,  int (
  * @brief Find @p origin item in @p table.
  *
  * @param[in] table Array of translation records.
+ * @param[in] index Hash index of @p table. If NULL, then the @p table is searched sequentially.
  * @param[in] origin Pointer according to which the record will be searched.
  * @return Record containing @p origin or NULL.
  */
-struct ay_transl *ay_transl_find(struct ay_transl *table, const char *origin);
+struct ay_transl *ay_transl_find(struct ay_transl *table, const struct ay_pindex *index, const char *origin);
 
 /**
  * @brief Check if pattern is so simple that can be interpreted as label.
@@ -50,11 +50,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 
 #include <libyang/libyang.h>
 
 #include "augeas.h"
 #include "augyang.h"
+#include "ay_loadpath.h"
 #include "errcode.h"
 #include "list.h"
 #include "syntax.h"
@@ -81,6 +84,11 @@
  */
 #define AYM_PROGNAME "augyang"
 
+/**
+ * @brief Name of the YANG module with typedefs shared by the generated YANG modules.
+ */
+#define AYM_TYPES_MODULE "augeas-types"
+
 /**
  * @brief Modules for which YANG will not be generated.
  */
@@ -93,6 +101,17 @@ const char * const ignored_modules[] = {
     "util.aug",
 };
 
+/**
+ * @brief Augeas modules from which the AYM_TYPES_MODULE is generated.
+ */
+const char * const shared_modules[] = {
+    "rx",
+    "util",
+    "sep",
+    "quote",
+    "build",
+};
+
 /**
  * @brief Print help to stderr.
  */
@@ -110,16 +129,24 @@ aym_usage(void)
             "  -a, --all          process all augeas modules in Search DIR;\n"
             "                     if the root lense is not found, then the module is ignored;\n"
             "                     (for example rx.aug, build.aug, ...)\n"
+            "  -A, --autoload     print the autoloaded lens and its filter so that the DS plugin\n"
+            "                     loads only the augeas modules it needs\n"
             "  -e, --explicit     default value of the -I parameter is not used;\n"
             "                     only the directories specified by the -I parameter are used\n"
             "  -I, --include DIR  Search DIR for augeas modules; can be given multiple times;\n"
             "                     default value: " AUGEAS_LENSES_DIR "\n"
+            "  -l, --literals     print the list of labels for nodes whose label regex matches only a few strings\n"
+            "  -m, --minimize     minimize regular expressions in the YANG patterns\n"
             "  -n, --name         print the name of the currently processed module\n"
             "  -O, --outdir DIR   directory in which the generated yang file is written;\n"
             "                     default value: ./\n"
             "  -q, --quiet        generated yang is not printed or written to the file\n"
             "  -s, --show         print the generated yang only to stdout and not to the file\n"
+            "  -S, --stats        print the time and the number of nodes of every transformation as JSON\n"
+            "                     to stderr, the generated yang stays on stdout\n"
             "  -t, --typecheck    typecheck lenses. Recommended to use during lense development.\n"
+            "  -T, --types        generate also the " AYM_TYPES_MODULE " module with typedefs for regexes\n"
+            "                     from the rx, util, sep, quote and build modules and refer to them\n"
             "  -v, --verbose HEX  bitmask for various debug outputs\n"
             "  -y, --yanglint     validates the YANG module\n"
             "\nExample:\n"
@@ -181,105 +208,6 @@ aym_get_vercode(char *optarg, uint64_t *vercode)
     return ret;
 }
 
-/**
- * @brief Add path (string item) to the loadpath variable.
- *
- * @param[in,out] loadpath Storage of paths (strings) separated by PATH_SEP_CHAR.
- * @param[in,out] loadpathlen Length of whole loadpath string, excluding the terminating null byte.
- * @param[in] item Path that will be added to @p loadpath.
- * @return 0 if operation success.
- */
-static int
-aym_loadpath_add(char **loadpath, uint64_t *loadpathlen, char *item)
-{
-    int ret = 0;
-    uint64_t new_loadpathlen, itemlen;
-    char *new_loadpath;
-
-    if (!*loadpath) {
-        *loadpath = strdup(item);
-        *loadpathlen = strlen(item);
-        ret = *loadpath ? 0 : 1;
-    } else if (item) {
-        /* allocate enough memory space */
-        itemlen = strlen(item);
-        /* loadpathlen + 'null byte' + 'PATH_SEP_CHAR' + itemlen + 'null byte' */
-        new_loadpathlen = *loadpathlen + itemlen + 3;
-        new_loadpath = realloc(*loadpath, new_loadpathlen);
-        if (!new_loadpath) {
-            free(*loadpath);
-            *loadpath = NULL;
-            return 1;
-        }
-        *loadpath = new_loadpath;
-
-        /* copy item to loadpath */
-        (*loadpath)[*loadpathlen] = PATH_SEP_CHAR;
-        strcpy(*loadpath + *loadpathlen + 1, item);
-        *loadpathlen = new_loadpathlen;
-    }
-
-    return ret;
-}
-
-/**
- * @brief Get next path from the loadpath variable.
- *
- * @param[in] loadpath_iter Pointer to some item (path/string) in the loadpath.
- * @return Next item or NULL.
- */
-static char *
-aym_loadpath_next(const char *loadpath_iter)
-{
-    char *next;
-
-    if (loadpath_iter && (next = strchr(loadpath_iter, PATH_SEP_CHAR))) {
-        return next + 1;
-    } else {
-        return NULL;
-    }
-}
-
-/**
- * @brief Get length of @p loadpath_item (path/string).
- *
- * @param[in] loadpath_item Pointer to some item (path/string) in the loadpath.
- * @return Length of item.
- */
-static size_t
-aym_loadpath_pathlen(const char *loadpath_item)
-{
-    char *retval;
-
-    if (!loadpath_item) {
-        return 0;
-    } else if ((retval = strchr(loadpath_item, PATH_SEP_CHAR))) {
-        return retval - loadpath_item;
-    } else {
-        return strlen(loadpath_item);
-    }
-}
-
-/**
- * @brief Find the size of the longest path (string) in the loadpath
- *
- * @param[in] loadpath Array of strings.
- * @return The number of characters in the longest string.
- */
-static size_t
-aym_loadpath_maxpath(char *loadpath)
-{
-    size_t ret = 0, len;
-    char *iter;
-
-    for (iter = loadpath; iter; iter = aym_loadpath_next(iter)) {
-        len = aym_loadpath_pathlen(iter);
-        ret = len > ret ? len : ret;
-    }
-
-    return ret;
-}
-
 /**
  * @brief Check if the path points to a directory.
  *
@@ -300,89 +228,6 @@ aym_dir_exists(const char *path)
     }
 }
 
-/**
- * @brief Check if the path points to a file.
- *
- * @param[in] path Path to check.
- * @return 1 if path points to existing file, otherwise 0.
- */
-static bool
-aym_file_exists(const char *path)
-{
-    FILE *file;
-
-    file = fopen(path, "r");
-    if (file) {
-        fclose(file);
-        return 1;
-    } else {
-        return 0;
-    }
-}
-
-/**
- * @brief Insert directory path to the file name.
- *
- * @param[in] dirpath String to insert.
- * @param[in,out] filename Sufficiently large buffer already containing file name.
- * The output form will be "dirpath<slash>filename".
- */
-static void
-aym_insert_dirpath(const char *dirpath, char *filename)
-{
-    uint64_t dirpathlen;
-
-    dirpathlen = aym_loadpath_pathlen(dirpath),
-    filename[dirpathlen + AYM_SLASH_LEN + strlen(filename)] = '\0';
-    memmove(filename + dirpathlen + AYM_SLASH_LEN, filename, strlen(filename));
-    memcpy(filename, dirpath, dirpathlen);
-    filename[dirpathlen] = '/';
-}
-
-/**
- * @brief Remove directory path and leave only the file name.
- *
- * This function is opposite of insert_dirpath().
- *
- * @param[in] dirpath string to remove from @p filename.
- * @param[in,out] filename Buffer which begins with the string @p dirpath.
- * The output form will be "filename".
- */
-static void
-aym_remove_dirpath(const char *dirpath, char *filename)
-{
-    uint64_t new_end, dirpathlen;
-
-    dirpathlen = aym_loadpath_pathlen(dirpath),
-    assert(!strncmp(filename, dirpath, dirpathlen));
-    new_end = strlen(filename) - (dirpathlen + AYM_SLASH_LEN);
-    memmove(filename, filename + dirpathlen + AYM_SLASH_LEN, new_end);
-    filename[new_end] = '\0';
-}
-
-/**
- * @brief Find out in which directory path the module @p filename is located.
- *
- * @param[in] loadpath Array of paths separated by PATH_SEP_CHAR.
- * @param[in] filename Buffer containing file name. It is not modified.
- * @return Directory path from @p loadpath.
- */
-static const char *
-aym_find_aug_module(char *loadpath, char *filename)
-{
-    bool succ = 0;
-    char *iter, *loadpath_item;
-
-    for (iter = loadpath; !succ && iter; iter = aym_loadpath_next(iter)) {
-        loadpath_item = iter;
-        aym_insert_dirpath(iter,  filename);
-        succ = aym_file_exists(filename);
-        aym_remove_dirpath(iter, filename);
-    }
-
-    return succ ? loadpath_item : NULL;
-}
-
 /**
  * @brief Create filename by name and suffix.
  *
@@ -543,12 +388,12 @@ aym_module_iter_dir(struct aym_iter_dir *it, int *err)
     /* Iterate over directories. */
     for (it->loadpath_iter = !it->dir ? it->loadpath : it->loadpath_iter;
             it->loadpath_iter;
-            it->loadpath_iter = aym_loadpath_next(it->loadpath_iter)) {
+            it->loadpath_iter = ay_loadpath_next(it->loadpath_iter)) {
 
         /* Open a new directory if not set. */
         if (!it->dir) {
             /* Temporarily allocate memory space for the directory path. */
-            len = aym_loadpath_pathlen(it->loadpath_iter);
+            len = ay_loadpath_pathlen(it->loadpath_iter);
             path = strndup(it->loadpath_iter, len);
             if (!path) {
                 fprintf(stderr, "ERROR: Allocation of memory failed\n");
@@ -703,10 +548,12 @@ static char *
 aym_allocate_filename_buffer(struct aym_iter *moditer, char *outdir, char *loadpath)
 {
     char *buffer;
-    size_t maxpathlen, maxmodname = 0, maxyang, maxaug, buffer_size;
+    size_t maxpathlen, maxmodname, maxyang, maxaug, buffer_size;
     char *modname;
 
-    maxpathlen = aym_loadpath_maxpath(loadpath);
+    maxpathlen = ay_loadpath_maxpath(loadpath);
+    /* The AYM_TYPES_MODULE and shared_modules can be also written or loaded. */
+    maxmodname = strlen(AYM_TYPES_MODULE);
     AYM_MODULE_ITER_FOR(moditer, modname) {
         maxmodname = strlen(modname) > maxmodname ? strlen(modname) : maxmodname;
     }
@@ -719,33 +566,161 @@ aym_allocate_filename_buffer(struct aym_iter *moditer, char *outdir, char *loadp
     return buffer;
 }
 
+/**
+ * @brief Generate the AYM_TYPES_MODULE from the shared_modules.
+ *
+ * @param[in] loadpath Storage of paths.
+ * @param[in] flags Flags for aug_init().
+ * @param[in] opts Options for printing, see AYO_* constants.
+ * @param[in] filename Sufficiently large buffer which will be overwritten.
+ * @param[out] str Generated YANG module.
+ * @return 0 on success.
+ */
+static int
+aym_print_shared_types(char *loadpath, unsigned int flags, uint64_t opts, char *filename, char **str)
+{
+    int ret = 0, rv;
+    uint64_t i;
+    struct augeas *aug;
+    struct module *mod_iter;
+    const char *dirpath;
+
+    aug = aug_init(NULL, loadpath, flags);
+    if (aug == NULL) {
+        fprintf(stderr, "ERROR: aug_init memory exhausted\n");
+        return 1;
+    }
+
+    for (i = 0; i < sizeof shared_modules / sizeof *shared_modules; i++) {
+        /* The module could have been loaded as a dependency. */
+        for (mod_iter = aug->modules; mod_iter && strcasecmp(mod_iter->name, shared_modules[i]);
+                mod_iter = mod_iter->next) {}
+        if (mod_iter) {
+            continue;
+        }
+
+        aym_insert_filename(shared_modules[i], ".aug", 0, filename);
+        dirpath = ay_loadpath_find_module(loadpath, filename);
+        if (!dirpath) {
+            /* Typedefs from this module are not generated. */
+            continue;
+        }
+        ay_loadpath_insert_dirpath(dirpath, filename);
+        if (__aug_load_module_file(aug, filename) == -1) {
+            fprintf(stderr, "ERROR: %s\n", aug_error_message(aug));
+            ret = 1;
+            goto cleanup;
+        }
+    }
+
+    rv = augyang_print_shared_types(aug, opts, str);
+    if (rv) {
+        fprintf(stderr, "%s", augyang_get_error_message(rv));
+        ret = 1;
+    }
+
+cleanup:
+    aug_close(aug);
+
+    return ret;
+}
+
+/**
+ * @brief Create libyang context for the validation of all the generated YANG modules.
+ *
+ * The modules imported by the generated YANG modules are parsed only once. The ietf-inet-types module is internal
+ * in libyang, so it is always present.
+ *
+ * @param[in] types_str Optional generated AYM_TYPES_MODULE.
+ * @param[out] ctx New libyang context.
+ * @return 0 on success.
+ */
+static int
+aym_yanglint_ctx_new(const char *types_str, struct ly_ctx **ctx)
+{
+    if (ly_ctx_new(NULL, 0, ctx) != LY_SUCCESS) {
+        fprintf(stderr, "ERROR: Failed to create libyang context\n");
+        *ctx = NULL;
+        return 1;
+    }
+
+    /* Parse augeas extension. */
+    if (lys_parse_mem(*ctx, (const char *)augeas_extension_yang, LYS_IN_YANG, NULL) != LY_SUCCESS) {
+        fprintf(stderr, "ERROR: Failed to parse augeas_extension_yang.\n");
+        return 1;
+    }
+
+    /* Parse module with shared typedefs. */
+    if (types_str && lys_parse_mem(*ctx, types_str, LYS_IN_YANG, NULL)) {
+        fprintf(stderr, "ERROR: Failed to parse " AYM_TYPES_MODULE ".\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Validate the generated YANG module in the shared libyang context.
+ *
+ * The generated modules do not import each other, so the module can stay in the context. If the module is not valid,
+ * libyang does not add it to the context.
+ *
+ * @param[in] ctx Context created by aym_yanglint_ctx_new().
+ * @param[in] modname Name of the augeas module.
+ * @param[in] str Generated YANG module.
+ * @param[in] opts Options. If AYO_TRANS_STATS is set, the time of parsing and compiling is printed to stderr.
+ * @return 0 if the module is valid.
+ */
+static int
+aym_yanglint_validate(struct ly_ctx *ctx, const char *modname, const char *str, uint64_t opts)
+{
+    int ret;
+    struct timespec start, end;
+
+    ly_err_clean(ctx, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = lys_parse_mem(ctx, str, LYS_IN_YANG, NULL) || ly_err_last(ctx);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (opts & AYO_TRANS_STATS) {
+        fprintf(stderr, "{\"module\":\"%s\",\"yanglint_usec\":%" PRId64 "}\n", modname,
+                (int64_t)(end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000);
+    }
+
+    return ret;
+}
+
 int
 main(int argc, char **argv)
 {
-    int opt, ret = 0, rv, explicit = 0, show = 0, quiet = 0, yanglint = 0, all = 0, print_name = 0;
+    int opt, ret = 0, rv, explicit = 0, show = 0, quiet = 0, yanglint = 0, all = 0, print_name = 0, types = 0;
     struct augeas *aug = NULL;
-    char *loadpath = NULL, *str = NULL, *modname, *outdir = NULL;
+    char *loadpath = NULL, *str = NULL, *modname, *outdir = NULL, *types_str = NULL;
     const char *dirpath;
     size_t loadpathlen = 0;
     struct module *mod = NULL, *mod_iter;
     char *filename = NULL;
     FILE *file = NULL;
-    uint64_t vercode = 0;
+    uint64_t vercode = 0, opts = 0;
     struct ly_ctx *ctx = NULL;
     struct aym_iter module_name_iter = {0};
     struct aym_iter *modname_iter = &module_name_iter;
-    LY_ERR err;
 
     struct option options[] = {
         {"help",      0, 0, 'h'},
         {"all",       0, 0, 'a'},
+        {"autoload",  0, 0, 'A'},
         {"explicit",  0, 0, 'e'},
         {"include",   1, 0, 'I'},
+        {"literals",  0, 0, 'l'},
+        {"minimize",  0, 0, 'm'},
         {"name",      0, 0, 'n'},
         {"outdir",    1, 0, 'O'},
         {"quiet",     0, 0, 'q'},
         {"show",      0, 0, 's'},
+        {"stats",     0, 0, 'S'},
         {"typecheck", 0, 0, 't'},
+        {"types",     0, 0, 'T'},
         {"verbose",   1, 0, 'v'},
         {"yanglint",  0, 0, 'y'},
         {0, 0, 0, 0}
@@ -753,16 +728,25 @@ main(int argc, char **argv)
     int idx;
     unsigned int flags = AUG_NO_MODL_AUTOLOAD | AUG_NO_LOAD;
 
-    while ((opt = getopt_long(argc, argv, "haeI:nO:qstv:y", options, &idx)) != -1) {
+    while ((opt = getopt_long(argc, argv, "haAeI:lmnO:qsStTv:y", options, &idx)) != -1) {
         switch (opt) {
         case 'a':
             all = 1;
             break;
+        case 'A':
+            opts |= AYO_AUTOLOAD;
+            break;
         case 'e':
             explicit = 1;
             break;
         case 'I':
-            ret |= aym_loadpath_add(&loadpath, &loadpathlen, optarg);
+            ret |= ay_loadpath_add(&loadpath, &loadpathlen, optarg);
+            break;
+        case 'l':
+            opts |= AYO_LABEL_LITERALS;
+            break;
+        case 'm':
+            opts |= AYO_REGEX_MIN;
             break;
         case 'n':
             print_name = 1;
@@ -776,9 +760,16 @@ main(int argc, char **argv)
         case 's':
             show = 1;
             break;
+        case 'S':
+            opts |= AYO_TRANS_STATS;
+            break;
         case 't':
             flags |= AUG_TYPE_CHECK;
             break;
+        case 'T':
+            types = 1;
+            opts |= AYO_SHARED_TYPES;
+            break;
         case 'v':
             ret |= aym_get_vercode(optarg, &vercode);
             break;
@@ -820,7 +811,7 @@ main(int argc, char **argv)
 
     if (!explicit) {
         /* add default lense directory */
-        ret = aym_loadpath_add(&loadpath, &loadpathlen, AUGEAS_LENSES_DIR);
+        ret = ay_loadpath_add(&loadpath, &loadpathlen, AUGEAS_LENSES_DIR);
         if (ret) {
             goto cleanup;
         }
@@ -853,19 +844,39 @@ main(int argc, char **argv)
         goto cleanup;
     }
 
+    if (types) {
+        /* Generate yang module which is imported by other generated yang modules. */
+        if (aym_print_shared_types(loadpath, flags, opts, filename, &types_str)) {
+            ret = 1;
+            goto cleanup;
+        }
+        if (show) {
+            printf("%s", types_str);
+        } else if (!quiet) {
+            aym_insert_filename(AYM_TYPES_MODULE, ".yang", 0, filename);
+            ay_loadpath_insert_dirpath(outdir, filename);
+            file = fopen(filename, "w");
+            if (!file) {
+                fprintf(stderr, "ERROR: failed to open %s\n", filename);
+                ret = 1;
+                goto cleanup;
+            }
+            fprintf(file, "%s", types_str);
+            fclose(file);
+        }
+    }
+
     /* For every augeas module generate yang file. */
     AYM_MODULE_ITER_FOR(modname_iter, modname) {
         aug_close(aug);
-        ly_ctx_destroy(ctx);
         free(str);
         aug = NULL;
         str = NULL;
-        ctx = NULL;
 
         if (modname_iter->type == AYI_ARGV) {
             /* Find entered augeas module. */
             aym_insert_filename(modname, ".aug", 0, filename);
-            dirpath = aym_find_aug_module(loadpath, filename);
+            dirpath = ay_loadpath_find_module(loadpath, filename);
             if (!dirpath) {
                 fprintf(stderr, "ERROR: file %s not found in any directory\n", filename);
                 ret = 1;
@@ -886,7 +897,7 @@ main(int argc, char **argv)
             fprintf(stdout, "%s\n", modname);
         }
         /* Concatenate directory path with filename. */
-        aym_insert_dirpath(dirpath, filename);
+        ay_loadpath_insert_dirpath(dirpath, filename);
 
         /* Initialize augeas context. */
         aug = aug_init(NULL, loadpath, flags);
@@ -915,7 +926,7 @@ main(int argc, char **argv)
         }
 
         /* Generate yang module as string. */
-        rv = augyang_print_yang(mod, vercode, &str);
+        rv = augyang_print_yang(mod, vercode, opts, &str);
         if (all && rv && (rv == AYE_LENSE_NOT_FOUND)) {
             /* Ignore module that can be auxiliary, eg rx.aug, build.aug... */
             continue;
@@ -932,7 +943,7 @@ main(int argc, char **argv)
         } else if (!quiet) {
             /* Write YANG to the yang file. */
             aym_insert_filename(modname, ".yang", 1, filename);
-            aym_insert_dirpath(outdir, filename);
+            ay_loadpath_insert_dirpath(outdir, filename);
             file = fopen(filename, "w");
             if (!file) {
                 fprintf(stderr, "ERROR: failed to open %s\n", filename);
@@ -943,24 +954,12 @@ main(int argc, char **argv)
         }
 
         if (yanglint) {
-            /* Validate the YANG module. */
-            err = ly_ctx_new(NULL, 0, &ctx);
-            if (err != LY_SUCCESS) {
-                fprintf(stderr, "ERROR: Failed to create libyang context\n");
+            /* Validate the YANG module, the context is shared by all the generated modules. */
+            if (!ctx && aym_yanglint_ctx_new(types_str, &ctx)) {
                 ret = 1;
-                ctx = NULL;
                 goto cleanup;
             }
-
-            /* Parse augeas extension. */
-            err = lys_parse_mem(ctx, (const char *)augeas_extension_yang, LYS_IN_YANG, NULL);
-            if (err != LY_SUCCESS) {
-                fprintf(stderr, "ERROR: Failed to parse augeas_extension_yang.\n");
-                ret = 1;
-            }
-
-            /* Parse generated YANG module. */
-            if (lys_parse_mem(ctx, str, LYS_IN_YANG, NULL) || *ly_last_errmsg()) {
+            if (aym_yanglint_validate(ctx, modname, str, opts)) {
                 ret = 1;
             }
         }
@@ -968,6 +967,7 @@ main(int argc, char **argv)
 
 cleanup:
     free(str);
+    free(types_str);
     aug_close(aug);
     free(loadpath);
     free(filename);
@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <libyang/libyang.h>
@@ -130,7 +131,7 @@ ay_lense_pattern_has_idents(const struct ay_ynode *tree, const struct lens *lens
     patt = lens->regexp->pattern->str;
 
     if (tree) {
-        return ay_transl_find(AY_YNODE_ROOT_PATT_TABLE(tree), patt);
+        return ay_transl_find(AY_YNODE_ROOT_PATT_TABLE(tree), AY_YNODE_ROOT_PATT_INDEX(tree), patt);
     }
 
     for (iter = patt; *iter != '\0'; iter++) {
@@ -161,98 +162,36 @@ ay_lense_pattern_has_idents(const struct ay_ynode *tree, const struct lens *lens
 }
 
 /**
- * @brief Check if all bits in the bitset are set to 0.
+ * @brief Maximum number of identifiers derived from one union token containing question marks.
  *
- * @param[in] bitset Bits to check.
- * @param[in] size Number of bits in @p bitset.
- * @return 1 if all bits are 0.
+ * Each optional part doubles the number of possible identifiers. If the union token yields more identifiers, the
+ * pattern is not split into identifiers at all and it is processed as a regular expression.
  */
-static ly_bool
-ay_bitset_is_zero(uint8_t *bitset, uint64_t size)
-{
-    uint64_t i;
-
-    for (i = 0; i < size; i++) {
-        if (bitset[i]) {
-            return 0;
-        }
-    }
-
-    return 1;
-}
+#define AY_PATTERN_QM_IDENTS_MAX 64
 
 /**
- * @brief Find the position of the most significant bit.
- *
- * @param[in] bitset Array of bits.
- * @param[in] size Number of bits in @p bitset.
- * @return Position of most significant bit, or 0 if no bits are set in @p bitset.
+ * @brief Character of the union token which contains question marks.
  */
-static uint64_t
-ay_bitset_msb(uint8_t *bitset, uint64_t size)
-{
-    uint64_t i;
-
-    for (i = size; i && !bitset[i - 1]; i--) {}
-    return i ? i : 0;
-}
-
-/**
- * @brief Set all bits in @p bitset to zero.
- *
- * @param[in] bitset Array of bits.
- * @param[in] size Number of bits in @p bitset.
- */
-static void
-ay_bitset_clear(uint8_t *bitset, uint64_t size)
-{
-    uint64_t i;
-
-    for (i = 0; i < size; i++) {
-        bitset[i] = 0;
-    }
-}
-
-/**
- * @brief Set the most significant bit to zero.
- *
- * @param[in] bitset Array of bits.
- * @param[in] size Number of bits in @p bitset.
- */
-static void
-ay_bitset_clear_msb(uint8_t *bitset, uint64_t size)
-{
-    uint64_t msb;
-
-    msb = ay_bitset_msb(bitset, size);
-    assert(msb);
-    bitset[msb - 1] = 0;
-}
+struct ay_qm_char {
+    char ch;            /**< Character copied to the identifier. */
+    uint32_t group;     /**< Index + 1 of the innermost optional group containing the character, 0 if mandatory. */
+};
 
 /**
- * @brief Convert the @p number to the corresponding sequence of bits.
+ * @brief Union token which contains question marks, decomposed into optional groups.
  *
- * @param[in] bitset Array of bits.
- * @param[in] size Number of bits in @p bitset.
- * @param[in] number Number used to initialize the bitset.
+ * An optional group is either '(...)?' or a single character followed by '?'. The groups are numbered in the order
+ * in which they begin in the token, so a nested group always has a higher number than the group containing it.
  */
-static void
-ay_bitset_create_from_uint64(uint8_t *bitset, uint64_t size, uint64_t number)
-{
-    uint8_t i;
-
-    assert(size <= 63);
-    for (i = 0; (i < size); i++) {
-        if (number & (1 << i)) {
-            bitset[i] = 1;
-        } else {
-            bitset[i] = 0;
-        }
-    }
-    for ( ; (i < size); i++) {
-        bitset[i] = 0;
-    }
-}
+struct ay_qm_token {
+    struct ay_qm_char *chars;   /**< Characters of the token without parentheses and question marks. */
+    uint32_t chars_count;       /**< Number of items in ay_qm_token.chars. */
+    uint32_t *parent;           /**< Index + 1 of the parent group for every group, 0 if it is not nested. */
+    uint32_t *nested_incl;      /**< Number of included nested groups for every group. */
+    uint8_t *incl;              /**< Flag for every group that it is included in the current identifier. */
+    uint32_t groups_count;      /**< Number of optional groups. */
+    uint32_t idents_count;      /**< Number of identifiers already derived. */
+};
 
 /**
  * @brief Remove character from string.
@@ -322,25 +261,20 @@ ay_pattern_identifier_qm_count(const char *ptoken, uint64_t ptoken_len)
 }
 
 /**
- * @brief Count the number of variations from the pattern based on the question mark symbol.
+ * @brief Get the maximum number of identifiers that can be derived from the pattern with question marks.
  *
  * @param[in] ptoken Subpattern to process.
  * @param[in] ptoken_len Length of @p ptoken.
- * @return Number of variations.
+ * @return Number of identifiers, at most AY_PATTERN_QM_IDENTS_MAX.
  */
 static uint64_t
-ay_pattern_identifier_qm_variations(const char *ptoken, uint64_t ptoken_len)
+ay_pattern_identifier_qm_capacity(const char *ptoken, uint64_t ptoken_len)
 {
-    uint64_t i, qm, ret;
+    uint64_t qm;
 
     qm = ay_pattern_identifier_qm_count(ptoken, ptoken_len);
 
-    ret = 1;
-    for (i = 0; i < qm; i++) {
-        ret *= 2;
-    }
-
-    return ret;
+    return (qm < 63) && ((1ULL << qm) < AY_PATTERN_QM_IDENTS_MAX) ? (1ULL << qm) : AY_PATTERN_QM_IDENTS_MAX;
 }
 
 /**
@@ -362,10 +296,10 @@ ay_pattern_idents_count(const char *patt)
         assert(*vbar);
         len = vbar - prev_vbar;
         ret += ay_pattern_identifier_nocase_variations(prev_vbar, len);
-        ret += ay_pattern_identifier_qm_variations(prev_vbar, len);
+        ret += ay_pattern_identifier_qm_capacity(prev_vbar, len);
         prev_vbar = vbar;
     }
-    ret += ay_pattern_identifier_qm_variations(prev_vbar, strlen(prev_vbar));
+    ret += ay_pattern_identifier_qm_capacity(prev_vbar, strlen(prev_vbar));
 
     return ret;
 }
@@ -752,89 +686,140 @@ ay_pattern_identifier_nocase(const char *ptoken, uint64_t ptoken_len, char *buff
 }
 
 /**
- * @brief Get identifier from union token located in pattern based on question mark ('?').
+ * @brief Release memory of the decomposed union token.
  *
- * Example:
- * ptoken is "ab(cd(ef)?)?".
- * - theoretical total number of variations is 4, so total_vari is 4.
- * variation | vari | buffer
- * 1         | 00   | "ab"
- * 2         | 01   | "abcd"
- * 3         | 10   | "" (invalid variation, due to dependency between question marks)
- * 4         | 11   | "abcdef"
+ * @param[in] tok Token to clean up.
+ */
+static void
+ay_qm_token_clean(struct ay_qm_token *tok)
+{
+    free(tok->chars);
+    free(tok->parent);
+    free(tok->nested_incl);
+    free(tok->incl);
+}
+
+/**
+ * @brief Decompose union token with question marks into characters and optional groups.
  *
- * Question mark without parenthesis (etc. abc?) is not supported.
+ * Question mark without parenthesis is applied to the preceding character (etc. abc? is 'ab' followed by optional 'c').
  *
  * @param[in] ptoken Union token.
  * @param[in] ptoken_len Length of @p ptoken.
- * @param[in] flag Bitset for temporary storage of flag. It is used for the @p ptoken analysis.
- * @param[in] vari Bitset of desired variation.
- * @param[in] total_vari Length of @p flag and @p vari.
- * @param[out] buffer Buffer in which the identifier is stored.
- * @return 0 on success.
+ * @param[out] tok Decomposed token. It must be cleaned by ay_qm_token_clean() even if the function fails.
+ * @return 0 on success, -1 if @p ptoken is not supported.
  */
 static int
-ay_pattern_identifier_qm_(const char *ptoken, uint64_t ptoken_len, uint8_t *flag, uint8_t *vari, uint64_t total_vari,
-        char *buffer)
+ay_qm_token_create(const char *ptoken, uint64_t ptoken_len, struct ay_qm_token *tok)
 {
-    uint64_t i, j, group, bufidx, msb;
+    uint64_t i;
+    uint32_t *stack, depth, group;
+
+    memset(tok, 0, sizeof *tok);
+    tok->chars = malloc(ptoken_len * sizeof *tok->chars);
+    tok->parent = malloc(ptoken_len * sizeof *tok->parent);
+    tok->nested_incl = calloc(ptoken_len, sizeof *tok->nested_incl);
+    tok->incl = calloc(ptoken_len, sizeof *tok->incl);
+    stack = malloc(ptoken_len * sizeof *stack);
+    if (!tok->chars || !tok->parent || !tok->nested_incl || !tok->incl || !stack) {
+        free(stack);
+        return AYE_MEMORY;
+    }
 
-    group = 0;
-    bufidx = 0;
+    depth = 0;
     for (i = 0; i < ptoken_len; i++) {
+        group = depth ? stack[depth - 1] + 1 : 0;
         if (ptoken[i] == '(') {
-            flag[group] = 1;
-            group++;
-            /* The ay_pattern_remove_parentheses() should guarantee that there are no unnecessary parentheses. */
-            assert(group < total_vari);
-            continue;
-        } else if ((ptoken[i] == ')') && (ptoken[i + 1] == '?')) {
-            ay_bitset_clear_msb(flag, total_vari);
+            /* Begin optional group. */
+            tok->parent[tok->groups_count] = group;
+            stack[depth++] = tok->groups_count++;
+        } else if (ptoken[i] == ')') {
+            if (!depth || ((i + 1) == ptoken_len) || (ptoken[i + 1] != '?')) {
+                /* Mandatory group in parentheses. */
+                free(stack);
+                return -1;
+            }
+            depth--;
             i++;
-            continue;
-        } else if (ay_bitset_is_zero(flag, total_vari) && (ptoken[i + 1] != '?')) {
-            AY_CHECK_COND(bufidx >= AY_MAX_IDENT_SIZE, AYE_IDENT_LIMIT);
-            buffer[bufidx++] = ptoken[i];
-            continue;
-        } else if ((ptoken[i + 1] == '?') && !vari[group]) {
-            group++;
-            assert(group < total_vari);
+        } else if (((i + 1) < ptoken_len) && (ptoken[i + 1] == '?')) {
+            /* Optional character. */
+            tok->parent[tok->groups_count] = group;
+            tok->chars[tok->chars_count].ch = ptoken[i];
+            tok->chars[tok->chars_count++].group = ++tok->groups_count;
             i++;
-            continue;
-        } else if (((msb = ay_bitset_msb(flag, total_vari))) && !vari[msb - 1]) {
-            continue;
-        }
-
-        if ((ptoken[i + 1] == '?') && vari[group]) {
-            flag[group] = 1;
-            msb = group;
         } else {
-            msb = ay_bitset_msb(flag, total_vari);
+            tok->chars[tok->chars_count].ch = ptoken[i];
+            tok->chars[tok->chars_count++].group = group;
         }
+    }
+    free(stack);
 
-        for (j = 0; j < msb; j++) {
-            if (flag[j] && !vari[j]) {
-                /* This variation is invalid. The question marks
-                 * are nested within each other and one is dependent on the other.
-                 */
-                buffer[0] = '\0';
-                return 0;
+    return depth ? -1 : 0;
+}
+
+/**
+ * @brief Derive identifiers for all allowed combinations of groups starting from @p group.
+ *
+ * The groups are decided from the last one, where the group is first excluded and then included. So the identifiers
+ * are ordered as if the combination were a binary number whose bit N determines whether the N-th group is included.
+ * The group can be excluded only if none of its nested groups is included, so no combination is ever discarded.
+ *
+ * Example:
+ * ptoken is "ab(cd(ef)?)?". Groups are (cd(ef)?)? and (ef)?.
+ * combination | identifier
+ * 00          | "ab"
+ * 01          | "abcd"
+ * 11          | "abcdef"
+ *
+ * @param[in,out] tok Decomposed union token.
+ * @param[in] group Number of groups which are not yet decided.
+ * @param[in] buffer Buffer for temporary storage of the identifier.
+ * @param[in,out] tran Record from translation table in which the identifiers are stored.
+ * @return 0 on success, -1 if there are more than AY_PATTERN_QM_IDENTS_MAX identifiers.
+ */
+static int
+ay_pattern_identifier_qm_(struct ay_qm_token *tok, uint32_t group, char *buffer, struct ay_transl *tran)
+{
+    int ret;
+    uint32_t i, bufidx, parent;
+
+    if (!group) {
+        /* All groups are decided, write the identifier. */
+        bufidx = 0;
+        for (i = 0; i < tok->chars_count; i++) {
+            if (!tok->chars[i].group || tok->incl[tok->chars[i].group - 1]) {
+                AY_CHECK_COND(bufidx >= (AY_MAX_IDENT_SIZE - 1), AYE_IDENT_LIMIT);
+                buffer[bufidx++] = tok->chars[i].ch;
             }
         }
+        buffer[bufidx] = '\0';
+        if (!bufidx) {
+            return 0;
+        }
+        AY_CHECK_COND(tok->idents_count == AY_PATTERN_QM_IDENTS_MAX, -1);
+        tok->idents_count++;
+        return ay_pattern_identifier_add(tran, buffer);
+    }
 
-        AY_CHECK_COND(bufidx >= AY_MAX_IDENT_SIZE, AYE_IDENT_LIMIT);
-        buffer[bufidx++] = ptoken[i];
+    group--;
+    parent = tok->parent[group];
 
-        if ((ptoken[i + 1] == '?')) {
-            flag[group] = 0;
-            group++;
-            i++;
-        }
+    if (!tok->nested_incl[group]) {
+        tok->incl[group] = 0;
+        ret = ay_pattern_identifier_qm_(tok, group, buffer, tran);
+        AY_CHECK_RET(ret);
     }
 
-    buffer[bufidx] = '\0';
+    tok->incl[group] = 1;
+    if (parent) {
+        tok->nested_incl[parent - 1]++;
+    }
+    ret = ay_pattern_identifier_qm_(tok, group, buffer, tran);
+    if (parent) {
+        tok->nested_incl[parent - 1]--;
+    }
 
-    return 0;
+    return ret;
 }
 
 /**
@@ -844,39 +829,20 @@ ay_pattern_identifier_qm_(const char *ptoken, uint64_t ptoken_len, uint8_t *flag
  * @param[in] ptoken_len Length of @p ptoken.
  * @param[in] buffer Buffer for temporary storage of the identifier.
  * @param[in,out] tran Record from translation table in which the identifiers are stored.
- * @return 0 on success.
+ * @return 0 on success, -1 if @p ptoken is not supported or yields too many identifiers.
  */
 static int
 ay_pattern_identifier_qm(const char *ptoken, uint64_t ptoken_len, char *buffer, struct ay_transl *tran)
 {
-    int ret = 0;
-    uint64_t i, total_vari;
-    uint8_t *flag = NULL, *vari = NULL;
-
-    total_vari = ay_pattern_identifier_qm_variations(ptoken, ptoken_len);
-    assert(total_vari);
-    if (total_vari > 63) {
-        return AYE_INTERNAL_ERROR;
-    }
-    flag = malloc(sizeof(uint8_t) * total_vari);
-    vari = malloc(sizeof(uint8_t) * total_vari);
-    if (!flag || !vari) {
-        ret = AYE_MEMORY;
-        goto free;
-    }
-
-    for (i = 0; i < total_vari; i++) {
-        ay_bitset_clear(flag, total_vari);
-        ay_bitset_create_from_uint64(vari, total_vari, i);
-        ret = ay_pattern_identifier_qm_(ptoken, ptoken_len, flag, vari, total_vari, buffer);
-        AY_CHECK_GOTO(ret, free);
-        ret = ay_pattern_identifier_add(tran, buffer);
-        AY_CHECK_GOTO(ret, free);
-    }
+    int ret;
+    struct ay_qm_token tok;
+
+    ret = ay_qm_token_create(ptoken, ptoken_len, &tok);
+    AY_CHECK_GOTO(ret, clean);
+    ret = ay_pattern_identifier_qm_(&tok, tok.groups_count, buffer, tran);
 
-free:
-    free(flag);
-    free(vari);
+clean:
+    ay_qm_token_clean(&tok);
 
     return ret;
 }
@@ -960,6 +926,9 @@ ay_transl_create_substr(struct ay_transl *tran)
         } else {
             ret = ay_pattern_identifier_vbar(ptoken, len, buffer, tran);
         }
+        if (ret < 0) {
+            goto fail;
+        }
         AY_CHECK_GOTO(ret, clean);
         patt = ptoken + len;
     }
@@ -986,3 +955,977 @@ ay_transl_table_substr_free(struct ay_transl *entry)
     }
     LY_ARRAY_FREE(entry->substr);
 }
+
+/**
+ * @brief Piece of the regex which is processed by ay_regex_minimize().
+ *
+ * The piece is an atom followed by an optional quantifier.
+ */
+struct ay_rpiece {
+    const char *atom;       /**< Text of the atom (character, escaped character or bracket expression). */
+    uint32_t atom_len;      /**< Length of ay_rpiece.atom. */
+    struct ay_rseq *alt;    /**< Branches (LY_ARRAY) if the atom is a group in parentheses, otherwise NULL. */
+    const char *quant;      /**< Quantifier ('*', '+', '?' or '{m,n}') or NULL. */
+    uint32_t quant_len;     /**< Length of ay_rpiece.quant. */
+    char *owned;            /**< Allocated ay_rpiece.atom which was created by merging bracket expressions. */
+};
+
+/**
+ * @brief Branch of the alternation in the regex.
+ */
+struct ay_rseq {
+    struct ay_rpiece *pieces;   /**< Pieces of the branch in LY_ARRAY. */
+};
+
+/**
+ * @brief Buffer for printing the minimized regex.
+ */
+struct ay_rbuf {
+    char *str;      /**< Printed regex. */
+    size_t len;     /**< Length of ay_rbuf.str. */
+    size_t size;    /**< Allocated size of ay_rbuf.str. */
+};
+
+/**
+ * @brief Release the members of @p piece.
+ *
+ * @param[in] piece Piece to clean up.
+ */
+static void
+ay_rpiece_clean(struct ay_rpiece *piece)
+{
+    LY_ARRAY_COUNT_TYPE i, j;
+
+    LY_ARRAY_FOR(piece->alt, i) {
+        LY_ARRAY_FOR(piece->alt[i].pieces, j) {
+            ay_rpiece_clean(&piece->alt[i].pieces[j]);
+        }
+        LY_ARRAY_FREE(piece->alt[i].pieces);
+    }
+    LY_ARRAY_FREE(piece->alt);
+    free(piece->owned);
+}
+
+/**
+ * @brief Release the branch.
+ *
+ * @param[in] seq Branch to clean up.
+ */
+static void
+ay_rseq_clean(struct ay_rseq *seq)
+{
+    LY_ARRAY_COUNT_TYPE i;
+
+    LY_ARRAY_FOR(seq->pieces, i) {
+        ay_rpiece_clean(&seq->pieces[i]);
+    }
+    LY_ARRAY_FREE(seq->pieces);
+}
+
+static int ay_regex_parse_alt(const char **str, struct ay_rseq **alt);
+
+/**
+ * @brief Parse one piece of the regex.
+ *
+ * @param[in,out] str Current position in the regex. It is moved behind the piece.
+ * @param[out] piece Parsed piece.
+ * @return 0 on success, -1 if the regex contains something that the minimization does not support.
+ */
+static int
+ay_regex_parse_piece(const char **str, struct ay_rpiece *piece)
+{
+    int ret;
+    const char *iter, *end;
+
+    memset(piece, 0, sizeof *piece);
+    iter = *str;
+    piece->atom = iter;
+
+    switch (*iter) {
+    case '(':
+        iter++;
+        ret = ay_regex_parse_alt(&iter, &piece->alt);
+        AY_CHECK_RET(ret);
+        AY_CHECK_COND(*iter != ')', -1);
+        iter++;
+        break;
+    case '[':
+        iter++;
+        iter = (*iter == '^') ? iter + 1 : iter;
+        iter = (*iter == ']') ? iter + 1 : iter;
+        while (*iter && (*iter != ']')) {
+            if ((iter[0] == '[') && (iter[1] == ':')) {
+                /* Character class like [:alpha:]. */
+                end = strstr(iter + 2, ":]");
+                AY_CHECK_COND(!end, -1);
+                iter = end + 2;
+            } else {
+                iter++;
+            }
+        }
+        AY_CHECK_COND(!*iter, -1);
+        iter++;
+        break;
+    case '\\':
+        AY_CHECK_COND(!iter[1], -1);
+        iter += 2;
+        break;
+    case '\0':
+    case '|':
+    case ')':
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+    case '^':
+    case '$':
+    case '\r':
+        /* Empty branch, anchors and other unusual constructions are left untouched. */
+        return -1;
+    default:
+        iter++;
+        break;
+    }
+    piece->atom_len = iter - piece->atom;
+
+    if ((*iter == '*') || (*iter == '+') || (*iter == '?')) {
+        piece->quant = iter;
+        piece->quant_len = 1;
+        iter++;
+    } else if (*iter == '{') {
+        for (end = iter + 1; isdigit(*end) || (*end == ','); end++) {}
+        AY_CHECK_COND(*end != '}', -1);
+        piece->quant = iter;
+        piece->quant_len = end + 1 - iter;
+        iter = end + 1;
+    }
+    *str = iter;
+
+    return 0;
+}
+
+/**
+ * @brief Parse one branch of the alternation.
+ *
+ * @param[in,out] str Current position in the regex. It is moved behind the branch.
+ * @param[out] seq Parsed branch.
+ * @return 0 on success, -1 if the branch is empty or not supported.
+ */
+static int
+ay_regex_parse_seq(const char **str, struct ay_rseq *seq)
+{
+    int ret;
+    struct ay_rpiece *piece;
+
+    while (**str && (**str != '|') && (**str != ')')) {
+        LY_ARRAY_NEW_RET(NULL, seq->pieces, piece, AYE_MEMORY);
+        ret = ay_regex_parse_piece(str, piece);
+        AY_CHECK_RET(ret);
+    }
+
+    return LY_ARRAY_COUNT(seq->pieces) ? 0 : -1;
+}
+
+/**
+ * @brief Parse the alternation.
+ *
+ * @param[in,out] str Current position in the regex. It is moved to the terminating ')' or '\0'.
+ * @param[out] alt Parsed branches in LY_ARRAY.
+ * @return 0 on success, -1 if the regex is not supported.
+ */
+static int
+ay_regex_parse_alt(const char **str, struct ay_rseq **alt)
+{
+    int ret;
+    struct ay_rseq *seq;
+
+    while (1) {
+        LY_ARRAY_NEW_RET(NULL, *alt, seq, AYE_MEMORY);
+        seq->pieces = NULL;
+        ret = ay_regex_parse_seq(str, seq);
+        AY_CHECK_RET(ret);
+        if (**str != '|') {
+            break;
+        }
+        (*str)++;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Append string to the buffer.
+ *
+ * @param[in,out] buf Buffer to which it is printed.
+ * @param[in] str String to print.
+ * @param[in] len Length of @p str.
+ * @return 0 on success.
+ */
+static int
+ay_rbuf_add(struct ay_rbuf *buf, const char *str, size_t len)
+{
+    char *mem;
+    size_t size;
+
+    if (buf->len + len + 1 > buf->size) {
+        size = (buf->len + len + 1) * 2;
+        mem = realloc(buf->str, size);
+        AY_CHECK_COND(!mem, AYE_MEMORY);
+        buf->str = mem;
+        buf->size = size;
+    }
+    memcpy(buf->str + buf->len, str, len);
+    buf->len += len;
+    buf->str[buf->len] = '\0';
+
+    return 0;
+}
+
+static int ay_regex_print_alt(struct ay_rbuf *buf, const struct ay_rseq *alt);
+
+/**
+ * @brief Print the piece of the regex.
+ *
+ * @param[in,out] buf Buffer to which it is printed.
+ * @param[in] piece Piece to print.
+ * @return 0 on success.
+ */
+static int
+ay_regex_print_piece(struct ay_rbuf *buf, const struct ay_rpiece *piece)
+{
+    int ret;
+
+    if (piece->alt) {
+        ret = ay_rbuf_add(buf, "(", 1);
+        AY_CHECK_RET(ret);
+        ret = ay_regex_print_alt(buf, piece->alt);
+        AY_CHECK_RET(ret);
+        ret = ay_rbuf_add(buf, ")", 1);
+    } else {
+        ret = ay_rbuf_add(buf, piece->atom, piece->atom_len);
+    }
+    AY_CHECK_RET(ret);
+
+    return piece->quant ? ay_rbuf_add(buf, piece->quant, piece->quant_len) : 0;
+}
+
+/**
+ * @brief Print the alternation.
+ *
+ * @param[in,out] buf Buffer to which it is printed.
+ * @param[in] alt Branches in LY_ARRAY.
+ * @return 0 on success.
+ */
+static int
+ay_regex_print_alt(struct ay_rbuf *buf, const struct ay_rseq *alt)
+{
+    int ret;
+    LY_ARRAY_COUNT_TYPE i, j;
+
+    LY_ARRAY_FOR(alt, i) {
+        if (i) {
+            ret = ay_rbuf_add(buf, "|", 1);
+            AY_CHECK_RET(ret);
+        }
+        LY_ARRAY_FOR(alt[i].pieces, j) {
+            ret = ay_regex_print_piece(buf, &alt[i].pieces[j]);
+            AY_CHECK_RET(ret);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get length of the printed piece.
+ *
+ * @param[in] piece Piece of the regex.
+ * @return Number of characters.
+ */
+static uint64_t
+ay_rpiece_len(const struct ay_rpiece *piece)
+{
+    LY_ARRAY_COUNT_TYPE i, j;
+    uint64_t len;
+
+    len = piece->quant_len;
+    if (!piece->alt) {
+        return len + piece->atom_len;
+    }
+
+    len += 2 + LY_ARRAY_COUNT(piece->alt) - 1;
+    LY_ARRAY_FOR(piece->alt, i) {
+        LY_ARRAY_FOR(piece->alt[i].pieces, j) {
+            len += ay_rpiece_len(&piece->alt[i].pieces[j]);
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief Check if two pieces are the same.
+ *
+ * @param[in] p1 First piece.
+ * @param[in] p2 Second piece.
+ * @return 1 if they are printed the same.
+ */
+static ly_bool
+ay_rpiece_equal(const struct ay_rpiece *p1, const struct ay_rpiece *p2)
+{
+    LY_ARRAY_COUNT_TYPE i, j;
+
+    if ((!p1->alt != !p2->alt) || (p1->quant_len != p2->quant_len) ||
+            (p1->quant_len && strncmp(p1->quant, p2->quant, p1->quant_len))) {
+        return 0;
+    } else if (!p1->alt) {
+        return (p1->atom_len == p2->atom_len) && !strncmp(p1->atom, p2->atom, p1->atom_len);
+    } else if (LY_ARRAY_COUNT(p1->alt) != LY_ARRAY_COUNT(p2->alt)) {
+        return 0;
+    }
+
+    LY_ARRAY_FOR(p1->alt, i) {
+        if (LY_ARRAY_COUNT(p1->alt[i].pieces) != LY_ARRAY_COUNT(p2->alt[i].pieces)) {
+            return 0;
+        }
+        LY_ARRAY_FOR(p1->alt[i].pieces, j) {
+            if (!ay_rpiece_equal(&p1->alt[i].pieces[j], &p2->alt[i].pieces[j])) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Replace the group at @p idx in @p seq by the pieces of its only branch.
+ *
+ * @param[in,out] seq Branch containing the group.
+ * @param[in] idx Index of the group piece without quantifier.
+ * @return 0 on success.
+ */
+static int
+ay_rseq_splice(struct ay_rseq *seq, LY_ARRAY_COUNT_TYPE idx)
+{
+    LY_ARRAY_COUNT_TYPE i;
+    struct ay_rpiece *pieces = NULL, *inner;
+
+    inner = seq->pieces[idx].alt[0].pieces;
+    LY_ARRAY_CREATE_RET(NULL, pieces, LY_ARRAY_COUNT(seq->pieces) + LY_ARRAY_COUNT(inner) - 1, AYE_MEMORY);
+    LY_ARRAY_FOR(seq->pieces, i) {
+        if (i != idx) {
+            pieces[LY_ARRAY_COUNT(pieces)] = seq->pieces[i];
+            LY_ARRAY_INCREMENT(pieces);
+            continue;
+        }
+        memcpy(pieces + LY_ARRAY_COUNT(pieces), inner, LY_ARRAY_COUNT(inner) * sizeof *inner);
+        AY_SET_LY_ARRAY_SIZE(pieces, LY_ARRAY_COUNT(pieces) + LY_ARRAY_COUNT(inner));
+    }
+
+    LY_ARRAY_FREE(inner);
+    LY_ARRAY_FREE(seq->pieces[idx].alt);
+    LY_ARRAY_FREE(seq->pieces);
+    seq->pieces = pieces;
+
+    return 0;
+}
+
+/**
+ * @brief Remove the group at @p idx in @p seq if it is unnecessary.
+ *
+ * Examples: a(bc)d -> abcd, (a)* -> a*, ([0-9])+ -> [0-9]+
+ *
+ * @param[in,out] seq Branch containing the piece.
+ * @param[in] idx Index of the piece.
+ * @param[out] added Number of pieces which were added to the @p seq.
+ * @return 0 on success.
+ */
+static int
+ay_rseq_flatten_piece(struct ay_rseq *seq, LY_ARRAY_COUNT_TYPE idx, uint64_t *added)
+{
+    struct ay_rpiece *piece, *inner, tmp;
+
+    *added = 0;
+    piece = &seq->pieces[idx];
+    if (!piece->alt || (LY_ARRAY_COUNT(piece->alt) != 1)) {
+        return 0;
+    }
+
+    inner = piece->alt[0].pieces;
+    if (!piece->quant) {
+        *added = LY_ARRAY_COUNT(inner) - 1;
+        return ay_rseq_splice(seq, idx);
+    } else if ((LY_ARRAY_COUNT(inner) == 1) && !inner->quant) {
+        tmp = *inner;
+        tmp.quant = piece->quant;
+        tmp.quant_len = piece->quant_len;
+        LY_ARRAY_FREE(inner);
+        LY_ARRAY_FREE(piece->alt);
+        *piece = tmp;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the content of bracket expression to which the @p piece can be merged.
+ *
+ * @param[in] piece Piece of the regex.
+ * @param[out] len Length of the content.
+ * @return Content of bracket expression or NULL if @p piece cannot be merged.
+ */
+static const char *
+ay_rpiece_class_content(const struct ay_rpiece *piece, uint64_t *len)
+{
+    const char *atom;
+    uint64_t i;
+
+    atom = piece->atom;
+    if (piece->alt || piece->quant) {
+        return NULL;
+    } else if ((piece->atom_len == 1) && (isalnum(atom[0]) || strchr("_/@#%,<>!&;~ ", atom[0]))) {
+        *len = 1;
+        return atom;
+    } else if ((piece->atom_len == 2) && (atom[0] == '\\') && strchr("+*?(){}|", atom[1])) {
+        *len = 1;
+        return atom + 1;
+    } else if ((atom[0] != '[') || (piece->atom_len < 3)) {
+        return NULL;
+    }
+
+    /* Only simple bracket expression whose content can be moved anywhere. */
+    *len = piece->atom_len - 2;
+    atom++;
+    if ((atom[0] == '^') || (atom[0] == ']') || (atom[0] == '-') || (atom[*len - 1] == '-')) {
+        return NULL;
+    }
+    for (i = 0; i < *len; i++) {
+        if ((atom[i] == '\\') || (atom[i] == '[')) {
+            return NULL;
+        }
+    }
+
+    return atom;
+}
+
+/**
+ * @brief Merge branches consisting of a single character into one bracket expression.
+ *
+ * Example: a|[0-9]|_ -> [a0-9_]
+ *
+ * @param[in,out] alt Branches in LY_ARRAY.
+ * @return 0 on success.
+ */
+static int
+ay_ralt_merge_classes(struct ay_rseq *alt)
+{
+    int ret;
+    LY_ARRAY_COUNT_TYPE i, first, cnt;
+    const char *content;
+    uint64_t len;
+    struct ay_rbuf buf = {0};
+    struct ay_rpiece *piece;
+
+    cnt = 0;
+    first = 0;
+    LY_ARRAY_FOR(alt, i) {
+        if ((LY_ARRAY_COUNT(alt[i].pieces) == 1) && ay_rpiece_class_content(alt[i].pieces, &len)) {
+            first = cnt ? first : i;
+            cnt++;
+        }
+    }
+    if (cnt < 2) {
+        return 0;
+    }
+
+    ret = ay_rbuf_add(&buf, "[", 1);
+    for (i = first; !ret && (i < LY_ARRAY_COUNT(alt)); i++) {
+        if ((LY_ARRAY_COUNT(alt[i].pieces) == 1) && (content = ay_rpiece_class_content(alt[i].pieces, &len))) {
+            ret = ay_rbuf_add(&buf, content, len);
+        }
+    }
+    ret = ret ? ret : ay_rbuf_add(&buf, "]", 1);
+    if (ret) {
+        free(buf.str);
+        return ret;
+    }
+
+    /* Replace the first branch by the merged one and remove the others. */
+    for (i = LY_ARRAY_COUNT(alt); i > first + 1; i--) {
+        if ((LY_ARRAY_COUNT(alt[i - 1].pieces) == 1) && ay_rpiece_class_content(alt[i - 1].pieces, &len)) {
+            ay_rseq_clean(&alt[i - 1]);
+            memmove(&alt[i - 1], &alt[i], (LY_ARRAY_COUNT(alt) - i) * sizeof *alt);
+            LY_ARRAY_DECREMENT(alt);
+        }
+    }
+    piece = alt[first].pieces;
+    free(piece->owned);
+    piece->owned = buf.str;
+    piece->atom = buf.str;
+    piece->atom_len = buf.len;
+
+    return 0;
+}
+
+static int ay_ralt_minimize(struct ay_rseq **alt);
+
+/**
+ * @brief Factor out the common prefix of branches.
+ *
+ * Branches with the same first piece are joined. Example: abcx|abcy|d -> abc(x|y)|d, ab|abc -> abc?
+ * The order of branches may change, but the YANG pattern must always match the whole string, so the language
+ * remains the same.
+ *
+ * @param[in,out] alt Branches in LY_ARRAY.
+ * @return 0 on success.
+ */
+static int
+ay_ralt_factor_prefix(struct ay_rseq **alt)
+{
+    int ret = 0;
+    LY_ARRAY_COUNT_TYPE i, j, k, members, prefix, tails;
+    uint64_t prefix_len, saving, cost, added;
+    ly_bool has_empty, bare;
+    struct ay_rseq *old, *new = NULL, *seq, *inner;
+    struct ay_rpiece *group;
+    uint8_t *used = NULL;
+
+    old = *alt;
+    used = calloc(LY_ARRAY_COUNT(old), sizeof *used);
+    AY_CHECK_COND(!used, AYE_MEMORY);
+    LY_ARRAY_CREATE_GOTO(NULL, new, LY_ARRAY_COUNT(old), ret, cleanup);
+
+    LY_ARRAY_FOR(old, i) {
+        if (used[i]) {
+            continue;
+        }
+
+        /* Find branches with the same first piece and their common prefix. */
+        members = 0;
+        prefix = LY_ARRAY_COUNT(old[i].pieces);
+        for (j = i; j < LY_ARRAY_COUNT(old); j++) {
+            if (used[j] || !ay_rpiece_equal(old[i].pieces, old[j].pieces)) {
+                continue;
+            }
+            members++;
+            for (k = 1; (k < prefix) && (k < LY_ARRAY_COUNT(old[j].pieces)) &&
+                    ay_rpiece_equal(&old[i].pieces[k], &old[j].pieces[k]); k++) {}
+            prefix = k;
+        }
+
+        tails = 0;
+        has_empty = 0;
+        bare = 0;
+        for (j = i; j < LY_ARRAY_COUNT(old); j++) {
+            if (!used[j] && ay_rpiece_equal(old[i].pieces, old[j].pieces)) {
+                has_empty = LY_ARRAY_COUNT(old[j].pieces) == prefix ? 1 : has_empty;
+                tails += LY_ARRAY_COUNT(old[j].pieces) > prefix ? 1 : 0;
+                bare = (LY_ARRAY_COUNT(old[j].pieces) == prefix + 1) && !old[j].pieces[prefix].quant ? 1 : bare;
+            }
+        }
+        for (prefix_len = 0, k = 0; k < prefix; k++) {
+            prefix_len += ay_rpiece_len(&old[i].pieces[k]);
+        }
+
+        /* Each removed prefix saves also the '|' character. The tails are separated by '|' and if there is more
+         * than one piece, then they are in parentheses. The '?' quantifier is added if some tail is empty. */
+        saving = (members - 1) * (prefix_len + 1);
+        cost = tails ? tails - 1 + ((tails == 1) && bare ? 0 : 2) + has_empty : 0;
+        seq = &new[LY_ARRAY_COUNT(new)];
+        if ((members == 1) || (saving <= cost)) {
+            /* Factoring does not pay off. */
+            *seq = old[i];
+            LY_ARRAY_INCREMENT(new);
+            used[i] = 1;
+            continue;
+        }
+
+        /* The branch 'i' keeps the prefix, the tails of all members are moved to the new group. */
+        inner = NULL;
+        if (tails) {
+            LY_ARRAY_CREATE_GOTO(NULL, inner, tails, ret, cleanup);
+        }
+        for (j = i; j < LY_ARRAY_COUNT(old); j++) {
+            if (used[j] || !ay_rpiece_equal(old[i].pieces, old[j].pieces)) {
+                continue;
+            }
+            used[j] = 1;
+            if (LY_ARRAY_COUNT(old[j].pieces) > prefix) {
+                inner[LY_ARRAY_COUNT(inner)].pieces = NULL;
+                LY_ARRAY_CREATE_GOTO(NULL, inner[LY_ARRAY_COUNT(inner)].pieces,
+                        LY_ARRAY_COUNT(old[j].pieces) - prefix, ret, cleanup);
+                memcpy(inner[LY_ARRAY_COUNT(inner)].pieces, old[j].pieces + prefix,
+                        (LY_ARRAY_COUNT(old[j].pieces) - prefix) * sizeof *old[j].pieces);
+                AY_SET_LY_ARRAY_SIZE(inner[LY_ARRAY_COUNT(inner)].pieces, LY_ARRAY_COUNT(old[j].pieces) - prefix);
+                LY_ARRAY_INCREMENT(inner);
+            }
+            /* The tail is moved, the prefix is kept only in the branch 'i'. */
+            AY_SET_LY_ARRAY_SIZE(old[j].pieces, prefix);
+            if (j != i) {
+                ay_rseq_clean(&old[j]);
+                old[j].pieces = NULL;
+            }
+        }
+        *seq = old[i];
+        old[i].pieces = NULL;
+        LY_ARRAY_INCREMENT(new);
+        if (!inner) {
+            /* Only duplicate branches. */
+            continue;
+        }
+
+        LY_ARRAY_NEW_GOTO(NULL, seq->pieces, group, ret, cleanup);
+        memset(group, 0, sizeof *group);
+        group->alt = inner;
+        group->quant = has_empty ? "?" : NULL;
+        group->quant_len = has_empty ? 1 : 0;
+        ret = ay_ralt_minimize(&group->alt);
+        AY_CHECK_GOTO(ret, cleanup);
+        ret = ay_rseq_flatten_piece(seq, LY_ARRAY_COUNT(seq->pieces) - 1, &added);
+        AY_CHECK_GOTO(ret, cleanup);
+    }
+
+    LY_ARRAY_FREE(old);
+    *alt = new;
+    new = NULL;
+
+cleanup:
+    if (new) {
+        /* Branches moved to 'new' are no longer in 'old'. */
+        LY_ARRAY_FOR(new, i) {
+            ay_rseq_clean(&new[i]);
+        }
+        LY_ARRAY_FOR(old, i) {
+            if (used[i]) {
+                old[i].pieces = NULL;
+            }
+        }
+        LY_ARRAY_FREE(new);
+    }
+    free(used);
+
+    return ret;
+}
+
+/**
+ * @brief Minimize the alternation and all its nested groups.
+ *
+ * @param[in,out] alt Branches in LY_ARRAY.
+ * @return 0 on success.
+ */
+static int
+ay_ralt_minimize(struct ay_rseq **alt)
+{
+    int ret;
+    LY_ARRAY_COUNT_TYPE i, j, cnt;
+    uint64_t added;
+    struct ay_rseq *new = NULL, *inner;
+
+    /* Minimize nested groups and remove unnecessary ones. */
+    LY_ARRAY_FOR(*alt, i) {
+        for (j = 0; j < LY_ARRAY_COUNT((*alt)[i].pieces); j++) {
+            if (!(*alt)[i].pieces[j].alt) {
+                continue;
+            }
+            ret = ay_ralt_minimize(&(*alt)[i].pieces[j].alt);
+            AY_CHECK_RET(ret);
+            ret = ay_rseq_flatten_piece(&(*alt)[i], j, &added);
+            AY_CHECK_RET(ret);
+            j += added;
+        }
+    }
+
+    /* Branches consisting of a group only are moved to this alternation. Example: a|(b|c) -> a|b|c */
+    cnt = 0;
+    LY_ARRAY_FOR(*alt, i) {
+        inner = (*alt)[i].pieces->alt;
+        cnt += ((LY_ARRAY_COUNT((*alt)[i].pieces) == 1) && inner && !(*alt)[i].pieces->quant) ?
+                LY_ARRAY_COUNT(inner) : 1;
+    }
+    if (cnt != LY_ARRAY_COUNT(*alt)) {
+        LY_ARRAY_CREATE_RET(NULL, new, cnt, AYE_MEMORY);
+        LY_ARRAY_FOR(*alt, i) {
+            inner = (*alt)[i].pieces->alt;
+            if ((LY_ARRAY_COUNT((*alt)[i].pieces) == 1) && inner && !(*alt)[i].pieces->quant) {
+                memcpy(new + LY_ARRAY_COUNT(new), inner, LY_ARRAY_COUNT(inner) * sizeof *inner);
+                AY_SET_LY_ARRAY_SIZE(new, LY_ARRAY_COUNT(new) + LY_ARRAY_COUNT(inner));
+                LY_ARRAY_FREE(inner);
+                LY_ARRAY_FREE((*alt)[i].pieces);
+            } else {
+                new[LY_ARRAY_COUNT(new)] = (*alt)[i];
+                LY_ARRAY_INCREMENT(new);
+            }
+        }
+        LY_ARRAY_FREE(*alt);
+        *alt = new;
+    }
+
+    ret = ay_ralt_factor_prefix(alt);
+    AY_CHECK_RET(ret);
+
+    return ay_ralt_merge_classes(*alt);
+}
+
+int
+ay_regex_minimize(const char *regex, char **min)
+{
+    int ret;
+    const char *iter;
+    LY_ARRAY_COUNT_TYPE i;
+    struct ay_rseq *alt = NULL;
+    struct ay_rbuf buf = {0};
+
+    *min = NULL;
+    iter = regex;
+    ret = ay_regex_parse_alt(&iter, &alt);
+    if ((ret < 0) || (!ret && *iter)) {
+        /* The regex is not supported, it remains as it is. */
+        ret = 0;
+        goto cleanup;
+    }
+    AY_CHECK_GOTO(ret, cleanup);
+
+    ret = ay_ralt_minimize(&alt);
+    AY_CHECK_GOTO(ret, cleanup);
+    ret = ay_regex_print_alt(&buf, alt);
+    AY_CHECK_GOTO(ret, cleanup);
+
+    if (buf.len < strlen(regex)) {
+        *min = buf.str;
+        buf.str = NULL;
+    }
+
+cleanup:
+    LY_ARRAY_FOR(alt, i) {
+        ay_rseq_clean(&alt[i]);
+    }
+    LY_ARRAY_FREE(alt);
+    free(buf.str);
+
+    return ret;
+}
+
+/**
+ * @brief Release the set of literals.
+ *
+ * @param[in] set Literals in LY_ARRAY.
+ */
+static void
+ay_literals_free(char **set)
+{
+    LY_ARRAY_COUNT_TYPE i;
+
+    LY_ARRAY_FOR(set, i) {
+        free(set[i]);
+    }
+    LY_ARRAY_FREE(set);
+}
+
+/**
+ * @brief Append a literal to the set.
+ *
+ * @param[in,out] set Literals in LY_ARRAY.
+ * @param[in] str1 First part of the literal.
+ * @param[in] str2 Second part of the literal.
+ * @param[in] len2 Length of @p str2.
+ * @param[in] max Maximum number of literals.
+ * @return 0 on success, -1 if there are too many literals.
+ */
+static int
+ay_literals_add(char ***set, const char *str1, const char *str2, uint64_t len2, uint32_t max)
+{
+    char *lit;
+    uint64_t len1;
+
+    AY_CHECK_COND(LY_ARRAY_COUNT(*set) >= max, -1);
+
+    len1 = strlen(str1);
+    lit = malloc(len1 + len2 + 1);
+    AY_CHECK_COND(!lit, AYE_MEMORY);
+    memcpy(lit, str1, len1);
+    memcpy(lit + len1, str2, len2);
+    lit[len1 + len2] = '\0';
+
+    LY_ARRAY_CREATE(NULL, *set, 1, free(lit); return AYE_MEMORY);
+    (*set)[LY_ARRAY_COUNT(*set)] = lit;
+    LY_ARRAY_INCREMENT(*set);
+
+    return 0;
+}
+
+static int ay_regex_literals_alt(const struct ay_rseq *alt, uint32_t max, char ***set);
+
+/**
+ * @brief Get all strings which can be matched by the @p piece.
+ *
+ * @param[in] piece Piece of the regex.
+ * @param[in] max Maximum number of literals.
+ * @param[out] set Literals in LY_ARRAY.
+ * @return 0 on success, -1 if the language of the @p piece is not a small finite set.
+ */
+static int
+ay_regex_literals_piece(const struct ay_rpiece *piece, uint32_t max, char ***set)
+{
+    int ret = 0;
+    uint32_t i;
+    const char *atom;
+
+    atom = piece->atom;
+    if (piece->quant && ((piece->quant_len != 1) || (piece->quant[0] != '?'))) {
+        return -1;
+    } else if (piece->alt) {
+        ret = ay_regex_literals_alt(piece->alt, max, set);
+    } else if (atom[0] == '[') {
+        /* Only enumeration of characters like [Dd]. */
+        AY_CHECK_COND((piece->atom_len < 3) || (atom[1] == '^') || (atom[1] == ']'), -1);
+        for (i = 1; !ret && (i < piece->atom_len - 1); i++) {
+            AY_CHECK_COND((atom[i] == '-') || (atom[i] == '\\') || (atom[i] == '['), -1);
+            ret = ay_literals_add(set, "", &atom[i], 1, max);
+        }
+    } else if (atom[0] == '\\') {
+        AY_CHECK_COND(isalnum(atom[1]), -1);
+        ret = ay_literals_add(set, "", &atom[1], 1, max);
+    } else {
+        AY_CHECK_COND(atom[0] == '.', -1);
+        ret = ay_literals_add(set, "", atom, 1, max);
+    }
+    AY_CHECK_RET(ret);
+
+    if (piece->quant) {
+        /* Quantifier '?'. */
+        ret = ay_literals_add(set, "", "", 0, max);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get all strings which can be matched by the sequence of pieces.
+ *
+ * @param[in] seq Branch of the regex.
+ * @param[in] max Maximum number of literals.
+ * @param[out] set Literals in LY_ARRAY.
+ * @return 0 on success, -1 if the language of the @p seq is not a small finite set.
+ */
+static int
+ay_regex_literals_seq(const struct ay_rseq *seq, uint32_t max, char ***set)
+{
+    int ret = 0;
+    LY_ARRAY_COUNT_TYPE i, j, k;
+    char **prefixes = NULL, **suffixes = NULL, **product;
+
+    ret = ay_literals_add(&prefixes, "", "", 0, max);
+    LY_ARRAY_FOR(seq->pieces, i) {
+        AY_CHECK_GOTO(ret, cleanup);
+        ret = ay_regex_literals_piece(&seq->pieces[i], max, &suffixes);
+        AY_CHECK_GOTO(ret, cleanup);
+
+        /* Cartesian product of prefixes and suffixes. */
+        product = NULL;
+        for (j = 0; !ret && (j < LY_ARRAY_COUNT(prefixes)); j++) {
+            for (k = 0; !ret && (k < LY_ARRAY_COUNT(suffixes)); k++) {
+                ret = ay_literals_add(&product, prefixes[j], suffixes[k], strlen(suffixes[k]), max);
+            }
+        }
+        ay_literals_free(prefixes);
+        ay_literals_free(suffixes);
+        prefixes = product;
+        suffixes = NULL;
+    }
+    AY_CHECK_GOTO(ret, cleanup);
+
+    for (i = 0; !ret && (i < LY_ARRAY_COUNT(prefixes)); i++) {
+        ret = ay_literals_add(set, "", prefixes[i], strlen(prefixes[i]), max);
+    }
+
+cleanup:
+    ay_literals_free(prefixes);
+    ay_literals_free(suffixes);
+
+    return ret;
+}
+
+/**
+ * @brief Get all strings which can be matched by the alternation.
+ *
+ * @param[in] alt Branches of the regex.
+ * @param[in] max Maximum number of literals.
+ * @param[out] set Literals in LY_ARRAY.
+ * @return 0 on success, -1 if the language of the @p alt is not a small finite set.
+ */
+static int
+ay_regex_literals_alt(const struct ay_rseq *alt, uint32_t max, char ***set)
+{
+    int ret;
+    LY_ARRAY_COUNT_TYPE i;
+
+    LY_ARRAY_FOR(alt, i) {
+        ret = ay_regex_literals_seq(&alt[i], max, set);
+        AY_CHECK_RET(ret);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Compare two literals for qsort().
+ *
+ * @param[in] lit1 First literal.
+ * @param[in] lit2 Second literal.
+ * @return Result of strcmp().
+ */
+static int
+ay_literals_cmp(const void *lit1, const void *lit2)
+{
+    return strcmp(*(const char **)lit1, *(const char **)lit2);
+}
+
+int
+ay_regex_literals(const char *regex, uint32_t max, char ***literals)
+{
+    int ret;
+    const char *iter;
+    LY_ARRAY_COUNT_TYPE i, j;
+    struct ay_rseq *alt = NULL;
+    char **set = NULL;
+
+    *literals = NULL;
+    iter = regex;
+    ret = ay_regex_parse_alt(&iter, &alt);
+    if (!ret && !*iter) {
+        ret = ay_regex_literals_alt(alt, max, &set);
+    } else if (!ret) {
+        ret = -1;
+    }
+
+    LY_ARRAY_FOR(alt, i) {
+        ay_rseq_clean(&alt[i]);
+    }
+    LY_ARRAY_FREE(alt);
+
+    if (ret) {
+        ay_literals_free(set);
+        return ret < 0 ? 0 : ret;
+    }
+
+    /* Sort literals and remove duplicates. */
+    qsort(set, LY_ARRAY_COUNT(set), sizeof *set, ay_literals_cmp);
+    for (i = 0, j = 1; j < LY_ARRAY_COUNT(set); j++) {
+        if (!strcmp(set[i], set[j])) {
+            free(set[j]);
+        } else {
+            set[++i] = set[j];
+        }
+    }
+    AY_SET_LY_ARRAY_SIZE(set, i + 1);
+    *literals = set;
+
+    return 0;
+}
+
+void
+ay_regex_literals_free(char **literals)
+{
+    ay_literals_free(literals);
+}
@@ -47,3 +47,37 @@ int ay_transl_create_substr(struct ay_transl *tran);
  * @param[in] entry Record from translation table.
  */
 void ay_transl_table_substr_free(struct ay_transl *entry);
+
+/**
+ * @brief Minimize the regex so that the printed YANG pattern is shorter.
+ *
+ * Common prefixes of alternatives are factored out, unnecessary groups are removed and alternatives consisting
+ * of single characters are merged into one bracket expression. The language of the regex is preserved.
+ * Regexes with constructions which are not supported (for example anchors or empty alternatives) are left intact.
+ *
+ * @param[in] regex Augeas regex to minimize.
+ * @param[out] min Minimized regex which must be freed by the caller. It is set to NULL if the regex
+ * could not be shortened.
+ * @return 0 on success.
+ */
+int ay_regex_minimize(const char *regex, char **min);
+
+/**
+ * @brief Get all strings matched by the regex if there are only a few of them.
+ *
+ * For example, from the regex "(no)?auth|[Dd]ebug" the literals "Debug", "auth", "debug", "noauth" are obtained.
+ *
+ * @param[in] regex Augeas regex.
+ * @param[in] max Maximum number of literals.
+ * @param[out] literals Sorted literals without duplicates (LY_ARRAY). Call ay_regex_literals_free() after use.
+ * It is set to NULL if the regex matches more than @p max strings or its language is not finite.
+ * @return 0 on success.
+ */
+int ay_regex_literals(const char *regex, uint32_t max, char ***literals);
+
+/**
+ * @brief Release literals obtained by ay_regex_literals().
+ *
+ * @param[in] literals Literals to free.
+ */
+void ay_regex_literals_free(char **literals);
@@ -17,6 +17,7 @@
 #define _GNU_SOURCE
 
 #include <ctype.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <libyang/libyang.h>
@@ -24,6 +25,7 @@
 #include "augyang.h"
 #include "common.h"
 #include "lens.h"
+#include "parse_regex.h"
 #include "print_yang.h"
 #include "terms.h"
 
@@ -32,6 +34,21 @@
  */
 #define AY_EXT_PREFIX "augex"
 
+/**
+ * @brief Name of the yang module which contains typedefs shared by the generated yang modules.
+ */
+#define AY_TYPES_MODULE "augeas-types"
+
+/**
+ * @brief Prefix of the imported AY_TYPES_MODULE.
+ */
+#define AY_TYPES_PREFIX "augt"
+
+/**
+ * @brief Augeas modules whose regular expressions are printed as typedefs in the AY_TYPES_MODULE.
+ */
+static const char * const ay_shared_modules[] = {"Rx", "Util", "Sep", "Quote", "Build", NULL};
+
 /**
  * @brief Extension name for showing the path in the augeas data tree.
  */
@@ -42,6 +59,23 @@
  */
 #define AY_EXT_VALPATH "value-yang-path"
 
+/**
+ * @brief Extension name for the list of all labels which can be matched by the node with data-path "$$".
+ */
+#define AY_EXT_LITERALS "label-literals"
+
+/**
+ * @brief Maximum number of literals in the AY_EXT_LITERALS extension.
+ */
+#define AY_EXT_LITERALS_MAX 64
+
+/**
+ * @brief Extension names for the lens autoloaded by the augeas module and the include and exclude globs of its filter.
+ */
+#define AY_EXT_AUTOLOAD_LENS "autoload-lens"
+#define AY_EXT_AUTOLOAD_INCL "autoload-incl"
+#define AY_EXT_AUTOLOAD_EXCL "autoload-excl"
+
 /**
  * @brief Specification where the identifier should be placed.
  */
@@ -307,7 +341,7 @@ ay_ynode_get_substr_from_transl_table(const struct ay_ynode *tree, const struct
     /* find out which identifier index to look for in the pattern */
     node_idx = ay_ynode_splitted_seq_index(node);
 
-    tran = ay_transl_find(table, pattern);
+    tran = ay_transl_find(table, AY_YNODE_ROOT_PATT_INDEX(tree), pattern);
     assert(tran && (node_idx < LY_ARRAY_COUNT(tran->substr)));
     substr = tran->substr[node_idx];
 
@@ -943,14 +977,16 @@ ay_print_string_standardized(struct ly_out *out, const char *str)
  * Conversion probably doesn't work in all cases.
  *
  * @param[in,out] out Output handler for printing.
+ * @param[in] options Options of printing. If AYO_REGEX_MIN is set, the regex is minimized before printing.
  * @param[in] patt Regex pattern to print.
  * @return 0 on success.
  */
 static int
-ay_print_regex_standardized(struct ly_out *out, const char *patt)
+ay_print_regex_standardized(struct ly_out *out, uint64_t options, const char *patt)
 {
+    int ret;
     const char *ch, *skip;
-    char *mem, *src;
+    char *mem, *src, *min = NULL;
     ly_bool charClassExpr, charClassEmpty;
 
     if (!patt || (*patt == '\0')) {
@@ -967,6 +1003,15 @@ ay_print_regex_standardized(struct ly_out *out, const char *patt)
     /* remove () around pattern  */
     ay_regex_remove_parentheses(&src);
 
+    if (options & AYO_REGEX_MIN) {
+        ret = ay_regex_minimize(src, &min);
+        if (ret) {
+            free(mem);
+            return ret;
+        }
+        src = min ? min : src;
+    }
+
     charClassExpr = 0;
     charClassEmpty = 0;
 
@@ -1073,6 +1118,7 @@ ay_print_regex_standardized(struct ly_out *out, const char *patt)
         charClassEmpty = 0;
     }
 
+    free(min);
     free(mem);
 
     return 0;
@@ -1257,7 +1303,7 @@ ay_get_yang_ident(struct yprinter_ctx *ctx, struct ay_ynode *node, enum ay_ident
         ay_get_yang_ident(ctx, node->child, opt, buffer);
         str = buffer;
     } else if (node->type == YN_VALUE) {
-        if (!ay_dnode_find(AY_YNODE_ROOT_VALUES(ctx->tree), node->value) &&
+        if (!ay_dnode_find(AY_YNODE_ROOT_VALUES(ctx->tree), AY_YNODE_ROOT_VALUES_INDEX(ctx->tree), node->value) &&
                 (tmp = ay_get_lense_name(ctx->mod, node->value))) {
             str = tmp;
         } else {
@@ -1373,72 +1419,279 @@ ay_yang_ident_iter(struct ay_ynode *root, struct ay_ynode *iter)
     return ret;
 }
 
+/**
+ * @brief Get length of the identifier without the numeric suffix.
+ *
+ * @param[in] ident Identifier to examine.
+ * @return Length of the base of @p ident.
+ */
+static uint16_t
+ay_ident_base_len(const char *ident)
+{
+    size_t len;
+
+    for (len = strlen(ident); len && isdigit(ident[len - 1]); len--) {}
+
+    return len;
+}
+
+/**
+ * @brief Compare occurrence in the identifier table with the key.
+ *
+ * @param[in] occ Occurrence from the table.
+ * @param[in] scope Scope of the key.
+ * @param[in] kind Kind of the key (AY_IDENT_OCCUR_*).
+ * @param[in] base Base of the identifier. Not terminated by '\0'.
+ * @param[in] base_len Length of @p base.
+ * @return Negative, zero or positive number like strcmp().
+ */
+static int
+ay_ident_occur_keycmp(const struct ay_ident_occur *occ, const struct ay_ynode *scope, uint8_t kind,
+        const char *base, uint16_t base_len)
+{
+    if (occ->scope != scope) {
+        return occ->scope < scope ? -1 : 1;
+    } else if (occ->kind != kind) {
+        return occ->kind < kind ? -1 : 1;
+    } else if (occ->base_len != base_len) {
+        return occ->base_len < base_len ? -1 : 1;
+    } else {
+        return memcmp(occ->node->ident, base, base_len);
+    }
+}
+
+/**
+ * @brief Comparison callback for qsort() which orders the identifier table.
+ *
+ * @param[in] occ1 First occurrence.
+ * @param[in] occ2 Second occurrence.
+ * @return Negative, zero or positive number like strcmp().
+ */
+static int
+ay_ident_occur_cmp(const void *occ1, const void *occ2)
+{
+    const struct ay_ident_occur *o1 = occ1, *o2 = occ2;
+    int ret;
+
+    ret = ay_ident_occur_keycmp(o1, o2->scope, o2->kind, o2->node->ident, o2->base_len);
+    if (ret) {
+        return ret;
+    }
+
+    return o1->pos < o2->pos ? -1 : o1->pos > o2->pos;
+}
+
+/**
+ * @brief Find block of occurrences with the same key in the identifier table.
+ *
+ * @param[in] table Identifier table.
+ * @param[in] scope Scope of the key.
+ * @param[in] kind Kind of the key (AY_IDENT_OCCUR_*).
+ * @param[in] base Base of the identifier. Not terminated by '\0'.
+ * @param[in] base_len Length of @p base.
+ * @param[out] end Index behind the last occurrence in the block.
+ * @return Index of the first occurrence in the block. If it is equal to @p end, then the key was not found.
+ */
+static LY_ARRAY_COUNT_TYPE
+ay_ident_table_find(const struct ay_ident_occur *table, const struct ay_ynode *scope, uint8_t kind,
+        const char *base, uint16_t base_len, LY_ARRAY_COUNT_TYPE *end)
+{
+    LY_ARRAY_COUNT_TYPE low, high, mid;
+
+    low = 0;
+    high = LY_ARRAY_COUNT(table);
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (ay_ident_occur_keycmp(&table[mid], scope, kind, base, base_len) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    for (*end = low; (*end < LY_ARRAY_COUNT(table)) &&
+            !ay_ident_occur_keycmp(&table[*end], scope, kind, base, base_len); (*end)++) {}
+
+    return low;
+}
+
 int
-ay_yang_ident_duplications(struct ay_ynode *tree, struct ay_ynode *node, char *node_ident, int64_t *dupl_rank,
-        uint64_t *dupl_count)
+ay_ident_table_create(struct ay_ynode *tree, struct ay_ident_occur **table)
 {
-    int ret = 0;
-    struct ay_ynode *iter, *root, *gr;
+    LY_ARRAY_COUNT_TYPE i;
+    struct ay_ynode *scope, *iter;
+    struct ay_ident_occur *occ;
+
+    *table = NULL;
+
+    /* Every node is in at most one scope, only YN_USES nodes are stored twice. */
+    LY_ARRAY_CREATE_RET(NULL, *table, 2 * LY_ARRAY_COUNT(tree), AYE_MEMORY);
+    LY_ARRAY_FOR(tree, i) {
+        scope = &tree[i];
+        if ((scope->type == YN_CASE) || !scope->child) {
+            continue;
+        }
+        for (iter = ay_yang_ident_iter(scope, NULL); iter; iter = ay_yang_ident_iter(scope, iter)) {
+            if ((iter->type == YN_KEY) || (iter->type == YN_LEAFREF) || !iter->ident) {
+                continue;
+            }
+            if (iter->type == YN_USES) {
+                occ = &(*table)[LY_ARRAY_COUNT(*table)];
+                occ->scope = scope;
+                occ->node = iter;
+                occ->pos = iter - tree;
+                occ->base_len = 0;
+                occ->kind = AY_IDENT_OCCUR_USES;
+                LY_ARRAY_INCREMENT(*table);
+            }
+            occ = &(*table)[LY_ARRAY_COUNT(*table)];
+            occ->scope = scope;
+            occ->node = iter;
+            occ->pos = iter - tree;
+            occ->base_len = ay_ident_base_len(iter->ident);
+            occ->kind = AY_IDENT_OCCUR_NAME;
+            LY_ARRAY_INCREMENT(*table);
+        }
+    }
+
+    qsort(*table, LY_ARRAY_COUNT(*table), sizeof **table, ay_ident_occur_cmp);
+
+    return 0;
+}
+
+void
+ay_ident_table_free(struct ay_ident_occur *table)
+{
+    LY_ARRAY_FREE(table);
+}
+
+/**
+ * @brief Detect duplicates for the identifier in the @p scope.
+ *
+ * Only YN_USES nodes and nodes whose identifier has the same base as @p node_ident are visited.
+ * The occurrences are visited in the order given by the ay_yang_ident_iter().
+ *
+ * @param[in] tree Tree of ynodes.
+ * @param[in] table Identifier table.
+ * @param[in] scope Nearest non-case ancestor of the @p node.
+ * @param[in] node Node for which the duplicates will be searched.
+ * @param[in] node_ident name to be verified.
+ * @param[out] dupl_rank Duplicate number for @p ident.
+ * @param[out] dupl_count Number of all duplicates.
+ */
+static void
+ay_yang_ident_duplications_(struct ay_ynode *tree, const struct ay_ident_occur *table, const struct ay_ynode *scope,
+        const struct ay_ynode *node, const char *node_ident, int64_t *dupl_rank, uint64_t *dupl_count)
+{
+    const struct ay_ident_occur *occ;
+    struct ay_ynode *gr;
+    LY_ARRAY_COUNT_TYPE u, u_end, n, n_end, i, i_end;
+    uint32_t pos, upos, npos, node_pos;
+    uint16_t base_len;
     int64_t rnk, tmp_rnk, tmp, prev;
     uint64_t cnt, tmp_cnt;
-    const char *ch1, *ch2;
+    const char *suffix;
     char *end;
 
-    assert(dupl_count);
-
     rnk = -1;
     cnt = 0;
     prev = -1;
 
-    if (node->type == YN_CASE) {
-        rnk = 0;
-        goto end;
+    /* Position of @p node if it is iterated in the @p scope. */
+    node_pos = UINT32_MAX;
+    if (node->ident) {
+        base_len = ay_ident_base_len(node->ident);
+        i = ay_ident_table_find(table, scope, AY_IDENT_OCCUR_NAME, node->ident, base_len, &i_end);
+        for ( ; i < i_end; i++) {
+            if (table[i].node == node) {
+                node_pos = table[i].pos;
+                break;
+            }
+        }
     }
 
-    for (iter = node->parent; iter && (iter->type == YN_CASE); iter = iter->parent) {}
-    assert(iter);
-    root = iter;
+    u = ay_ident_table_find(table, scope, AY_IDENT_OCCUR_USES, "", 0, &u_end);
 
-    for (iter = ay_yang_ident_iter(root, NULL); iter; iter = ay_yang_ident_iter(root, iter)) {
-        if ((iter->type == YN_KEY) || (iter->type == YN_LEAFREF) || !iter->ident) {
-            continue;
-        } else if (iter == node) {
+    /* Identifier containing a digit cannot be a duplicate. */
+    base_len = strlen(node_ident);
+    for (suffix = node_ident; *suffix && !isdigit(*suffix); suffix++) {}
+    if (*suffix) {
+        n = n_end = 0;
+    } else {
+        n = ay_ident_table_find(table, scope, AY_IDENT_OCCUR_NAME, node_ident, base_len, &n_end);
+    }
+
+    while ((u < u_end) || (n < n_end) || (node_pos != UINT32_MAX)) {
+        upos = u < u_end ? table[u].pos : UINT32_MAX;
+        npos = n < n_end ? table[n].pos : UINT32_MAX;
+        pos = upos < npos ? upos : npos;
+        pos = node_pos < pos ? node_pos : pos;
+
+        if (pos == node_pos) {
             rnk = (int64_t)cnt;
+            node_pos = UINT32_MAX;
+            u = upos == pos ? u + 1 : u;
+            n = npos == pos ? n + 1 : n;
             continue;
-        } else if (iter->type == YN_USES) {
-            gr = ay_ynode_get_grouping(tree, iter->ref);
-            ret = ay_yang_ident_duplications(tree, gr->child, node_ident, &tmp_rnk, &tmp_cnt);
-            AY_CHECK_RET(ret);
-            rnk = rnk == -1 ? tmp_rnk : rnk;
-            cnt += tmp_cnt;
         }
 
-        /* Compare until non-numeric character. */
-        for (ch1 = iter->ident, ch2 = node_ident; *ch1 && *ch2; ch1++, ch2++) {
-            if (isdigit(*ch1) || isdigit(*ch2) || (*ch1 != *ch2)) {
-                break;
+        if (upos == pos) {
+            occ = &table[u++];
+            gr = ay_ynode_get_grouping(tree, occ->node->ref);
+            assert(gr);
+            if (gr->child->type == YN_CASE) {
+                tmp_rnk = 0;
+                tmp_cnt = 0;
+            } else {
+                ay_yang_ident_duplications_(tree, table, gr, gr->child, node_ident, &tmp_rnk, &tmp_cnt);
             }
+            rnk = rnk == -1 ? tmp_rnk : rnk;
+            cnt += tmp_cnt;
         }
-        if (isdigit(*ch1) && !*ch2) {
-            errno = 0;
-            tmp = strtol(ch1, &end, 10);
-            if (!errno && (*end == '\0')) {
-                prev = rnk >= 0 ? prev : tmp;
+
+        if (npos == pos) {
+            occ = &table[n++];
+            suffix = occ->node->ident + base_len;
+            if (*suffix == '\0') {
                 cnt++;
+            } else {
+                errno = 0;
+                tmp = strtol(suffix, &end, 10);
+                if (!errno && (*end == '\0')) {
+                    prev = rnk >= 0 ? prev : tmp;
+                    cnt++;
+                }
             }
-        } else if (!*ch1 && !*ch2) {
-            cnt++;
         }
     }
 
-end:
+    *dupl_rank = prev >= 0 ? prev : rnk;
+    *dupl_count = cnt;
+}
+
+int
+ay_yang_ident_duplications(struct ay_ynode *tree, const struct ay_ident_occur *table, struct ay_ynode *node,
+        const char *node_ident, int64_t *dupl_rank, uint64_t *dupl_count)
+{
+    struct ay_ynode *root;
+    int64_t rnk;
+
+    assert(dupl_count);
+
+    if (node->type == YN_CASE) {
+        rnk = 0;
+        *dupl_count = 0;
+    } else {
+        for (root = node->parent; root && (root->type == YN_CASE); root = root->parent) {}
+        assert(root);
+        ay_yang_ident_duplications_(tree, table, root, node, node_ident, &rnk, dupl_count);
+    }
 
     if (dupl_rank) {
-        *dupl_rank = prev >= 0 ? prev : rnk;
+        *dupl_rank = rnk;
     }
-    *dupl_count = cnt;
 
-    return ret;
+    return 0;
 }
 
 /**
@@ -1462,15 +1715,63 @@ ay_ynode_ident_write(char **old, char *new)
     }
 }
 
+/**
+ * @brief Number the duplicate identifiers.
+ *
+ * @param[in,out] tree Tree of ynodes with evaluated identifiers.
+ * @param[in] table Identifier table created by ay_ident_table_create() for @p tree.
+ * @return 0 on success.
+ */
+static int
+ay_ynode_idents_number(struct ay_ynode *tree, const struct ay_ident_occur *table)
+{
+    int ret = 0;
+    LY_ARRAY_COUNT_TYPE i;
+    struct ay_ynode *iter;
+    char buffer[AY_MAX_IDENT_SIZE];
+    int64_t dupl_rank;
+    uint64_t dupl_count;
+
+    for (i = 1; i < LY_ARRAY_COUNT(tree); i++) {
+        iter = &tree[i];
+        ret = ay_yang_ident_duplications(tree, table, iter, iter->ident, &dupl_rank, &dupl_count);
+        AY_CHECK_RET(ret);
+        if (!dupl_count) {
+            /* No duplicates found. */
+            continue;
+        }
+
+        /* Make duplicate identifiers unique. */
+        if (iter->type == YN_KEY) {
+            strcpy(buffer, "id");
+        } else if (dupl_rank) {
+            assert(dupl_rank > 0);
+            strcpy(buffer, iter->ident);
+            if (dupl_rank < 10) {
+                AY_CHECK_MAX_IDENT_SIZE(buffer, "X");
+            } else {
+                assert(dupl_rank < 100);
+                AY_CHECK_MAX_IDENT_SIZE(buffer, "XX");
+            }
+            sprintf(buffer + strlen(buffer),  "%" PRId64, dupl_rank + 1);
+        } else {
+            strcpy(buffer, iter->ident);
+        }
+        ay_ynode_ident_write(&iter->ident, buffer);
+        AY_CHECK_RET(ret);
+    }
+
+    return ret;
+}
+
 int
 ay_ynode_idents(struct yprinter_ctx *ctx, ly_bool solve_duplicates)
 {
     int ret = 0;
     LY_ARRAY_COUNT_TYPE i;
     struct ay_ynode *tree, *iter, *uses, *gre, *parent;
+    struct ay_ident_occur *table;
     char buffer[AY_MAX_IDENT_SIZE];
-    int64_t dupl_rank;
-    uint64_t dupl_count;
 
     /* Resolve most of identifiers. */
     tree = ctx->tree;
@@ -1526,34 +1827,10 @@ ay_ynode_idents(struct yprinter_ctx *ctx, ly_bool solve_duplicates)
     }
 
     /* Number the duplicate identifiers. */
-    for (i = 1; i < LY_ARRAY_COUNT(tree); i++) {
-        iter = &tree[i];
-        ret = ay_yang_ident_duplications(tree, iter, iter->ident, &dupl_rank, &dupl_count);
-        AY_CHECK_RET(ret);
-        if (!dupl_count) {
-            /* No duplicates found. */
-            continue;
-        }
-
-        /* Make duplicate identifiers unique. */
-        if (iter->type == YN_KEY) {
-            strcpy(buffer, "id");
-        } else if (dupl_rank) {
-            assert(dupl_rank > 0);
-            strcpy(buffer, iter->ident);
-            if (dupl_rank < 10) {
-                AY_CHECK_MAX_IDENT_SIZE(buffer, "X");
-            } else {
-                assert(dupl_rank < 100);
-                AY_CHECK_MAX_IDENT_SIZE(buffer, "XX");
-            }
-            sprintf(buffer + strlen(buffer),  "%" PRId64, dupl_rank + 1);
-        } else {
-            strcpy(buffer, iter->ident);
-        }
-        ay_ynode_ident_write(&iter->ident, buffer);
-        AY_CHECK_RET(ret);
-    }
+    ret = ay_ident_table_create(tree, &table);
+    AY_CHECK_RET(ret);
+    ret = ay_ynode_idents_number(tree, table);
+    ay_ident_table_free(table);
 
     return ret;
 }
@@ -1741,7 +2018,7 @@ ay_pnode_print_regex_to_buffer(char *buffer, uint64_t *idx, struct ay_pnode *reg
     return ret;
 }
 
-static int ay_print_regex_standardized(struct ly_out *out, const char *patt);
+static int ay_print_regex_standardized(struct ly_out *out, uint64_t options, const char *patt);
 
 /**
  * @brief Calculate the length of the string for the regular expression.
@@ -1800,11 +2077,12 @@ ay_pnode_regex_buffer_size(struct ay_pnode *regex)
  * @brief Print regular expression in @p regex subtree.
  *
  * @param[out] out Output where the regex is printed.
+ * @param[in] options Options passed to ay_print_regex_standardized().
  * @param[in] regex Subtree of pnodes related to the regex.
  * @return 0 on success.
  */
 static int
-ay_pnode_print_regex(struct ly_out *out, struct ay_pnode *regex)
+ay_pnode_print_regex(struct ly_out *out, uint64_t options, struct ay_pnode *regex)
 {
     int ret;
     uint64_t size, idx = 0;
@@ -1820,13 +2098,63 @@ ay_pnode_print_regex(struct ly_out *out, struct ay_pnode *regex)
     AY_CHECK_GOTO(ret, free);
 
     buffer[idx] = '\0';
-    ay_print_regex_standardized(out, buffer);
+    ret = ay_print_regex_standardized(out, options, buffer);
 
 free:
     free(buffer);
     return ret;
 }
 
+/**
+ * @brief Print standardized regex which is rendered only once during printing.
+ *
+ * The same lens regex is usually printed for many ynodes, so the standardized string is stored
+ * in yprinter_ctx.regex_cache and next time it is printed from there.
+ *
+ * @param[in] ctx Context for printing.
+ * @param[in] regex Subtree of pnodes related to the regex. If NULL, then @p patt is printed.
+ * @param[in] patt Augeas regex pattern to print if @p regex is NULL.
+ * @return 0 on success.
+ */
+static int
+ay_print_regex_cached(struct yprinter_ctx *ctx, struct ay_pnode *regex, const char *patt)
+{
+    int ret;
+    uint32_t pos;
+    const void *key;
+    struct ly_out *out;
+    char *str = NULL;
+
+    key = regex ? (const void *)regex : (const void *)patt;
+    if (ay_pindex_get(&ctx->regex_index, key, &pos)) {
+        ly_print(ctx->out, "%s", ctx->regex_cache[pos]);
+        return 0;
+    }
+
+    if (ly_out_new_memory(&str, 0, &out)) {
+        return AYE_MEMORY;
+    }
+    ret = regex ? ay_pnode_print_regex(out, ctx->options, regex) :
+            ay_print_regex_standardized(out, ctx->options, patt);
+    ly_out_free(out, NULL, 0);
+    AY_CHECK_GOTO(ret, error);
+    if (!str) {
+        /* Nothing to print. */
+        return 0;
+    }
+
+    LY_ARRAY_CREATE_GOTO(NULL, ctx->regex_cache, 1, ret, error);
+    ctx->regex_cache[LY_ARRAY_COUNT(ctx->regex_cache)] = str;
+    LY_ARRAY_INCREMENT(ctx->regex_cache);
+    ly_print(ctx->out, "%s", str);
+
+    return ay_pindex_set(&ctx->regex_index, key, LY_ARRAY_COUNT(ctx->regex_cache) - 1);
+
+error:
+    free(str);
+    return ret;
+}
+
 /**
  * @brief Print caseless flag in the pattern.
  *
@@ -1870,7 +2198,7 @@ ay_print_yang_pattern_by_pnode_regex(struct yprinter_ctx *ctx, struct ay_pnode *
 
     ly_print(ctx->out, "%*spattern \"", ctx->space, "");
     ay_pnode_print_yang_pattern_nocase(ctx, regex);
-    ret = ay_pnode_print_regex(ctx->out, regex);
+    ret = ay_print_regex_cached(ctx, regex, NULL);
     ly_print(ctx->out, "\"");
 
     return ret;
@@ -1957,7 +2285,7 @@ ay_print_yang_pattern(struct yprinter_ctx *ctx, const struct ay_ynode *node, con
         subpatt = ay_ynode_get_substr_from_transl_table(ctx->tree, node);
         ly_print(ctx->out, "%s\";\n", subpatt);
     } else {
-        ay_print_regex_standardized(ctx->out, lnode->lens->regexp->pattern->str);
+        ret = ay_print_regex_cached(ctx, NULL, lnode->lens->regexp->pattern->str);
         ly_print(ctx->out, "\";\n");
     }
 
@@ -2086,6 +2414,109 @@ ay_get_yang_type_by_lense_name(const char *modname, const char *ident)
     return ret;
 }
 
+/**
+ * @brief Check if the regex binding from the shared module is printed as typedef in the AY_TYPES_MODULE.
+ *
+ * @param[in] modname Name of the shared module.
+ * @param[in] bind Binding from the shared module.
+ * @return 1 if typedef is printed for @p bind.
+ */
+static ly_bool
+ay_shared_binding_is_typedef(const char *modname, const struct binding *bind)
+{
+    return (bind->value->tag == V_REGEXP) && bind->value->regexp->pattern->str[0] &&
+           !ay_get_yang_type_by_lense_name(modname, bind->ident->str);
+}
+
+/**
+ * @brief Find the shared regex which is used in the @p lens.
+ *
+ * @param[in] lens Lense to check.
+ * @param[out] modname Name of the shared module in which the regex is defined.
+ * @return Name of the regex binding or NULL if @p lens does not use any shared regex.
+ */
+static const char *
+ay_get_shared_typedef(struct lens *lens, const char **modname)
+{
+    uint64_t i;
+    struct module *mod;
+    struct binding *bind_iter;
+
+    if (!lens || ((lens->tag != L_STORE) && (lens->tag != L_KEY))) {
+        return NULL;
+    }
+
+    for (i = 0; ay_shared_modules[i]; i++) {
+        mod = ay_get_module(ay_get_augeas_ctx2(lens), ay_shared_modules[i], 0);
+        if (!mod) {
+            continue;
+        }
+        LY_LIST_FOR(mod->bindings, bind_iter) {
+            if ((bind_iter->value->tag == V_REGEXP) && (bind_iter->value->regexp == lens->regexp) &&
+                    ay_shared_binding_is_typedef(ay_shared_modules[i], bind_iter)) {
+                *modname = ay_shared_modules[i];
+                return bind_iter->ident->str;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Print name of the typedef from the AY_TYPES_MODULE.
+ *
+ * The name consists of the shared module name and the regex binding, e.g. Rx.word -> rx-word.
+ *
+ * @param[in,out] out Output handler for printing.
+ * @param[in] modname Name of the shared module.
+ * @param[in] ident Name of the regex binding.
+ */
+static void
+ay_print_yang_typedef_name(struct ly_out *out, const char *modname, const char *ident)
+{
+    const char *ch;
+
+    for (ch = modname; *ch; ch++) {
+        ly_print(out, "%c", tolower(*ch));
+    }
+    ly_print(out, "-");
+    for (ch = ident; *ch; ch++) {
+        ly_print(out, "%c", *ch == '_' ? '-' : *ch);
+    }
+}
+
+/**
+ * @brief Print type which refers to the typedef in the AY_TYPES_MODULE.
+ *
+ * @param[in] ctx Context for printing.
+ * @param[in] node Node of type ynode to which the type is to be printed.
+ * @param[in] lnode Node of type lnode containing regex.
+ * @return 0 if type was printed successfully.
+ */
+static int
+ay_print_yang_type_shared(struct yprinter_ctx *ctx, const struct ay_ynode *node, const struct ay_lnode *lnode)
+{
+    const char *modname, *ident;
+
+    if (!(ctx->options & AYO_SHARED_TYPES) || (lnode->flags & AY_LNODE_KEY_HAS_IDENTS) ||
+            (!(node->flags & AY_WHEN_TARGET) && lnode->pnode && (lnode->pnode->term->tag == A_MINUS))) {
+        return 1;
+    }
+
+    ident = ay_get_shared_typedef(lnode->lens, &modname);
+    if (!ident) {
+        return 1;
+    }
+
+    ly_print(ctx->out, "%*stype " AY_TYPES_PREFIX ":", ctx->space, "");
+    ay_print_yang_typedef_name(ctx->out, modname, ident);
+    ly_print(ctx->out, ";\n");
+    ctx->shared_types = 1;
+
+    return 0;
+}
+
 /**
  * @brief Print type built-in yang type.
  *
@@ -2156,6 +2587,7 @@ ay_print_yang_type_item(struct yprinter_ctx *ctx, const struct ay_ynode *node, c
 
     valstr = (lnode->lens->tag == L_VALUE) ? lnode->lens->string->str : NULL;
     ret = ay_print_yang_type_builtin(ctx, lnode->lens);
+    ret = ret ? ay_print_yang_type_shared(ctx, node, lnode) : ret;
     if (!ret ||
             /* If this condition evaluates to true, then it is assumed that the empty string has already been printed. */
             (valstr && (valstr[0] == '\0'))) {
@@ -2277,10 +2709,10 @@ ay_print_yang_type(struct yprinter_ctx *ctx, struct ay_ynode *node)
 
     /* Set dnode key if exists. */
     if (lv_type == AY_LV_TYPE_LABEL) {
-        key = ay_dnode_find(AY_YNODE_ROOT_LABELS(ctx->tree), lnode);
+        key = ay_dnode_find(AY_YNODE_ROOT_LABELS(ctx->tree), AY_YNODE_ROOT_LABELS_INDEX(ctx->tree), lnode);
     } else {
         assert(lv_type == AY_LV_TYPE_VALUE);
-        key = ay_dnode_find(AY_YNODE_ROOT_VALUES(ctx->tree), lnode);
+        key = ay_dnode_find(AY_YNODE_ROOT_VALUES(ctx->tree), AY_YNODE_ROOT_VALUES_INDEX(ctx->tree), lnode);
     }
 
     /* Set empty_string and empty_type. */
@@ -2389,10 +2821,12 @@ ay_print_yang_when_print_target(struct yprinter_ctx *ctx, uint64_t path_cnt, con
  *
  * @param[in] ctx Context for printing.
  * @param[in] node Node to process.
+ * @return 0 on success.
  */
-static void
+static int
 ay_print_yang_when(struct yprinter_ctx *ctx, struct ay_ynode *node)
 {
+    int ret;
     struct ay_ynode *target;
     struct lens *value;
     ly_bool is_simple;
@@ -2400,7 +2834,7 @@ ay_print_yang_when(struct yprinter_ctx *ctx, struct ay_ynode *node)
     uint64_t path_cnt;
 
     if (!node->when_val) {
-        return;
+        return 0;
     }
 
     target = ay_ynode_when_target(ctx->tree, node, &path_cnt, &parent_name);
@@ -2409,7 +2843,7 @@ ay_print_yang_when(struct yprinter_ctx *ctx, struct ay_ynode *node)
         /* Warning: when is ignored. */
         fprintf(stderr, "augyang warn: 'when' has invalid path and therefore will not be generated "
                 "(id = %" PRIu32 ", when_ref = %" PRIu32 ").\n", node->id, node->when_ref);
-        return;
+        return 0;
     }
 
     /* Print 'when' statement. */
@@ -2452,10 +2886,13 @@ ay_print_yang_when(struct yprinter_ctx *ctx, struct ay_ynode *node)
     } else {
         /* The 'when' expression is more complex, continue with printing of re-match function. */
         ly_print(ctx->out, ", \'");
-        ay_print_regex_standardized(ctx->out, str);
+        ret = ay_print_regex_cached(ctx, NULL, str);
+        AY_CHECK_RET(ret);
         ly_print(ctx->out, "\')");
     }
     ly_print(ctx->out, "\";\n");
+
+    return 0;
 }
 
 /**
@@ -2471,6 +2908,107 @@ ay_print_yang_description(struct yprinter_ctx *ctx, char *msg)
     ly_print(ctx->out, "%*s\"%s\";\n", ctx->space + SPACE_INDENT, "", msg);
 }
 
+/**
+ * @brief Append regex of the lense as a branch of the alternation.
+ *
+ * @param[in,out] out Output handler for printing.
+ * @param[in] lens Lense with the regex or string.
+ * @return 0 on success, 1 if the lense cannot be used.
+ */
+static int
+ay_print_label_literals_branch(struct ly_out *out, const struct lens *lens)
+{
+    const char *ch;
+
+    if ((lens->tag == L_KEY) || (lens->tag == L_STORE)) {
+        AY_CHECK_COND(lens->regexp->nocase, 1);
+        ly_print(out, "(%s)", lens->regexp->pattern->str);
+    } else if ((lens->tag == L_VALUE) || (lens->tag == L_LABEL)) {
+        ly_print(out, "(");
+        for (ch = lens->string->str; *ch; ch++) {
+            ly_print(out, "%s%c", strchr("\\^$.|?*+()[]{}", *ch) ? "\\" : "", *ch);
+        }
+        ly_print(out, ")");
+    } else {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Print the extension with all the labels which the @p node can match.
+ *
+ * Only if the label of @p node is defined by a regex with a small finite language. The labels are printed
+ * in the same form as the pattern of the node type, so the KEY and its VALUES from the dictionary are used.
+ *
+ * @param[in] ctx Context for printing.
+ * @param[in] node Node with data-path "$$".
+ * @return 0 on success.
+ */
+static int
+ay_print_yang_label_literals(struct yprinter_ctx *ctx, struct ay_ynode *node)
+{
+    int ret = 0;
+    struct lens *label;
+    struct ay_dnode *key;
+    const struct ay_lnode *lnode;
+    struct ly_out *out = NULL;
+    char *regex = NULL, **literals = NULL;
+    const char *ch;
+    LY_ARRAY_COUNT_TYPE i;
+
+    label = AY_LABEL_LENS(node);
+    if (!(ctx->options & AYO_LABEL_LITERALS) || (label->tag != L_KEY) || (node->type == YN_VALUE)) {
+        return ret;
+    }
+
+    /* Join regexes of the type union. */
+    if (ly_out_new_memory(&regex, 0, &out)) {
+        return AYE_MEMORY;
+    }
+    key = ay_dnode_find(AY_YNODE_ROOT_LABELS(ctx->tree), AY_YNODE_ROOT_LABELS_INDEX(ctx->tree), node->label);
+    for (i = 0; i < (key ? key->values_count + 1 : 1); i++) {
+        lnode = key ? key[i].lnode : node->label;
+        if ((lnode->flags & AY_LNODE_KEY_HAS_IDENTS) || ay_yang_type_is_empty(lnode) ||
+                ay_yang_type_is_empty_string(lnode->lens)) {
+            goto cleanup;
+        }
+        ly_print(out, i ? "|" : "");
+        if (ay_print_label_literals_branch(out, lnode->lens)) {
+            goto cleanup;
+        }
+    }
+    ly_out_free(out, NULL, 0);
+    out = NULL;
+
+    ret = ay_regex_literals(regex, AY_EXT_LITERALS_MAX, &literals);
+    AY_CHECK_GOTO(ret || !literals, cleanup);
+    LY_ARRAY_FOR(literals, i) {
+        for (ch = literals[i]; *ch && !isspace(*ch); ch++) {}
+        if (!literals[i][0] || *ch) {
+            /* Literals are separated by space. */
+            goto cleanup;
+        }
+    }
+
+    ly_print(ctx->out, "%*s"AY_EXT_PREFIX ":"AY_EXT_LITERALS " \"", ctx->space, "");
+    LY_ARRAY_FOR(literals, i) {
+        ly_print(ctx->out, i ? " " : "");
+        for (ch = literals[i]; *ch; ch++) {
+            ly_print(ctx->out, "%s%c", ((*ch == '\"') || (*ch == '\\')) ? "\\" : "", *ch);
+        }
+    }
+    ly_print(ctx->out, "\";\n");
+
+cleanup:
+    ly_out_free(out, NULL, 0);
+    free(regex);
+    ay_regex_literals_free(literals);
+
+    return ret;
+}
+
 /**
  * @brief Print dat-path for @p node.
  *
@@ -2493,12 +3031,12 @@ ay_print_yang_data_path(struct yprinter_ctx *ctx, struct ay_ynode *node)
 
     if (AY_LABEL_LENS_IS_IDENT(node)) {
         ret = ay_print_yang_ident(ctx, node, AY_IDENT_DATA_PATH);
+        ly_print(ctx->out, "\";\n");
     } else {
-        ly_print(ctx->out, "$$");
+        ly_print(ctx->out, "$$\";\n");
+        ret = ay_print_yang_label_literals(ctx, node);
     }
 
-    ly_print(ctx->out, "\";\n");
-
     return ret;
 }
 
@@ -2599,7 +3137,9 @@ ay_print_yang_leaf(struct yprinter_ctx *ctx, struct ay_ynode *node)
     ret = ay_print_yang_data_path(ctx, node);
     AY_CHECK_RET(ret);
     ret = ay_print_yang_value_path(ctx, node);
-    ay_print_yang_when(ctx, node);
+    AY_CHECK_RET(ret);
+    ret = ay_print_yang_when(ctx, node);
+    AY_CHECK_RET(ret);
 
     ay_print_yang_nesting_end(ctx);
 
@@ -2641,7 +3181,8 @@ ay_print_yang_leafref(struct yprinter_ctx *ctx, struct ay_ynode *node)
     ay_print_yang_nesting_end(ctx);
 
     ay_print_yang_description(ctx, "Implicitly generated leaf to maintain recursive augeas data.");
-    ay_print_yang_when(ctx, node);
+    ret = ay_print_yang_when(ctx, node);
+    AY_CHECK_RET(ret);
     ay_print_yang_nesting_end(ctx);
 
     return ret;
@@ -2765,7 +3306,8 @@ ay_print_yang_seq_list(struct yprinter_ctx *ctx, struct ay_ynode *node)
 
     ly_print(ctx->out, "%*skey \"_seq\";\n", ctx->space, "");
     ay_print_yang_minelements(ctx, node);
-    ay_print_yang_when(ctx, node);
+    ret = ay_print_yang_when(ctx, node);
+    AY_CHECK_RET(ret);
     ly_print(ctx->out, "%*sordered-by user;\n", ctx->space, "");
     ret = ay_print_yang_data_path(ctx, node);
     AY_CHECK_RET(ret);
@@ -2813,7 +3355,8 @@ ay_print_yang_list(struct yprinter_ctx *ctx, struct ay_ynode *node)
         ly_print(ctx->out, "%*skey \"_id\";\n", ctx->space, "");
     }
     ay_print_yang_minelements(ctx, node);
-    ay_print_yang_when(ctx, node);
+    ret = ay_print_yang_when(ctx, node);
+    AY_CHECK_RET(ret);
     if (is_lrec) {
         ly_print(ctx->out, "%*sleaf _r-id", ctx->space, "");
     } else {
@@ -2873,7 +3416,8 @@ ay_print_yang_container(struct yprinter_ctx *ctx, struct ay_ynode *node)
     ret = ay_print_yang_value_path(ctx, node);
     AY_CHECK_RET(ret);
     ay_print_yang_presence(ctx, node);
-    ay_print_yang_when(ctx, node);
+    ret = ay_print_yang_when(ctx, node);
+    AY_CHECK_RET(ret);
     ret = ay_print_yang_children(ctx, node);
     AY_CHECK_RET(ret);
     ay_print_yang_nesting_end(ctx);
@@ -3041,8 +3585,9 @@ ay_print_yang_case(struct yprinter_ctx *ctx, struct ay_ynode *node)
         assert(node->type == YN_USES);
         ret = ay_print_yang_ident(ctx, node, AY_IDENT_NODE_NAME);
     }
+    AY_CHECK_RET(ret);
     ay_print_yang_nesting_begin2(ctx, node->id);
-    ay_print_yang_when(ctx, node);
+    ret = ay_print_yang_when(ctx, node);
 
     return ret;
 }
@@ -3173,9 +3718,10 @@ ay_print_yang_import_inet_types(struct lens *reg)
  *
  * @param[in,out] out Output handler for printing.
  * @param[in] tree Tree of ynodes.
+ * @param[in] shared_types Flag set if some type refers to the AY_TYPES_MODULE, see yprinter_ctx.shared_types.
  */
 static void
-ay_print_yang_imports(struct ly_out *out, struct ay_ynode *tree)
+ay_print_yang_imports(struct ly_out *out, struct ay_ynode *tree, ly_bool shared_types)
 {
     struct ay_ynode *iter;
     LY_ARRAY_COUNT_TYPE i;
@@ -3184,6 +3730,12 @@ ay_print_yang_imports(struct ly_out *out, struct ay_ynode *tree)
     ly_print(out, "    prefix " AY_EXT_PREFIX ";\n");
     ly_print(out, "  }\n");
 
+    if (shared_types) {
+        ly_print(out, "  import " AY_TYPES_MODULE " {\n");
+        ly_print(out, "    prefix " AY_TYPES_PREFIX ";\n");
+        ly_print(out, "  }\n");
+    }
+
     for (i = 1; i < LY_ARRAY_COUNT(tree); i++) {
         iter = &tree[i];
 
@@ -3201,17 +3753,61 @@ ay_print_yang_imports(struct ly_out *out, struct ay_ynode *tree)
     ly_print(out, "\n");
 }
 
+/**
+ * @brief Print the lens autoloaded by the augeas module and its filter.
+ *
+ * Using the qualified lens name, the DS plugin loads only this module and its dependencies instead of all the modules.
+ *
+ * @param[in] out Output handler for printing.
+ * @param[in] mod Augeas module.
+ */
+static void
+ay_print_yang_autoload(struct ly_out *out, const struct module *mod)
+{
+    const struct binding *bnd;
+    const struct filter *filter;
+    const char *ch;
+
+    if (!mod->autoload) {
+        return;
+    }
+
+    /* find the name of the autoloaded lens */
+    LY_LIST_FOR(mod->bindings, bnd) {
+        if (bnd->value && (bnd->value->tag == V_LENS) && (bnd->value->lens == mod->autoload->lens)) {
+            break;
+        }
+    }
+    if (!bnd) {
+        /* the lens is not bound to any name */
+        return;
+    }
+    ly_print(out, "  " AY_EXT_PREFIX ":" AY_EXT_AUTOLOAD_LENS " \"%s.%s\";\n", mod->name, bnd->ident->str);
+
+    LY_LIST_FOR(mod->autoload->filter, filter) {
+        ly_print(out, "  " AY_EXT_PREFIX ":%s \"", filter->include ? AY_EXT_AUTOLOAD_INCL : AY_EXT_AUTOLOAD_EXCL);
+        for (ch = filter->glob->str; *ch; ch++) {
+            if ((*ch == '"') || (*ch == '\\')) {
+                ly_print(out, "\\");
+            }
+            ly_print(out, "%c", *ch);
+        }
+        ly_print(out, "\";\n");
+    }
+}
+
 int
-ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, char **str_out)
+ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, uint64_t options, char **str_out)
 {
     int ret = 0;
-    struct yprinter_ctx ctx;
-    struct ly_out *out = NULL;
+    struct yprinter_ctx ctx = {0};
+    struct ly_out *out = NULL, *body_out = NULL;
+    LY_ARRAY_COUNT_TYPE j;
     const char *modname;
-    char *str;
+    char *str, *body = NULL;
     size_t i, modname_len;
 
-    if (ly_out_new_memory(&str, 0, &out)) {
+    if (ly_out_new_memory(&str, 0, &out) || ly_out_new_memory(&body, 0, &body_out)) {
         ret = AYE_MEMORY;
         goto free;
     }
@@ -3220,9 +3816,13 @@ ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, char
     ctx.mod = mod;
     ctx.tree = tree;
     ctx.vercode = vercode;
-    ctx.out = out;
+    ctx.options = options;
+    ctx.out = body_out;
     ctx.space = SPACE_INDENT;
 
+    /* The body is printed first because the imports depend on the types printed in it. */
+    ret = ay_print_yang_children(&ctx, tree);
+
     modname = ay_get_yang_module_name(ctx.mod, &modname_len);
 
     ly_print(out, "module ");
@@ -3239,11 +3839,79 @@ ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, char
     ly_print(out, "\";\n");
 
     ly_print(out, "  prefix aug;\n\n");
-    ay_print_yang_imports(out, tree);
+    ay_print_yang_imports(out, tree, ctx.shared_types);
     ly_print(out, "  " AY_EXT_PREFIX ":augeas-mod-name \"%s\";\n", mod->name);
+    if (options & AYO_AUTOLOAD) {
+        ay_print_yang_autoload(out, mod);
+    }
     ly_print(out, "\n");
+    if (body) {
+        ly_print(out, "%s", body);
+    }
+    ly_print(out, "}\n");
 
-    ret = ay_print_yang_children(&ctx, tree);
+    *str_out = str;
+
+free:
+    ly_out_free(out, NULL, 0);
+    ly_out_free(body_out, NULL, 0);
+    free(body);
+    LY_ARRAY_FOR(ctx.regex_cache, j) {
+        free(ctx.regex_cache[j]);
+    }
+    LY_ARRAY_FREE(ctx.regex_cache);
+    ay_pindex_clean(&ctx.regex_index);
+
+    return ret;
+}
+
+int
+ay_print_yang_shared_types(struct augeas *aug, uint64_t options, char **str_out)
+{
+    int ret = 0;
+    struct yprinter_ctx ctx = {0};
+    struct ly_out *out = NULL;
+    struct module *mod;
+    struct binding *bind_iter;
+    char *str;
+    uint64_t i;
+
+    if (ly_out_new_memory(&str, 0, &out)) {
+        return AYE_MEMORY;
+    }
+
+    ctx.aug = aug;
+    ctx.options = options;
+    ctx.out = out;
+    ctx.space = SPACE_INDENT;
+
+    ly_print(out, "module " AY_TYPES_MODULE " {\n");
+    ly_print(out, "  yang-version 1.1;\n");
+    ly_print(out, "  namespace \"aug:" AY_TYPES_MODULE "\";\n");
+    ly_print(out, "  prefix " AY_TYPES_PREFIX ";\n");
+
+    for (i = 0; ay_shared_modules[i]; i++) {
+        mod = ay_get_module(aug, ay_shared_modules[i], 0);
+        if (!mod) {
+            continue;
+        }
+        LY_LIST_FOR(mod->bindings, bind_iter) {
+            if (!ay_shared_binding_is_typedef(ay_shared_modules[i], bind_iter)) {
+                continue;
+            }
+            ly_print(out, "\n  typedef ");
+            ay_print_yang_typedef_name(out, ay_shared_modules[i], bind_iter->ident->str);
+            ly_print(out, " {\n");
+            ly_print(out, "    type string {\n");
+            ly_print(out, "      pattern \"");
+            ay_print_yang_pattern_nocase(&ctx, bind_iter->value->regexp);
+            ret = ay_print_regex_standardized(out, options, bind_iter->value->regexp->pattern->str);
+            AY_CHECK_GOTO(ret, free);
+            ly_print(out, "\";\n");
+            ly_print(out, "    }\n");
+            ly_print(out, "  }\n");
+        }
+    }
 
     ly_print(out, "}\n");
 
@@ -3251,6 +3919,9 @@ ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, char
 
 free:
     ly_out_free(out, NULL, 0);
+    if (ret) {
+        free(str);
+    }
 
     return ret;
 }
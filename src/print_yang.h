@@ -16,8 +16,10 @@
 
 #include <stdint.h>
 
+struct augeas;
 struct module;
 struct ay_ynode;
+struct ay_ident_occur;
 struct yprinter_ctx;
 typedef uint8_t ly_bool;
 
@@ -27,10 +29,23 @@ typedef uint8_t ly_bool;
  * @param[in] mod Module in which the tree is located.
  * @param[in] tree Ynode tree to print.
  * @param[in] vercode Decide if debugging information should be printed.
+ * @param[in] options Options of the printed module, see AYO_* constants.
  * @param[out] str_out Printed tree in yang format. Call free() after use.
  * @return 0 on success.
  */
-int ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, char **str_out);
+int ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, uint64_t options, char **str_out);
+
+/**
+ * @brief Print yang module augeas-types with typedefs for regexes from the shared augeas modules (Rx, Util, ...).
+ *
+ * The generated yang modules refer to these typedefs if they are printed with AYO_SHARED_TYPES.
+ *
+ * @param[in] aug Augeas context in which the shared modules are loaded.
+ * @param[in] options Options for printing regexes, see AYO_* constants.
+ * @param[out] str_out Printed yang module. Call free() after use.
+ * @return 0 on success.
+ */
+int ay_print_yang_shared_types(struct augeas *aug, uint64_t options, char **str_out);
 
 /**
  * @brief Set ay_ynode.ident for every ynode in the tree.
@@ -41,10 +56,30 @@ int ay_print_yang(struct module *mod, struct ay_ynode *tree, uint64_t vercode, c
  */
 int ay_ynode_idents(struct yprinter_ctx *ctx, ly_bool solve_duplicates);
 
+/**
+ * @brief Create table of identifiers for detecting duplicates.
+ *
+ * The table is valid until the structure of @p tree is modified. Renaming the nodes by adding a numeric suffix
+ * does not invalidate the table.
+ *
+ * @param[in] tree Tree of ynodes with evaluated identifiers.
+ * @param[out] table Identifier table (Sized array). Call ay_ident_table_free() after use.
+ * @return 0 on success.
+ */
+int ay_ident_table_create(struct ay_ynode *tree, struct ay_ident_occur **table);
+
+/**
+ * @brief Release identifier table.
+ *
+ * @param[in] table Identifier table created by ay_ident_table_create().
+ */
+void ay_ident_table_free(struct ay_ident_occur *table);
+
 /**
  * @brief Detect for duplicates for the identifier.
  *
  * @param[in] tree Tree of ynodes.
+ * @param[in] table Identifier table created by ay_ident_table_create().
  * @param[in] node Node for which the duplicates will be searched.
  * @param[in] node_ident name to be verified.
  * @param[out] dupl_rank Duplicate number for @p ident. Rank may be greater than @p dupl_count because it is also
@@ -52,5 +87,5 @@ int ay_ynode_idents(struct yprinter_ctx *ctx, ly_bool solve_duplicates);
  * @param[out] dupl_count Number of all duplicates.
  * @return 0 on success.
  */
-int ay_yang_ident_duplications(struct ay_ynode *tree, struct ay_ynode *node, char *node_ident, int64_t *dupl_rank,
-        uint64_t *dupl_count);
+int ay_yang_ident_duplications(struct ay_ynode *tree, const struct ay_ident_occur *table, struct ay_ynode *node,
+        const char *node_ident, int64_t *dupl_rank, uint64_t *dupl_count);
@@ -0,0 +1,571 @@
+/**
+ * @file ay_dsbench.c
+ * @author agent <agent@local>
+ * @brief Benchmark of loading and storing data by the augeas DS plugin.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ *
+ * For every module and size a synthetic config file is generated and the plugin works only with this file, the same
+ * way as in the tests. Every measurement runs in a separate child process so that the cold load includes the augeas
+ * initialization and the peak memory can be measured by wait4(). The commits are generated from the loaded data
+ * regardless of the lens, using the user-ordered list with the most instances. The parsing and the phases of the
+ * commits are timed by the plugin itself into statistics private to the process.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/* config file the plugin works with, set for every benchmark */
+static char *aydb_input_file;
+
+/* augeas SR DS plugin */
+#define AUG_TEST_INPUT_FILES aydb_input_file
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include "ay_dstools.h"
+#include "ay_tools.h"
+#include "plg_config.h"
+
+#include <libyang/libyang.h>
+#include <sysrepo/plugins_datastore.h>
+
+/**
+ * @brief Name of the program.
+ */
+#define AYDB_PROGNAME "ay_dsbench"
+
+/**
+ * @brief Default number of repetitions of every warm measurement.
+ */
+#define AYDB_REPEAT 5
+
+/**
+ * @brief Default sizes of the generated config files.
+ */
+#define AYDB_SIZES "10,1000"
+
+/**
+ * @brief Measured times of a commit.
+ */
+struct aydb_commit {
+    uint64_t usec;              /**< whole store callback */
+    uint64_t diff_usec;         /**< diff of the current and the new data, AUGSTATS_PH_DIFF */
+    uint64_t apply_usec;        /**< applying the diff to augeas, AUGSTATS_PH_STORE_DIFF */
+    uint64_t save_usec;         /**< saving the file by augeas, AUGSTATS_PH_SAVE */
+};
+
+/**
+ * @brief Parameters of the benchmark of one module.
+ */
+struct aydb_params {
+    const char *name;           /**< YANG module name */
+    uint32_t repeat;            /**< number of repetitions */
+};
+
+/**
+ * @brief Result of the benchmark for one module and size, the minimum of the repetitions.
+ */
+struct aydb_result {
+    char name[64];              /**< YANG module name */
+    uint32_t entries;           /**< number of generated entries */
+    uint64_t load_cold_usec;    /**< first load including augeas initialization */
+    uint64_t load_warm_usec;    /**< load of unchanged files, mostly the conversion to YANG data */
+    uint64_t parse_usec;        /**< parsing the changed file by augeas, AUGSTATS_PH_PARSE */
+    struct aydb_commit edit;    /**< change of a single leaf */
+    struct aydb_commit insert;  /**< insertion of 10 % new list instances */
+    struct aydb_commit reorder; /**< move of the last list instance to the beginning */
+    uint64_t peak_kb;           /**< peak memory of the child process */
+};
+
+/**
+ * @brief Phase statistics of the benchmarked module, private to the process and reset before every measurement.
+ */
+static struct augstats_mod aydb_stats;
+
+/**
+ * @brief Print help.
+ */
+static void
+aydb_usage(void)
+{
+    const char *msg =
+            "Usage:\n"
+            "  " AYDB_PROGNAME " [OPTIONS] [MODULE...]\n"
+            "\n"
+            "Measure loading and storing synthetic config files of the YANG modules by the augeas DS plugin.\n"
+            "Without modules all the supported ones are measured: hosts, passwd, sshd, sysctl, fstab, logrotate,\n"
+            "and iptables. All times are in microseconds, the fastest repetition is printed. The parsing and the\n"
+            "phases of the commits are timed by the plugin.\n"
+            "\nOptions:\n\n"
+            "  -n, --sizes NUM,...  numbers of entries of the generated config files; default value: " AYDB_SIZES "\n"
+            "  -r, --repeat NUM     number of repetitions of the warm measurements; default value: 5\n"
+            "  -w, --write FILE     write the results also to FILE\n"
+            "\nExample:\n"
+            AYDB_PROGNAME " -n 10,1000,100000 -w results.txt hosts passwd\n";
+
+    fprintf(stderr, "%s", msg);
+}
+
+/**
+ * @brief Update minimum.
+ *
+ * @param[in,out] min Minimum, 0 if not set yet.
+ * @param[in] val Measured value.
+ */
+static void
+aydb_min(uint64_t *min, uint64_t val)
+{
+    if (!*min || (val < *min)) {
+        *min = val;
+    }
+}
+
+/**
+ * @brief Get the duration of a phase of the plugin since the statistics were reset.
+ *
+ * @param[in] phase Phase.
+ * @param[out] usec Duration of the phase.
+ * @return 0 on success, non-zero if the phase was not run exactly once.
+ */
+static int
+aydb_phase_usec(enum augstats_phase phase, uint64_t *usec)
+{
+    if (aydb_stats.phases[phase].count != 1) {
+        fprintf(stderr, "ERROR: phase %d run %" PRIu64 " times instead of once\n", (int)phase,
+                aydb_stats.phases[phase].count);
+        return 1;
+    }
+
+    *usec = aydb_stats.phases[phase].total_usec;
+    return 0;
+}
+
+/**
+ * @brief Change the first leaf of a list instance to the value of the same leaf in another instance.
+ *
+ * @param[in] node1 Node to change.
+ * @param[in] node2 Node with the values to use.
+ * @return Whether a leaf was changed.
+ */
+static int
+aydb_edit_r(struct lyd_node *node1, const struct lyd_node *node2)
+{
+    struct lyd_node *child1, *child2;
+
+    LY_LIST_FOR(lyd_child_no_keys(node1), child1) {
+        for (child2 = lyd_child(node2); child2 && (child2->schema != child1->schema); child2 = child2->next) {}
+        if (!child2) {
+            continue;
+        }
+
+        if (child1->schema->nodetype & LYD_NODE_TERM) {
+            if (strcmp(lyd_get_value(child1), lyd_get_value(child2)) &&
+                    !lyd_change_term(child1, lyd_get_value(child2))) {
+                return 1;
+            }
+        } else if (aydb_edit_r(child1, child2)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Insert new list instances at the end, copies of the existing ones.
+ *
+ * @param[in] first First list instance.
+ * @param[in] count Number of the instances.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+aydb_insert(struct lyd_node *first, uint32_t count)
+{
+    struct lyd_node *src, *inst, *child;
+    uint64_t key, max_key = 0;
+    uint32_t i, new_count;
+    char *pred;
+
+    /* generated lists are keyed by a single uint64 */
+    for (src = first, i = 0; i < count; src = src->next, ++i) {
+        key = strtoull(lyd_get_value(lyd_child(src)), NULL, 10);
+        if (key > max_key) {
+            max_key = key;
+        }
+    }
+
+    new_count = count / 10 ? count / 10 : 1;
+    for (src = first, i = 0; i < new_count; src = src->next, ++i) {
+        if (asprintf(&pred, "[%s='%" PRIu64 "']", LYD_NAME(lyd_child(src)), max_key + i + 1) == -1) {
+            return 1;
+        }
+        if (lyd_new_list2(lyd_parent(first), first->schema->module, LYD_NAME(first), pred, 0, &inst)) {
+            free(pred);
+            return 1;
+        }
+        free(pred);
+        if (!lyd_parent(first)) {
+            lyd_insert_sibling(first, inst, NULL);
+        }
+
+        LY_LIST_FOR(lyd_child_no_keys(src), child) {
+            if (lyd_dup_single(child, (struct lyd_node_inner *)inst, LYD_DUP_RECURSIVE, NULL)) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Measure one commit.
+ *
+ * @param[in] mod Module.
+ * @param[in] op Commit to perform, 'e' for edit, 'i' for insert, and 'r' for reorder.
+ * @param[in,out] res Minimal times to update.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+aydb_commit(const struct lys_module *mod, char op, struct aydb_commit *res)
+{
+    const struct srplg_ds_s *ds_plg = &srpds__;
+    struct lyd_node *data = NULL, *new_data = NULL, *first, *last;
+    uint64_t start, usec, diff_usec, apply_usec, save_usec;
+    uint32_t count;
+    int ret = 1;
+
+    if (ds_plg->load_cb(mod, SR_DS_STARTUP, NULL, 0, &data)) {
+        goto cleanup;
+    }
+    if (lyd_dup_siblings(data, NULL, LYD_DUP_RECURSIVE, &new_data)) {
+        goto cleanup;
+    }
+
+    first = aydt_find_list(new_data, &count);
+    if (count < 2) {
+        fprintf(stderr, "ERROR: no list with more instances in module %s\n", mod->name);
+        goto cleanup;
+    }
+    if (op == 'e') {
+        if (!aydb_edit_r(first, first->next)) {
+            fprintf(stderr, "ERROR: no leaf to edit in module %s\n", mod->name);
+            goto cleanup;
+        }
+    } else if (op == 'i') {
+        if (aydb_insert(first, count)) {
+            goto cleanup;
+        }
+    } else {
+        for (last = first; last->next && (last->next->schema == first->schema); last = last->next) {}
+        if (lyd_insert_before(first, last)) {
+            goto cleanup;
+        }
+    }
+
+    memset(&aydb_stats, 0, sizeof aydb_stats);
+    start = ayt_time_usec();
+    if (ds_plg->store_cb(mod, SR_DS_STARTUP, NULL, new_data)) {
+        goto cleanup;
+    }
+    usec = ayt_time_usec() - start;
+    if (aydb_phase_usec(AUGSTATS_PH_DIFF, &diff_usec) || aydb_phase_usec(AUGSTATS_PH_STORE_DIFF, &apply_usec) ||
+            aydb_phase_usec(AUGSTATS_PH_SAVE, &save_usec)) {
+        goto cleanup;
+    }
+
+    aydb_min(&res->usec, usec);
+    aydb_min(&res->diff_usec, diff_usec);
+    aydb_min(&res->apply_usec, apply_usec);
+    aydb_min(&res->save_usec, save_usec);
+    ret = 0;
+
+cleanup:
+    lyd_free_siblings(data);
+    lyd_free_siblings(new_data);
+    return ret;
+}
+
+/**
+ * @brief Benchmark a module, it is called in the child process.
+ *
+ * @param[in] arg Parameters of the benchmark, struct aydb_params.
+ * @param[in,out] result Result with the name and number of entries set, struct aydb_result.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+aydb_bench_module(void *arg, void *result)
+{
+    const struct srplg_ds_s *ds_plg = &srpds__;
+    const struct aydb_params *params = arg;
+    struct aydb_result *res = result;
+    struct ly_ctx *ctx = NULL;
+    const struct lys_module *mod;
+    struct lyd_node *data = NULL;
+    struct timeval times[2];
+    uint64_t start, usec;
+    uint32_t i;
+    int ret = 1;
+
+    sr_log_stderr(SR_LL_ERR);
+    ly_log_level(LY_LLERR);
+
+    if (ly_ctx_new(AUG_EXPECTED_YANG_DIR, 0, &ctx)) {
+        goto cleanup;
+    }
+    ly_ctx_set_searchdir(ctx, AUG_MODULES_DIR);
+    if (!(mod = ly_ctx_load_module(ctx, params->name, NULL, NULL))) {
+        goto cleanup;
+    }
+
+    /* cold load */
+    start = ayt_time_usec();
+    if (ds_plg->load_cb(mod, SR_DS_STARTUP, NULL, 0, &data)) {
+        goto cleanup;
+    }
+    res->load_cold_usec = ayt_time_usec() - start;
+    lyd_free_siblings(data);
+    data = NULL;
+
+    /* the plugin times its phases into the private statistics */
+    for (i = 0; (i < auginfo.mod_count) && (auginfo.mods[i].mod != mod); ++i) {}
+    if (i == auginfo.mod_count) {
+        goto cleanup;
+    }
+    auginfo.mods[i].stats = &aydb_stats;
+
+    for (i = 0; i < params->repeat; ++i) {
+        /* warm load */
+        start = ayt_time_usec();
+        if (ds_plg->load_cb(mod, SR_DS_STARTUP, NULL, 0, &data)) {
+            goto cleanup;
+        }
+        aydb_min(&res->load_warm_usec, ayt_time_usec() - start);
+        lyd_free_siblings(data);
+        data = NULL;
+
+        /* change the modification time so that augeas parses the file again */
+        gettimeofday(&times[0], NULL);
+        times[0].tv_sec += i + 1;
+        times[1] = times[0];
+        if (utimes(aydb_input_file, times) == -1) {
+            goto cleanup;
+        }
+        memset(&aydb_stats, 0, sizeof aydb_stats);
+        if (ds_plg->load_cb(mod, SR_DS_STARTUP, NULL, 0, &data) || aydb_phase_usec(AUGSTATS_PH_PARSE, &usec)) {
+            goto cleanup;
+        }
+        aydb_min(&res->parse_usec, usec);
+        lyd_free_siblings(data);
+        data = NULL;
+    }
+
+    for (i = 0; i < params->repeat; ++i) {
+        if (aydb_commit(mod, 'e', &res->edit) || aydb_commit(mod, 'i', &res->insert) ||
+                aydb_commit(mod, 'r', &res->reorder)) {
+            goto cleanup;
+        }
+    }
+    ret = 0;
+
+cleanup:
+    if (ret) {
+        fprintf(stderr, "ERROR: benchmark of module %s with %" PRIu32 " entries failed\n", params->name,
+                res->entries);
+    }
+    lyd_free_siblings(data);
+    augds_destroy(&auginfo);
+    ly_ctx_destroy(ctx);
+    return ret;
+}
+
+/**
+ * @brief Print a result line.
+ *
+ * @param[in] out Output.
+ * @param[in] res Result to print.
+ */
+static void
+aydb_print(FILE *out, const struct aydb_result *res)
+{
+    const struct aydb_commit *commits[] = {&res->edit, &res->insert, &res->reorder};
+    uint32_t i;
+
+    fprintf(out, "%s %" PRIu32 " %" PRIu64 " %" PRIu64 " %" PRIu64, res->name, res->entries, res->load_cold_usec,
+            res->load_warm_usec, res->parse_usec);
+    for (i = 0; i < sizeof commits / sizeof *commits; ++i) {
+        fprintf(out, " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64, commits[i]->usec, commits[i]->diff_usec,
+                commits[i]->apply_usec, commits[i]->save_usec);
+    }
+    fprintf(out, " %" PRIu64 "\n", res->peak_kb);
+}
+
+/**
+ * @brief Header of the result lines.
+ */
+#define AYDB_HEADER "# module entries load_cold load_warm parse edit edit_diff edit_apply edit_save insert " \
+    "insert_diff insert_apply insert_save reorder reorder_diff reorder_apply reorder_save peak_kb\n"
+
+/**
+ * @brief Benchmark a module with all the sizes.
+ *
+ * @param[in] gen Generator of the module.
+ * @param[in] dir Directory for the generated files.
+ * @param[in] sizes Sizes to use.
+ * @param[in] repeat Number of repetitions.
+ * @param[in] out Optional output file.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+aydb_bench_gen(const struct aydt_gen *gen, const char *dir, const char *sizes, uint32_t repeat, FILE *out)
+{
+    struct aydb_result res;
+    struct aydb_params params = {gen->module, repeat};
+    const char *ptr;
+    char *end, *newfile;
+    int ret = 0;
+
+    if (asprintf(&aydb_input_file, "%s/%s", dir, gen->module) == -1) {
+        return 1;
+    }
+
+    for (ptr = sizes; *ptr; ptr = (*end == ',') ? end + 1 : end) {
+        memset(&res, 0, sizeof res);
+        snprintf(res.name, sizeof res.name, "%s", gen->module);
+        res.entries = strtoul(ptr, &end, 10);
+        if ((end == ptr) || ((*end != ',') && *end)) {
+            fprintf(stderr, "ERROR: invalid sizes %s\n", sizes);
+            ret = 1;
+            break;
+        }
+
+        if (aydt_generate(gen, aydb_input_file, res.entries) ||
+                ayt_run_fork(aydb_bench_module, &params, &res, sizeof res, &res.peak_kb)) {
+            ret = 1;
+            continue;
+        }
+
+        aydb_print(stdout, &res);
+        if (out) {
+            aydb_print(out, &res);
+        }
+    }
+
+    /* remove the generated files */
+    unlink(aydb_input_file);
+    if (asprintf(&newfile, "%s.augnew", aydb_input_file) != -1) {
+        unlink(newfile);
+        free(newfile);
+    }
+    free(aydb_input_file);
+    aydb_input_file = NULL;
+    return ret;
+}
+
+int
+main(int argc, char **argv)
+{
+    int opt, ret = 0, i;
+    uint32_t j, repeat = AYDB_REPEAT;
+    const char *sizes = AYDB_SIZES, *write_path = NULL;
+    char dir[] = "/tmp/ay_dsbench_XXXXXX";
+    FILE *out = NULL;
+
+    struct option options[] = {
+        {"help",   0, 0, 'h'},
+        {"sizes",  1, 0, 'n'},
+        {"repeat", 1, 0, 'r'},
+        {"write",  1, 0, 'w'},
+        {0, 0, 0, 0}
+    };
+    int idx;
+
+    while ((opt = getopt_long(argc, argv, "hn:r:w:", options, &idx)) != -1) {
+        switch (opt) {
+        case 'n':
+            sizes = optarg;
+            break;
+        case 'r':
+            ret |= ayt_get_number(optarg, &repeat);
+            break;
+        case 'w':
+            write_path = optarg;
+            break;
+        case 'h':
+        default:
+            aydb_usage();
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if (ret || !repeat) {
+        aydb_usage();
+        return 1;
+    }
+
+    /* the benchmark is not counted in the statistics */
+    setenv(AUG_STATS_ENV, "", 1);
+
+    if (write_path && !(out = fopen(write_path, "w"))) {
+        fprintf(stderr, "ERROR: failed to open %s\n", write_path);
+        return 1;
+    }
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "ERROR: failed to create a directory (%s)\n", strerror(errno));
+        ret = 1;
+        goto cleanup;
+    }
+
+    printf("# %" PRIu32 " repetitions, times in usec\n", repeat);
+    printf(AYDB_HEADER);
+    if (out) {
+        fprintf(out, AYDB_HEADER);
+    }
+    for (j = 0; j < aydt_gen_count; ++j) {
+        if (optind < argc) {
+            /* only the selected modules */
+            for (i = optind; (i < argc) && strcmp(argv[i], aydt_gens[j].module); ++i) {}
+            if (i == argc) {
+                continue;
+            }
+        }
+
+        ret |= aydb_bench_gen(&aydt_gens[j], dir, sizes, repeat, out);
+    }
+    for (i = optind; i < argc; ++i) {
+        if (!aydt_gen_find(argv[i])) {
+            fprintf(stderr, "ERROR: no generator for module %s\n", argv[i]);
+            ret = 1;
+        }
+    }
+
+    rmdir(dir);
+
+cleanup:
+    if (out) {
+        fclose(out);
+    }
+    return ret;
+}
@@ -0,0 +1,641 @@
+/**
+ * @file ay_dsstress.c
+ * @author agent <agent@local>
+ * @brief Concurrency stress benchmark of the augeas DS plugin.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ *
+ * Several workers, threads or processes, perform a random mix of loads and commits of the selected modules, the same
+ * way several sysrepo sessions would. Every module has its own generated config file. Sysrepo module locks are
+ * emulated by flock(2) on a lock file per module, shared for loads and exclusive for commits, so the workers contend
+ * on the same module as they would in sysrepo but access different modules at once. The plugin keeps its state
+ * in a global variable and serializes its callbacks in a process, all the callbacks of all the workers can also be
+ * serialized by a global lock (-g). Build with -fsanitize=thread to have data races reported.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const char *ayst_input_files(const char *lens);
+
+/* augeas SR DS plugin, every lens loads the generated config file of its module */
+#define AUG_TEST_LENS_INPUT_FILES(lens) ayst_input_files(lens)
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include "ay_dstools.h"
+#include "ay_tools.h"
+#include "plg_config.h"
+
+#include <libyang/libyang.h>
+#include <sysrepo/plugins_datastore.h>
+
+/**
+ * @brief Name of the program.
+ */
+#define AYST_PROGNAME "ay_dsstress"
+
+/**
+ * @brief Maximum number of modules.
+ */
+#define AYST_MAX_MODULES 16
+
+/**
+ * @brief Modules used if none are selected.
+ */
+static const char * const ayst_default_mods[] = {"hosts", "passwd", "sysctl", "fstab"};
+
+/**
+ * @brief Module the workers use.
+ */
+struct ayst_module {
+    const struct aydt_gen *gen; /**< generator of its config file */
+    const struct lys_module *mod;   /**< loaded YANG module */
+    const char *lens;           /**< lens of the module */
+    char *file;                 /**< generated config file */
+    char *lock_file;            /**< file locked instead of the sysrepo module lock */
+};
+
+/**
+ * @brief Record of a single operation.
+ */
+struct ayst_op {
+    uint64_t usec;              /**< whole operation including the lock wait */
+    uint64_t wait_usec;         /**< waiting for the locks */
+    uint8_t store;              /**< whether it was a commit */
+    uint8_t failed;             /**< whether the operation failed */
+};
+
+/**
+ * @brief Worker parameters and the shared results.
+ */
+struct ayst_worker {
+    uint32_t idx;               /**< index of the worker */
+    uint32_t op_count;          /**< number of operations to perform */
+    uint32_t load_pct;          /**< percentage of loads among the operations */
+    int global_lock;            /**< whether to serialize all the plugin callbacks */
+    struct ayst_op *ops;        /**< operation records in shared memory */
+};
+
+/**
+ * @brief Modules the workers use.
+ */
+static struct ayst_module ayst_mods[AYST_MAX_MODULES];
+static uint32_t ayst_mod_count;
+
+/**
+ * @brief File locked by the global lock.
+ */
+static char *ayst_global_lock_file;
+
+/**
+ * @brief Print help.
+ */
+static void
+ayst_usage(void)
+{
+    const char *msg =
+            "Usage:\n"
+            "  " AYST_PROGNAME " [OPTIONS] [MODULE...]\n"
+            "\n"
+            "Stress the augeas DS plugin by concurrent loads and commits of the YANG modules. Without modules\n"
+            "hosts, passwd, sysctl, and fstab are used, a module may be repeated to be used more often. Prints\n"
+            "the throughput, latencies, and lock wait times in microseconds for loads and commits.\n"
+            "\nOptions:\n\n"
+            "  -t, --threads NUM    number of worker threads; default value: 4\n"
+            "  -p, --processes      workers are processes with their own plugin state instead of threads\n"
+            "  -o, --ops NUM        number of operations of every worker; default value: 200\n"
+            "  -l, --loads PCT      percentage of loads among the operations, the rest are commits; default value: 80\n"
+            "  -e, --entries NUM    number of entries of the generated config files; default value: 100\n"
+            "  -g, --global-lock    serialize all the plugin callbacks of all the workers\n"
+            "\nExample:\n"
+            AYST_PROGNAME " -t 8 -l 50 -g hosts hosts passwd\n";
+
+    fprintf(stderr, "%s", msg);
+}
+
+/**
+ * @brief Get the config file of a lens, used by the plugin instead of the system files.
+ *
+ * @param[in] lens Lens name.
+ * @return Generated config file, empty string if the lens is not used.
+ */
+static const char *
+ayst_input_files(const char *lens)
+{
+    uint32_t i;
+
+    for (i = 0; i < ayst_mod_count; ++i) {
+        if (ayst_mods[i].lens && !strcmp(ayst_mods[i].lens, lens)) {
+            return ayst_mods[i].file;
+        }
+    }
+
+    return "";
+}
+
+/**
+ * @brief Acquire a lock.
+ *
+ * @param[in] fd Opened lock file of the worker.
+ * @param[in] op Lock operation, LOCK_SH or LOCK_EX.
+ * @param[in,out] wait_usec Time spent waiting to add to.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ayst_lock(int fd, int op, uint64_t *wait_usec)
+{
+    uint64_t start;
+    int r;
+
+    start = ayt_time_usec();
+    while (((r = flock(fd, op)) == -1) && (errno == EINTR)) {}
+    *wait_usec += ayt_time_usec() - start;
+
+    return r;
+}
+
+/**
+ * @brief Commit a change of the module, the last list instance is moved to the beginning.
+ *
+ * @param[in] mod Module.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ayst_commit(const struct lys_module *mod)
+{
+    const struct srplg_ds_s *ds_plg = &srpds__;
+    struct lyd_node *data = NULL, *first, *last;
+    uint32_t count;
+    int ret = 1;
+
+    /* sysrepo loads the current data to apply the edit on */
+    if (ds_plg->load_cb(mod, SR_DS_STARTUP, NULL, 0, &data)) {
+        goto cleanup;
+    }
+
+    first = aydt_find_list(data, &count);
+    if (count < 2) {
+        fprintf(stderr, "ERROR: no list with more instances in module %s\n", mod->name);
+        goto cleanup;
+    }
+    for (last = first; last->next && (last->next->schema == first->schema); last = last->next) {}
+    if (lyd_insert_before(first, last)) {
+        goto cleanup;
+    }
+
+    if (ds_plg->store_cb(mod, SR_DS_STARTUP, NULL, data)) {
+        goto cleanup;
+    }
+    ret = 0;
+
+cleanup:
+    lyd_free_siblings(data);
+    return ret;
+}
+
+/**
+ * @brief Worker performing the operations.
+ *
+ * @param[in] arg Worker parameters.
+ * @return NULL.
+ */
+static void *
+ayst_worker(void *arg)
+{
+    const struct srplg_ds_s *ds_plg = &srpds__;
+    struct ayst_worker *w = arg;
+    struct ayst_op *op;
+    struct lyd_node *data;
+    int fds[AYST_MAX_MODULES], gfd = -1, lock_op;
+    uint64_t start;
+    uint32_t i, m;
+    unsigned int seed = w->idx + 1;
+
+    /* every worker has its own open file descriptions so that the flocks conflict even between threads */
+    for (m = 0; m < ayst_mod_count; ++m) {
+        fds[m] = open(ayst_mods[m].lock_file, O_RDWR);
+    }
+    if (w->global_lock) {
+        gfd = open(ayst_global_lock_file, O_RDWR);
+    }
+
+    for (i = 0; i < w->op_count; ++i) {
+        op = &w->ops[i];
+        m = rand_r(&seed) % ayst_mod_count;
+        op->store = ((uint32_t)(rand_r(&seed) % 100) >= w->load_pct);
+        lock_op = op->store ? LOCK_EX : LOCK_SH;
+
+        start = ayt_time_usec();
+        if ((fds[m] == -1) || ayst_lock(fds[m], lock_op, &op->wait_usec)) {
+            op->failed = 1;
+            continue;
+        }
+        if (w->global_lock && ((gfd == -1) || ayst_lock(gfd, LOCK_EX, &op->wait_usec))) {
+            op->failed = 1;
+            flock(fds[m], LOCK_UN);
+            continue;
+        }
+
+        if (op->store) {
+            op->failed = ayst_commit(ayst_mods[m].mod);
+        } else {
+            data = NULL;
+            op->failed = ds_plg->load_cb(ayst_mods[m].mod, SR_DS_STARTUP, NULL, 0, &data) ? 1 : 0;
+            lyd_free_siblings(data);
+        }
+
+        if (w->global_lock) {
+            flock(gfd, LOCK_UN);
+        }
+        flock(fds[m], LOCK_UN);
+        op->usec = ayt_time_usec() - start;
+    }
+
+    for (m = 0; m < ayst_mod_count; ++m) {
+        if (fds[m] > -1) {
+            close(fds[m]);
+        }
+    }
+    if (gfd > -1) {
+        close(gfd);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run the workers.
+ *
+ * @param[in] workers Workers to run.
+ * @param[in] worker_count Number of workers.
+ * @param[in] processes Whether to run the workers as processes instead of threads.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ayst_run(struct ayst_worker *workers, uint32_t worker_count, int processes)
+{
+    pthread_t *threads;
+    pid_t *pids;
+    uint32_t i, started;
+    int r, status, ret = 0;
+
+    if (processes) {
+        pids = calloc(worker_count, sizeof *pids);
+        if (!pids) {
+            return 1;
+        }
+        fflush(stdout);
+        for (started = 0; started < worker_count; ++started) {
+            pids[started] = fork();
+            if (pids[started] == -1) {
+                fprintf(stderr, "ERROR: fork failed (%s)\n", strerror(errno));
+                ret = 1;
+                break;
+            } else if (!pids[started]) {
+                /* child with its own plugin state */
+                ayst_worker(&workers[started]);
+                augds_destroy(&auginfo);
+                _exit(0);
+            }
+        }
+        for (i = 0; i < started; ++i) {
+            if ((waitpid(pids[i], &status, 0) == -1) || !WIFEXITED(status) || WEXITSTATUS(status)) {
+                fprintf(stderr, "ERROR: worker %" PRIu32 " terminated abnormally\n", i);
+                ret = 1;
+            }
+        }
+        free(pids);
+    } else {
+        threads = calloc(worker_count, sizeof *threads);
+        if (!threads) {
+            return 1;
+        }
+        for (started = 0; started < worker_count; ++started) {
+            r = pthread_create(&threads[started], NULL, ayst_worker, &workers[started]);
+            if (r) {
+                fprintf(stderr, "ERROR: creating thread failed (%s)\n", strerror(r));
+                ret = 1;
+                break;
+            }
+        }
+        for (i = 0; i < started; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        free(threads);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Compare two numbers for qsort().
+ */
+static int
+ayst_u64_cmp(const void *ptr1, const void *ptr2)
+{
+    uint64_t val1 = *(const uint64_t *)ptr1, val2 = *(const uint64_t *)ptr2;
+
+    return (val1 > val2) - (val1 < val2);
+}
+
+/**
+ * @brief Print the results of one kind of operations.
+ *
+ * @param[in] name Name of the operations.
+ * @param[in] ops All the operation records.
+ * @param[in] op_count Number of @p ops.
+ * @param[in] store Whether to print the commits or the loads.
+ * @param[in] wall_usec Duration of the whole run.
+ * @return Number of failed operations.
+ */
+static uint32_t
+ayst_print(const char *name, const struct ayst_op *ops, uint32_t op_count, int store, uint64_t wall_usec)
+{
+    uint64_t *lat, *wait, wait_sum = 0;
+    uint32_t i, count = 0, failed = 0;
+
+    lat = malloc(op_count * sizeof *lat);
+    wait = malloc(op_count * sizeof *wait);
+    if (!lat || !wait) {
+        free(lat);
+        free(wait);
+        return op_count;
+    }
+
+    for (i = 0; i < op_count; ++i) {
+        if (ops[i].store != store) {
+            continue;
+        } else if (ops[i].failed) {
+            ++failed;
+            continue;
+        }
+        lat[count] = ops[i].usec;
+        wait[count] = ops[i].wait_usec;
+        wait_sum += ops[i].wait_usec;
+        ++count;
+    }
+    qsort(lat, count, sizeof *lat, ayst_u64_cmp);
+    qsort(wait, count, sizeof *wait, ayst_u64_cmp);
+
+#define AYST_PCT(arr, pct) (count ? (arr)[((count - 1) * (pct)) / 100] : 0)
+    printf("%s %" PRIu32 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %"
+            PRIu64 " %" PRIu32 "\n", name, count, wall_usec ? (uint64_t)count * 1000000 / wall_usec : 0,
+            AYST_PCT(lat, 50), AYST_PCT(lat, 95), AYST_PCT(lat, 99), AYST_PCT(lat, 100),
+            count ? wait_sum / count : 0, AYST_PCT(wait, 99), AYST_PCT(wait, 100), failed);
+#undef AYST_PCT
+
+    free(lat);
+    free(wait);
+    return failed;
+}
+
+/**
+ * @brief Prepare a module, its config file, and its lock file.
+ *
+ * @param[in] ctx Context to load the module into.
+ * @param[in] name Module name.
+ * @param[in] dir Directory for the generated files.
+ * @param[in] entries Number of entries of the config file.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ayst_add_module(struct ly_ctx *ctx, const char *name, const char *dir, uint32_t entries)
+{
+    struct ayst_module *amod;
+    uint32_t i;
+    int fd;
+
+    for (i = 0; i < ayst_mod_count; ++i) {
+        if (!strcmp(ayst_mods[i].gen->module, name)) {
+            /* repeated module, used more often */
+            ayst_mods[ayst_mod_count] = ayst_mods[i];
+            ayst_mods[ayst_mod_count].file = NULL;
+            ayst_mods[ayst_mod_count].lock_file = NULL;
+            if (!(ayst_mods[ayst_mod_count].file = strdup(ayst_mods[i].file)) ||
+                    !(ayst_mods[ayst_mod_count].lock_file = strdup(ayst_mods[i].lock_file))) {
+                free(ayst_mods[ayst_mod_count].file);
+                return 1;
+            }
+            ++ayst_mod_count;
+            return 0;
+        }
+    }
+
+    amod = &ayst_mods[ayst_mod_count];
+    amod->gen = aydt_gen_find(name);
+    if (!amod->gen) {
+        fprintf(stderr, "ERROR: no generator for module %s\n", name);
+        return 1;
+    }
+
+    if (!(amod->mod = ly_ctx_load_module(ctx, name, NULL, NULL)) || augds_get_lens(amod->mod, &amod->lens)) {
+        fprintf(stderr, "ERROR: failed to load module %s\n", name);
+        return 1;
+    }
+    if ((asprintf(&amod->file, "%s/%s", dir, name) == -1) ||
+            (asprintf(&amod->lock_file, "%s/%s.lock", dir, name) == -1)) {
+        return 1;
+    }
+    ++ayst_mod_count;
+
+    if (aydt_generate(amod->gen, amod->file, entries)) {
+        return 1;
+    }
+    if ((fd = open(amod->lock_file, O_RDWR | O_CREAT, 0600)) == -1) {
+        fprintf(stderr, "ERROR: failed to create %s (%s)\n", amod->lock_file, strerror(errno));
+        return 1;
+    }
+    close(fd);
+
+    return 0;
+}
+
+/**
+ * @brief Header of the result lines.
+ */
+#define AYST_HEADER "# op count ops_per_sec p50 p95 p99 max wait_avg wait_p99 wait_max failed\n"
+
+int
+main(int argc, char **argv)
+{
+    int opt, ret = 0, processes = 0, global_lock = 0, fd;
+    uint32_t i, thread_count = 4, op_count = 200, load_pct = 80, entries = 100;
+    char dir[] = "/tmp/ay_dsstress_XXXXXX", *newfile;
+    struct ly_ctx *ctx = NULL;
+    struct ayst_worker *workers = NULL;
+    struct ayst_op *ops = MAP_FAILED;
+    size_t ops_size = 0;
+    uint64_t start, wall_usec;
+
+    struct option options[] = {
+        {"help",        0, 0, 'h'},
+        {"threads",     1, 0, 't'},
+        {"processes",   0, 0, 'p'},
+        {"ops",         1, 0, 'o'},
+        {"loads",       1, 0, 'l'},
+        {"entries",     1, 0, 'e'},
+        {"global-lock", 0, 0, 'g'},
+        {0, 0, 0, 0}
+    };
+    int idx;
+
+    while ((opt = getopt_long(argc, argv, "ht:po:l:e:g", options, &idx)) != -1) {
+        switch (opt) {
+        case 't':
+            ret |= ayt_get_number(optarg, &thread_count);
+            break;
+        case 'p':
+            processes = 1;
+            break;
+        case 'o':
+            ret |= ayt_get_number(optarg, &op_count);
+            break;
+        case 'l':
+            ret |= ayt_get_number(optarg, &load_pct);
+            break;
+        case 'e':
+            ret |= ayt_get_number(optarg, &entries);
+            break;
+        case 'g':
+            global_lock = 1;
+            break;
+        case 'h':
+        default:
+            ayst_usage();
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if (ret || !thread_count || !op_count || (load_pct > 100) || (entries < 2) ||
+            (argc - optind > AYST_MAX_MODULES)) {
+        ayst_usage();
+        return 1;
+    }
+
+    /* the stress test is not counted in the statistics */
+    setenv(AUG_STATS_ENV, "", 1);
+
+    sr_log_stderr(SR_LL_ERR);
+    ly_log_level(LY_LLERR);
+
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "ERROR: failed to create a directory (%s)\n", strerror(errno));
+        return 1;
+    }
+
+    /* the context is shared by all the workers and not modified anymore */
+    if (ly_ctx_new(AUG_EXPECTED_YANG_DIR, 0, &ctx)) {
+        ret = 1;
+        goto cleanup;
+    }
+    ly_ctx_set_searchdir(ctx, AUG_MODULES_DIR);
+    if (optind < argc) {
+        for (i = optind; i < (uint32_t)argc; ++i) {
+            if (ayst_add_module(ctx, argv[i], dir, entries)) {
+                ret = 1;
+                goto cleanup;
+            }
+        }
+    } else {
+        for (i = 0; i < sizeof ayst_default_mods / sizeof *ayst_default_mods; ++i) {
+            if (ayst_add_module(ctx, ayst_default_mods[i], dir, entries)) {
+                ret = 1;
+                goto cleanup;
+            }
+        }
+    }
+    if (global_lock) {
+        if ((asprintf(&ayst_global_lock_file, "%s/global.lock", dir) == -1) ||
+                ((fd = open(ayst_global_lock_file, O_RDWR | O_CREAT, 0600)) == -1)) {
+            ret = 1;
+            goto cleanup;
+        }
+        close(fd);
+    }
+
+    /* operation records are shared with the worker processes */
+    ops_size = (size_t)thread_count * op_count * sizeof *ops;
+    ops = mmap(NULL, ops_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    workers = calloc(thread_count, sizeof *workers);
+    if ((ops == MAP_FAILED) || !workers) {
+        fprintf(stderr, "ERROR: memory allocation failed\n");
+        ret = 1;
+        goto cleanup;
+    }
+    memset(ops, 0, ops_size);
+    for (i = 0; i < thread_count; ++i) {
+        workers[i].idx = i;
+        workers[i].op_count = op_count;
+        workers[i].load_pct = load_pct;
+        workers[i].global_lock = global_lock;
+        workers[i].ops = ops + (size_t)i * op_count;
+    }
+
+    start = ayt_time_usec();
+    ret = ayst_run(workers, thread_count, processes);
+    wall_usec = ayt_time_usec() - start;
+
+    printf("# %" PRIu32 " %s, %" PRIu32 " operations each, %" PRIu32 " %% loads, %" PRIu32 " modules, %s, "
+            "times in usec\n", thread_count, processes ? "processes" : "threads", op_count, load_pct, ayst_mod_count,
+            global_lock ? "global lock" : "module locks");
+    printf(AYST_HEADER);
+    if (ayst_print("load", ops, thread_count * op_count, 0, wall_usec) ||
+            ayst_print("store", ops, thread_count * op_count, 1, wall_usec)) {
+        ret = 1;
+    }
+
+cleanup:
+    if (ops != MAP_FAILED) {
+        munmap(ops, ops_size);
+    }
+    free(workers);
+    augds_destroy(&auginfo);
+    ly_ctx_destroy(ctx);
+
+    /* remove the generated files */
+    for (i = 0; i < ayst_mod_count; ++i) {
+        if (ayst_mods[i].file) {
+            unlink(ayst_mods[i].file);
+            if (asprintf(&newfile, "%s.augnew", ayst_mods[i].file) != -1) {
+                unlink(newfile);
+                free(newfile);
+            }
+        }
+        if (ayst_mods[i].lock_file) {
+            unlink(ayst_mods[i].lock_file);
+        }
+        free(ayst_mods[i].file);
+        free(ayst_mods[i].lock_file);
+    }
+    if (ayst_global_lock_file) {
+        unlink(ayst_global_lock_file);
+        free(ayst_global_lock_file);
+    }
+    rmdir(dir);
+    return ret;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file ay_dstools.c
+ * @author agent <agent@local>
+ * @brief Synthetic config files shared by the augeas DS plugin benchmarks.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <libyang/libyang.h>
+
+#include "ay_dstools.h"
+
+static void
+aydt_hosts(FILE *f, uint32_t i)
+{
+    fprintf(f, "10.%" PRIu32 ".%" PRIu32 ".%" PRIu32 "\thost%" PRIu32 " host%" PRIu32 ".example.com\n",
+            (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF, i, i);
+}
+
+static void
+aydt_passwd(FILE *f, uint32_t i)
+{
+    fprintf(f, "user%" PRIu32 ":x:%" PRIu32 ":%" PRIu32 ":Bench user %" PRIu32 ":/home/user%" PRIu32 ":/bin/sh\n",
+            i, 10000 + i, 10000 + i, i, i);
+}
+
+static void
+aydt_sshd(FILE *f, uint32_t i)
+{
+    fprintf(f, "AllowUsers user%" PRIu32 "\n", i);
+}
+
+static void
+aydt_sysctl(FILE *f, uint32_t i)
+{
+    fprintf(f, "net.bench.key%" PRIu32 " = %" PRIu32 "\n", i, i);
+}
+
+static void
+aydt_fstab(FILE *f, uint32_t i)
+{
+    fprintf(f, "/dev/disk/by-label/bench%" PRIu32 " /mnt/bench%" PRIu32 " ext4 defaults,noatime 0 2\n", i, i);
+}
+
+static void
+aydt_logrotate(FILE *f, uint32_t i)
+{
+    fprintf(f, "/var/log/bench%" PRIu32 ".log {\n\tweekly\n\trotate 4\n\tcompress\n\tmissingok\n}\n", i);
+}
+
+static void
+aydt_iptables(FILE *f, uint32_t i)
+{
+    fprintf(f, "-A INPUT -s 10.%" PRIu32 ".%" PRIu32 ".%" PRIu32 "/32 -p tcp -m tcp --dport %" PRIu32 " -j ACCEPT\n",
+            (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF, 1024 + (i % 64000));
+}
+
+const struct aydt_gen aydt_gens[] = {
+    {"hosts", NULL, aydt_hosts, NULL},
+    {"passwd", NULL, aydt_passwd, NULL},
+    {"sshd", NULL, aydt_sshd, NULL},
+    {"sysctl", NULL, aydt_sysctl, NULL},
+    {"fstab", NULL, aydt_fstab, NULL},
+    {"logrotate", NULL, aydt_logrotate, NULL},
+    {"iptables", "*filter\n:INPUT ACCEPT [0:0]\n:FORWARD ACCEPT [0:0]\n:OUTPUT ACCEPT [0:0]\n", aydt_iptables,
+        "COMMIT\n"},
+};
+
+const uint32_t aydt_gen_count = sizeof aydt_gens / sizeof *aydt_gens;
+
+const struct aydt_gen *
+aydt_gen_find(const char *module)
+{
+    uint32_t i;
+
+    for (i = 0; i < aydt_gen_count; ++i) {
+        if (!strcmp(aydt_gens[i].module, module)) {
+            return &aydt_gens[i];
+        }
+    }
+
+    return NULL;
+}
+
+int
+aydt_generate(const struct aydt_gen *gen, const char *path, uint32_t entries)
+{
+    FILE *f;
+    uint32_t i;
+
+    f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "ERROR: failed to open %s (%s)\n", path, strerror(errno));
+        return 1;
+    }
+
+    if (gen->header) {
+        fputs(gen->header, f);
+    }
+    for (i = 0; i < entries; ++i) {
+        gen->entry(f, i);
+    }
+    if (gen->footer) {
+        fputs(gen->footer, f);
+    }
+
+    fclose(f);
+    return 0;
+}
+
+struct lyd_node *
+aydt_find_list(const struct lyd_node *data, uint32_t *count)
+{
+    struct lyd_node *elem, *iter, *first = NULL;
+    uint32_t cnt;
+
+    *count = 0;
+    LYD_TREE_DFS_BEGIN(data, elem) {
+        if ((elem->schema->nodetype == LYS_LIST) && lysc_is_userordered(elem->schema) &&
+                (!elem->prev->next || (elem->prev->schema != elem->schema))) {
+            /* first instance, count them */
+            cnt = 0;
+            for (iter = elem; iter && (iter->schema == elem->schema); iter = iter->next) {
+                ++cnt;
+            }
+            if (cnt > *count) {
+                *count = cnt;
+                first = elem;
+            }
+        }
+        LYD_TREE_DFS_END(data, elem);
+    }
+
+    return first;
+}
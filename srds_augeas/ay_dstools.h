@@ -0,0 +1,72 @@
+/**
+ * @file ay_dstools.h
+ * @author agent <agent@local>
+ * @brief Synthetic config files shared by the augeas DS plugin benchmarks.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#ifndef AY_DSTOOLS_H_
+#define AY_DSTOOLS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <libyang/libyang.h>
+
+/**
+ * @brief Generator of synthetic config files for a module.
+ */
+struct aydt_gen {
+    const char *module;         /**< YANG module name */
+    const char *header;         /**< printed once at the beginning of the file */
+    void (*entry)(FILE *f, uint32_t i); /**< prints the i-th entry */
+    const char *footer;         /**< printed once at the end of the file */
+};
+
+/**
+ * @brief All the supported generators.
+ */
+extern const struct aydt_gen aydt_gens[];
+
+/**
+ * @brief Number of ::aydt_gens.
+ */
+extern const uint32_t aydt_gen_count;
+
+/**
+ * @brief Find the generator of a module.
+ *
+ * @param[in] module YANG module name.
+ * @return Generator, NULL if there is none.
+ */
+const struct aydt_gen *aydt_gen_find(const char *module);
+
+/**
+ * @brief Generate a config file.
+ *
+ * @param[in] gen Generator to use.
+ * @param[in] path Path of the file.
+ * @param[in] entries Number of entries.
+ * @return 0 on success, non-zero on error.
+ */
+int aydt_generate(const struct aydt_gen *gen, const char *path, uint32_t entries);
+
+/**
+ * @brief Find the first instance of the user-ordered list with the most instances.
+ *
+ * @param[in] data Loaded data.
+ * @param[out] count Number of the instances.
+ * @return First list instance, NULL if there is none.
+ */
+struct lyd_node *aydt_find_list(const struct lyd_node *data, uint32_t *count);
+
+#endif /* AY_DSTOOLS_H_ */
@@ -0,0 +1,412 @@
+/**
+ * @file ay_replay.c
+ * @author agent <agent@local>
+ * @brief Replay of the augeas DS plugin callbacks recorded in a trace.
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ *
+ * The trace is recorded by the plugin if SRDS_AUGEAS_TRACE is set, see struct augtrace. The callbacks are called in
+ * the same order with Augeas working with the snapshot directory as its root (AUGEAS_ROOT) so the config files of
+ * the snapshot are read and the stores modify them. The data of a recorded store diff are created the same way
+ * as by sysrepo, by applying the diff to the current data.
+ */
+
+#define _GNU_SOURCE
+
+/* augeas SR DS plugin */
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include "plg_config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <libyang/libyang.h>
+#include <sysrepo/plugins_datastore.h>
+
+/**
+ * @brief Name of the program.
+ */
+#define AYRP_PROGNAME "ay_replay"
+
+/**
+ * @brief Recorded callback.
+ */
+struct ayrp_record {
+    char cb[32];                /**< callback name */
+    char module[128];           /**< module name */
+    int ds;                     /**< datastore */
+    uint64_t timestamp;         /**< realtime of the recorded callback in microseconds */
+    uint64_t usec;              /**< recorded duration */
+    int rc;                     /**< recorded return code */
+    uint32_t xpath_count;       /**< count of xpaths */
+    char **xpaths;              /**< XPaths of a load */
+    uint32_t lyb_len;           /**< length of lyb */
+    char *lyb;                  /**< diff or data of a store in LYB */
+};
+
+/**
+ * @brief Summary of the replayed calls of a callback.
+ */
+struct ayrp_summary {
+    const char *cb;             /**< callback name */
+    uint32_t count;             /**< number of the calls */
+    uint32_t failed;            /**< number of the failed calls */
+    uint64_t rec_usec;          /**< total recorded duration */
+    uint64_t usec;              /**< total replayed duration */
+    uint64_t max_usec;          /**< longest replayed call */
+};
+
+/**
+ * @brief Print help.
+ */
+static void
+ayrp_usage(void)
+{
+    const char *msg =
+            "Usage:\n"
+            "  " AYRP_PROGNAME " [OPTIONS] TRACE\n"
+            "\n"
+            "Replay the augeas DS plugin callbacks recorded in TRACE with the " AUG_TRACE_ENV " environment\n"
+            "variable and print the recorded and replayed duration of every call in microseconds together\n"
+            "with the summary of all the callbacks.\n"
+            "\nOptions:\n\n"
+            "  -r, --root DIR       snapshot directory with the config files used as the Augeas root,\n"
+            "                       for example created by \"cp --parents /etc/hosts DIR\"; the stores modify it\n"
+            "  -q, --quiet          print only the summary\n"
+            "\nExample:\n"
+            AYRP_PROGNAME " -r /tmp/snapshot /tmp/srds_augeas.trace\n";
+
+    fprintf(stderr, "%s", msg);
+}
+
+/**
+ * @brief Get monotonic time in microseconds.
+ *
+ * @return Current time.
+ */
+static uint64_t
+ayrp_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Free a record.
+ *
+ * @param[in] rec Record to free.
+ */
+static void
+ayrp_record_free(struct ayrp_record *rec)
+{
+    uint32_t i;
+
+    for (i = 0; i < rec->xpath_count; ++i) {
+        free(rec->xpaths[i]);
+    }
+    free(rec->xpaths);
+    free(rec->lyb);
+    memset(rec, 0, sizeof *rec);
+}
+
+/**
+ * @brief Read the next record from the trace.
+ *
+ * @param[in] trace Opened trace.
+ * @param[out] rec Read record.
+ * @return 0 on success, 1 at the end of the trace, -1 on error.
+ */
+static int
+ayrp_record_read(FILE *trace, struct ayrp_record *rec)
+{
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t len;
+    uint32_t i;
+    int ret = -1;
+
+    memset(rec, 0, sizeof *rec);
+
+    if ((len = getline(&line, &size, trace)) == -1) {
+        free(line);
+        return 1;
+    }
+    if (sscanf(line, "%31s %127s %d %" SCNu64 " %" SCNu64 " %d %" SCNu32 " %" SCNu32, rec->cb, rec->module, &rec->ds,
+            &rec->timestamp, &rec->usec, &rec->rc, &rec->xpath_count, &rec->lyb_len) != 8) {
+        fprintf(stderr, "ERROR: invalid record \"%s\"\n", line);
+        rec->xpath_count = 0;
+        goto cleanup;
+    }
+
+    /* XPaths */
+    rec->xpaths = calloc(rec->xpath_count, sizeof *rec->xpaths);
+    if (rec->xpath_count && !rec->xpaths) {
+        rec->xpath_count = 0;
+        goto cleanup;
+    }
+    for (i = 0; i < rec->xpath_count; ++i) {
+        if ((len = getline(&line, &size, trace)) < 1) {
+            goto cleanup;
+        }
+        line[len - 1] = '\0';
+        if (!(rec->xpaths[i] = strdup(line))) {
+            goto cleanup;
+        }
+    }
+
+    /* LYB data with the terminating newline */
+    if (rec->lyb_len) {
+        rec->lyb = malloc(rec->lyb_len);
+        if (!rec->lyb || (fread(rec->lyb, 1, rec->lyb_len, trace) != rec->lyb_len)) {
+            goto cleanup;
+        }
+    }
+    if (fgetc(trace) != '\n') {
+        goto cleanup;
+    }
+    ret = 0;
+
+cleanup:
+    if (ret) {
+        if (!feof(trace)) {
+            fprintf(stderr, "ERROR: invalid record of \"%s\" callback\n", rec->cb);
+        } else {
+            fprintf(stderr, "ERROR: truncated trace\n");
+        }
+        ayrp_record_free(rec);
+    }
+    free(line);
+    return ret;
+}
+
+/**
+ * @brief Replay a store, the new data are created from the recorded diff or taken from the record.
+ *
+ * @param[in] mod Module.
+ * @param[in] rec Store record.
+ * @param[out] usec Duration of the store callback.
+ * @return SR_ERR value.
+ */
+static int
+ayrp_replay_store(const struct lys_module *mod, const struct ayrp_record *rec, uint64_t *usec)
+{
+    const struct srplg_ds_s *ds_plg = &srpds__;
+    struct lyd_node *tree = NULL, *data = NULL;
+    uint64_t start;
+    int rc;
+
+    if (rec->lyb_len && lyd_parse_data_mem(mod->ctx, rec->lyb, LYD_LYB, LYD_PARSE_ONLY, 0, &tree)) {
+        fprintf(stderr, "ERROR: failed to parse the recorded data of module %s\n", mod->name);
+        return SR_ERR_LY;
+    }
+
+    if (!strcmp(rec->cb, "store")) {
+        /* sysrepo has the current data, not part of the measurement */
+        if ((rc = ds_plg->load_cb(mod, rec->ds, NULL, 0, &data))) {
+            goto cleanup;
+        }
+        if (lyd_diff_apply_all(&data, tree)) {
+            fprintf(stderr, "ERROR: failed to apply the recorded diff of module %s\n", mod->name);
+            rc = SR_ERR_LY;
+            goto cleanup;
+        }
+
+        start = ayrp_time_usec();
+        rc = ds_plg->store_cb(mod, rec->ds, tree, data);
+        *usec = ayrp_time_usec() - start;
+    } else {
+        start = ayrp_time_usec();
+        rc = ds_plg->store_cb(mod, rec->ds, NULL, tree);
+        *usec = ayrp_time_usec() - start;
+    }
+
+cleanup:
+    lyd_free_siblings(tree);
+    lyd_free_siblings(data);
+    return rc;
+}
+
+/**
+ * @brief Replay a record.
+ *
+ * @param[in] ctx Context to load the modules into.
+ * @param[in] rec Record to replay.
+ * @param[out] usec Duration of the callback.
+ * @return SR_ERR value.
+ */
+static int
+ayrp_replay(struct ly_ctx *ctx, const struct ayrp_record *rec, uint64_t *usec)
+{
+    const struct srplg_ds_s *ds_plg = &srpds__;
+    const struct lys_module *mod;
+    struct lyd_node *data = NULL;
+    struct timespec mtime;
+    uint64_t start;
+    int rc, can_read, can_write;
+
+    *usec = 0;
+
+    if (!(mod = ly_ctx_get_module_implemented(ctx, rec->module)) &&
+            !(mod = ly_ctx_load_module(ctx, rec->module, NULL, NULL))) {
+        fprintf(stderr, "ERROR: failed to load module %s\n", rec->module);
+        return SR_ERR_NOT_FOUND;
+    }
+
+    if (!strcmp(rec->cb, "load")) {
+        start = ayrp_time_usec();
+        rc = ds_plg->load_cb(mod, rec->ds, (const char **)rec->xpaths, rec->xpath_count, &data);
+        *usec = ayrp_time_usec() - start;
+        lyd_free_siblings(data);
+    } else if (!strcmp(rec->cb, "store") || !strcmp(rec->cb, "store-data")) {
+        rc = ayrp_replay_store(mod, rec, usec);
+    } else if (!strcmp(rec->cb, "access-check")) {
+        start = ayrp_time_usec();
+        rc = ds_plg->access_check_cb(mod, rec->ds, &can_read, &can_write);
+        *usec = ayrp_time_usec() - start;
+    } else if (!strcmp(rec->cb, "last-modif")) {
+        start = ayrp_time_usec();
+        rc = ds_plg->last_modif_cb(mod, rec->ds, &mtime);
+        *usec = ayrp_time_usec() - start;
+    } else {
+        fprintf(stderr, "ERROR: unknown callback \"%s\"\n", rec->cb);
+        rc = SR_ERR_UNSUPPORTED;
+    }
+
+    return rc;
+}
+
+int
+main(int argc, char **argv)
+{
+    int opt, ret = 0, quiet = 0, r, rc;
+    const char *root = NULL;
+    FILE *trace = NULL;
+    struct ly_ctx *ctx = NULL;
+    struct ayrp_record rec = {0};
+    struct ayrp_summary sums[] = {
+        {.cb = "load"}, {.cb = "store"}, {.cb = "store-data"}, {.cb = "access-check"}, {.cb = "last-modif"}
+    }, *sum;
+    uint64_t usec;
+    uint32_t i, seq = 0;
+
+    struct option options[] = {
+        {"help",  0, 0, 'h'},
+        {"root",  1, 0, 'r'},
+        {"quiet", 0, 0, 'q'},
+        {0, 0, 0, 0}
+    };
+    int idx;
+
+    while ((opt = getopt_long(argc, argv, "hr:q", options, &idx)) != -1) {
+        switch (opt) {
+        case 'r':
+            root = optarg;
+            break;
+        case 'q':
+            quiet = 1;
+            break;
+        case 'h':
+        default:
+            ayrp_usage();
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if (optind != argc - 1) {
+        ayrp_usage();
+        return 1;
+    }
+
+    /* never record nor count the replay and use the snapshot */
+    unsetenv(AUG_TRACE_ENV);
+    setenv(AUG_STATS_ENV, "", 1);
+    if (root && setenv("AUGEAS_ROOT", root, 1)) {
+        fprintf(stderr, "ERROR: failed to set the Augeas root (%s)\n", strerror(errno));
+        return 1;
+    }
+
+    sr_log_stderr(SR_LL_ERR);
+    ly_log_level(LY_LLERR);
+
+    if (!(trace = fopen(argv[optind], "r"))) {
+        fprintf(stderr, "ERROR: failed to open %s (%s)\n", argv[optind], strerror(errno));
+        return 1;
+    }
+    if (ly_ctx_new(AUG_EXPECTED_YANG_DIR, 0, &ctx)) {
+        ret = 1;
+        goto cleanup;
+    }
+    ly_ctx_set_searchdir(ctx, AUG_MODULES_DIR);
+
+    if (!quiet) {
+        printf("# seq callback module recorded_usec usec rc\n");
+    }
+    while (!(r = ayrp_record_read(trace, &rec))) {
+        rc = ayrp_replay(ctx, &rec, &usec);
+        ++seq;
+
+        for (i = 0; (i < sizeof sums / sizeof *sums) && strcmp(sums[i].cb, rec.cb); ++i) {}
+        if (i < sizeof sums / sizeof *sums) {
+            sum = &sums[i];
+            ++sum->count;
+            if (rc) {
+                ++sum->failed;
+            }
+            sum->rec_usec += rec.usec;
+            sum->usec += usec;
+            if (usec > sum->max_usec) {
+                sum->max_usec = usec;
+            }
+        }
+        if (!quiet) {
+            printf("%" PRIu32 " %s %s %" PRIu64 " %" PRIu64 " %d\n", seq, rec.cb, rec.module, rec.usec, usec, rc);
+        }
+        if (rc && !rec.rc) {
+            /* the recorded call succeeded */
+            ret = 1;
+        }
+
+        ayrp_record_free(&rec);
+    }
+    if (r == -1) {
+        ret = 1;
+    }
+
+    printf("# callback count failed recorded_usec usec avg_usec max_usec\n");
+    for (i = 0; i < sizeof sums / sizeof *sums; ++i) {
+        if (!sums[i].count) {
+            continue;
+        }
+        printf("%s %" PRIu32 " %" PRIu32 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", sums[i].cb,
+                sums[i].count, sums[i].failed, sums[i].rec_usec, sums[i].usec, sums[i].usec / sums[i].count,
+                sums[i].max_usec);
+    }
+
+cleanup:
+    augds_destroy(&auginfo);
+    ly_ctx_destroy(ctx);
+    fclose(trace);
+    return ret;
+}
@@ -23,26 +23,296 @@
 
 #include "plg_config.h"
 
+#include <dirent.h>
+#include <errno.h>
+#include <getopt.h>
 #include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <libyang/libyang.h>
 #include <sysrepo/plugins_datastore.h>
 
-int
-main(int argc, const char **argv)
+static void
+ays_usage(void)
+{
+    printf("Usage: ay_startup [-h] [-a] [-f FORMAT] [-o DIR] [-j JOBS] [lens-name ...]\n\n"
+            "Print the current system configuration of Augeas lenses as YANG data.\n\n"
+            "  -h, --help           Print this help.\n"
+            "  -a, --all            Print the data of all the lenses with a YANG module.\n"
+            "  -f, --format FORMAT  Data format, one of \"xml\" (default), \"json\", and \"lyb\".\n"
+            "  -o, --outdir DIR     Print the data of every module into \"DIR/<module>.<format>\" instead of stdout.\n"
+            "  -j, --jobs JOBS      Number of processes converting the modules in parallel, requires -o.\n\n");
+}
+
+/**
+ * @brief Add all the lens modules from the YANG directory.
+ *
+ * @param[in,out] names Array of module names to add to.
+ * @param[in,out] name_count Count of @p names.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ays_add_all(char ***names, uint32_t *name_count)
+{
+    DIR *dir;
+    struct dirent *ent;
+    size_t len;
+    void *mem;
+    int ret = 0;
+
+    dir = opendir(AUG_EXPECTED_YANG_DIR);
+    if (!dir) {
+        fprintf(stderr, "Opening directory \"%s\" failed (%s).\n", AUG_EXPECTED_YANG_DIR, strerror(errno));
+        return 1;
+    }
+
+    while ((ent = readdir(dir))) {
+        len = strlen(ent->d_name);
+        if ((len < 6) || strcmp(ent->d_name + len - 5, ".yang")) {
+            continue;
+        }
+
+        mem = realloc(*names, (*name_count + 1) * sizeof **names);
+        if (!mem) {
+            ret = 1;
+            break;
+        }
+        *names = mem;
+        (*names)[*name_count] = strndup(ent->d_name, len - 5);
+        if (!(*names)[*name_count]) {
+            ret = 1;
+            break;
+        }
+        ++(*name_count);
+    }
+
+    closedir(dir);
+    return ret;
+}
+
+/**
+ * @brief Print data of a module.
+ *
+ * @param[in] data Data to print.
+ * @param[in] name Module name.
+ * @param[in] format Data format.
+ * @param[in] outdir Optional output directory, stdout is used if not set.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ays_print(const struct lyd_node *data, const char *name, LYD_FORMAT format, const char *outdir)
+{
+    char *path;
+    const char *ext;
+    int ret;
+
+    if (!outdir) {
+        return lyd_print_file(stdout, data, format, LYD_PRINT_WITHSIBLINGS) ? 1 : 0;
+    }
+
+    ext = (format == LYD_JSON) ? "json" : ((format == LYD_LYB) ? "lyb" : "xml");
+    if (asprintf(&path, "%s/%s.%s", outdir, name, ext) == -1) {
+        return 1;
+    }
+    ret = lyd_print_path(path, data, format, LYD_PRINT_WITHSIBLINGS) ? 1 : 0;
+    free(path);
+
+    return ret;
+}
+
+/**
+ * @brief Load and print the data of modules. The augeas plugin is initialized only once for all of them.
+ *
+ * @param[in] mods Modules to process, NULL items are skipped.
+ * @param[in] mod_count Count of @p mods.
+ * @param[in] job Index of this job, only every @p job_count -th module starting with @p job is processed.
+ * @param[in] job_count Number of jobs.
+ * @param[in] format Data format.
+ * @param[in] outdir Optional output directory, all the data are printed into stdout at once if not set.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ays_process(const struct lys_module **mods, uint32_t mod_count, uint32_t job, uint32_t job_count, LYD_FORMAT format,
+        const char *outdir)
 {
+    const struct srplg_ds_s *ds_plg = &srpds__;
+    struct lyd_node *data = NULL, *all_data = NULL;
+    uint32_t i;
     int ret = 0;
+
+    for (i = job; i < mod_count; i += job_count) {
+        if (!mods[i]) {
+            continue;
+        }
+
+        /* load calback */
+        if (ds_plg->load_cb(mods[i], SR_DS_STARTUP, NULL, 0, &data)) {
+            fprintf(stderr, "Loading data of module \"%s\" failed.\n", mods[i]->name);
+            ret = 1;
+            continue;
+        }
+
+        if (outdir) {
+            /* print data of every module separately */
+            if (ays_print(data, mods[i]->name, format, outdir)) {
+                ret = 1;
+            }
+            lyd_free_siblings(data);
+        } else if (data) {
+            /* print all the data together */
+            lyd_insert_sibling(all_data, data, &all_data);
+        }
+        data = NULL;
+    }
+
+    if (!outdir && ays_print(all_data, NULL, format, NULL)) {
+        ret = 1;
+    }
+
+    lyd_free_siblings(all_data);
+    augds_destroy(&auginfo);
+    return ret;
+}
+
+/**
+ * @brief Process the modules by several processes in parallel, each with its own augeas plugin.
+ *
+ * @param[in] mods Modules to process.
+ * @param[in] mod_count Count of @p mods.
+ * @param[in] job_count Number of processes.
+ * @param[in] format Data format.
+ * @param[in] outdir Output directory.
+ * @return 0 on success, non-zero on error.
+ */
+static int
+ays_process_parallel(const struct lys_module **mods, uint32_t mod_count, uint32_t job_count, LYD_FORMAT format,
+        const char *outdir)
+{
+    pid_t *pids;
+    uint32_t i;
+    int status, ret = 0;
+
+    pids = calloc(job_count, sizeof *pids);
+    if (!pids) {
+        return 1;
+    }
+
+    for (i = 0; i < job_count; ++i) {
+        pids[i] = fork();
+        if (pids[i] == -1) {
+            fprintf(stderr, "Fork failed (%s).\n", strerror(errno));
+            ret = 1;
+            break;
+        } else if (!pids[i]) {
+            /* child */
+            _exit(ays_process(mods, mod_count, i, job_count, format, outdir));
+        }
+    }
+
+    /* wait for all the started children */
+    for (i = 0; (i < job_count) && (pids[i] > 0); ++i) {
+        if ((waitpid(pids[i], &status, 0) == -1) || !WIFEXITED(status) || WEXITSTATUS(status)) {
+            ret = 1;
+        }
+    }
+
+    free(pids);
+    return ret;
+}
+
+int
+main(int argc, char **argv)
+{
+    int ret = 0, opt, all = 0;
     struct ly_ctx *ctx = NULL;
-    const struct lys_module *mod;
-    struct lyd_node *data = NULL;
-    const struct srplg_ds_s *ds_plg;
+    const struct lys_module **mods = NULL;
+    char **names = NULL, *ptr;
+    void *mem;
+    uint32_t i, name_count = 0, job_count = 1;
+    LYD_FORMAT format = LYD_XML;
+    const char *outdir = NULL;
 
-    if (argc != 2) {
-        printf("Usage: ay_startup lens-name\n\n");
+    struct option options[] = {
+        {"help",   0, 0, 'h'},
+        {"all",    0, 0, 'a'},
+        {"format", 1, 0, 'f'},
+        {"jobs",   1, 0, 'j'},
+        {"outdir", 1, 0, 'o'},
+        {0, 0, 0, 0}
+    };
+
+    while ((opt = getopt_long(argc, argv, "haf:j:o:", options, NULL)) != -1) {
+        switch (opt) {
+        case 'a':
+            all = 1;
+            break;
+        case 'f':
+            if (!strcmp(optarg, "xml")) {
+                format = LYD_XML;
+            } else if (!strcmp(optarg, "json")) {
+                format = LYD_JSON;
+            } else if (!strcmp(optarg, "lyb")) {
+                format = LYD_LYB;
+            } else {
+                fprintf(stderr, "Unknown format \"%s\".\n", optarg);
+                ret = 1;
+                goto cleanup;
+            }
+            break;
+        case 'j':
+            job_count = strtoul(optarg, &ptr, 10);
+            if (*ptr || !job_count) {
+                fprintf(stderr, "Invalid number of jobs \"%s\".\n", optarg);
+                ret = 1;
+                goto cleanup;
+            }
+            break;
+        case 'o':
+            outdir = optarg;
+            break;
+        case 'h':
+        default:
+            ays_usage();
+            ret = (opt == 'h') ? 0 : 1;
+            goto cleanup;
+        }
+    }
+
+    if ((job_count > 1) && !outdir) {
+        fprintf(stderr, "Parallel jobs require an output directory.\n");
         ret = 1;
         goto cleanup;
     }
 
+    /* collect the module names */
+    if (all && ays_add_all(&names, &name_count)) {
+        ret = 1;
+        goto cleanup;
+    }
+    for (i = optind; i < (uint32_t)argc; ++i) {
+        mem = realloc(names, (name_count + 1) * sizeof *names);
+        if (!mem) {
+            ret = 1;
+            goto cleanup;
+        }
+        names = mem;
+        names[name_count] = strdup(argv[i]);
+        if (!names[name_count]) {
+            ret = 1;
+            goto cleanup;
+        }
+        ++name_count;
+    }
+    if (!name_count) {
+        ays_usage();
+        ret = 1;
+        goto cleanup;
+    }
+
+    /* the installation is not counted in the statistics */
+    setenv(AUG_STATS_ENV, "", 1);
+
     /* logging */
     sr_log_stderr(SR_LL_WRN);
     ly_log_options(LY_LOLOG | LY_LOSTORE_LAST);
@@ -55,30 +325,33 @@ main(int argc, const char **argv)
     }
     ly_ctx_set_searchdir(ctx, AUG_MODULES_DIR);
 
-    /* load module */
-    mod = ly_ctx_load_module(ctx, argv[1], NULL, NULL);
-    if (!mod) {
+    /* load all the modules, before forking so that it is done only once */
+    mods = calloc(name_count, sizeof *mods);
+    if (!mods) {
         ret = 1;
         goto cleanup;
     }
-
-    /* plugin */
-    ds_plg = &srpds__;
-
-    /* load calback */
-    if (ds_plg->load_cb(mod, SR_DS_STARTUP, NULL, 0, &data)) {
-        ret = 1;
-        goto cleanup;
+    for (i = 0; i < name_count; ++i) {
+        mods[i] = ly_ctx_load_module(ctx, names[i], NULL, NULL);
+        if (!mods[i]) {
+            fprintf(stderr, "Loading module \"%s\" failed.\n", names[i]);
+            ret = 1;
+        }
     }
 
-    /* print data */
-    if (lyd_print_file(stdout, data, LYD_XML, LYD_PRINT_WITHSIBLINGS)) {
-        ret = 1;
-        goto cleanup;
+    /* load and print the data */
+    if (job_count > 1) {
+        ret |= ays_process_parallel(mods, name_count, job_count, format, outdir);
+    } else {
+        ret |= ays_process(mods, name_count, 0, 1, format, outdir);
     }
 
 cleanup:
-    lyd_free_siblings(data);
+    for (i = 0; i < name_count; ++i) {
+        free(names[i]);
+    }
+    free(names);
+    free(mods);
     ly_ctx_destroy(ctx);
     return ret;
 }
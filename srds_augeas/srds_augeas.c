@@ -20,9 +20,14 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <augeas.h>
@@ -32,6 +37,13 @@
 
 static struct auginfo auginfo;
 
+/* lock serializing all the callbacks using auginfo, they may be called by several threads */
+static pthread_mutex_t auglock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct augtrace augtrace;
+
+static struct augwarm augwarm = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
 static int srpds_aug_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpaths, uint32_t xpath_count,
         struct lyd_node **mod_data);
 
@@ -58,23 +70,278 @@ srpds_aug_install(const struct lys_module *mod, sr_datastore_t ds, const char *o
 static int
 srpds_aug_uninstall(const struct lys_module *mod, sr_datastore_t ds)
 {
-    (void)mod;
+    uint32_t i;
+
     (void)ds;
 
+    /* do not warm up the module anymore */
+    pthread_mutex_lock(&augwarm.lock);
+    for (i = 0; i < augwarm.mod_count; ) {
+        if (!strcmp(augwarm.mods[i].mod_name, mod->name)) {
+            augds_init_lens_free(&augwarm.mods[i]);
+            --augwarm.mod_count;
+            memmove(&augwarm.mods[i], &augwarm.mods[i + 1], (augwarm.mod_count - i) * sizeof *augwarm.mods);
+        } else {
+            ++i;
+        }
+    }
+    pthread_mutex_unlock(&augwarm.lock);
+
     /* destroy the cache, nothing else, keep the config files as they are */
+    pthread_mutex_lock(&auglock);
     augds_destroy(&auginfo);
+    pthread_mutex_unlock(&auglock);
 
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Learn whether a module is in the list of the modules to warm up.
+ *
+ * @param[in] name Module name.
+ * @return Whether to warm up the module.
+ */
 static int
-srpds_aug_init(const struct lys_module *mod, sr_datastore_t ds)
+srpds_aug_warmup_wanted(const char *name)
 {
-    (void)mod;
-    (void)ds;
+    const char *list, *ptr;
+    size_t len;
+
+    list = getenv(AUG_WARMUP_ENV);
+    if (!list) {
+        return 0;
+    } else if (!strcmp(list, "all")) {
+        return 1;
+    }
+
+    /* modules separated by spaces or commas */
+    len = strlen(name);
+    for (ptr = strstr(list, name); ptr; ptr = strstr(ptr + len, name)) {
+        if (((ptr == list) || (ptr[-1] == ' ') || (ptr[-1] == ',')) &&
+                (!ptr[len] || (ptr[len] == ' ') || (ptr[len] == ','))) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Thread parsing the config files of the queued modules until there are none or it is stopped.
+ *
+ * @param[in] arg Unused.
+ * @return NULL.
+ */
+static void *
+srpds_aug_warmup_thread(void *arg)
+{
+    struct auglens auglens;
+    uint64_t start;
+    int rc;
+
+    (void)arg;
+
+    while (1) {
+        /* dequeue the next module */
+        pthread_mutex_lock(&augwarm.lock);
+        if (augwarm.stop || !augwarm.mod_count) {
+            augwarm.running = 0;
+            pthread_mutex_unlock(&augwarm.lock);
+            break;
+        }
+        auglens = augwarm.mods[0];
+        --augwarm.mod_count;
+        memmove(augwarm.mods, augwarm.mods + 1, augwarm.mod_count * sizeof *augwarm.mods);
+        pthread_mutex_unlock(&augwarm.lock);
+
+        /* load its lens and parse its config files, the first callback finds them parsed */
+        start = augds_stats_time();
+        pthread_mutex_lock(&auglock);
+        if ((rc = augds_init_lens(&auginfo, &auglens))) {
+            augds_destroy(&auginfo);
+        }
+        pthread_mutex_unlock(&auglock);
+
+        if (rc) {
+            SRPLG_LOG_WRN(srpds_name, "Warming up module \"%s\" failed.", auglens.mod_name);
+        } else {
+            SRPLG_LOG_INF(srpds_name, "Module \"%s\" warmed up in %" PRIu64 " ms.", auglens.mod_name,
+                    (augds_stats_time() - start) / 1000);
+        }
+        augds_init_lens_free(&auglens);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Queue a module to be warmed up in the background, the thread is started if not running.
+ *
+ * @param[in] mod Module to warm up, only its Augeas transform is queued.
+ */
+static void
+srpds_aug_warmup(const struct lys_module *mod)
+{
+    void *mem;
+    uint32_t i;
+    int r;
+
+    pthread_mutex_lock(&augwarm.lock);
+
+    if (augwarm.stop) {
+        /* the plugin is being unloaded */
+        goto cleanup;
+    }
+
+    for (i = 0; i < augwarm.mod_count; ++i) {
+        if (!strcmp(augwarm.mods[i].mod_name, mod->name)) {
+            /* already queued */
+            goto cleanup;
+        }
+    }
+
+    mem = realloc(augwarm.mods, (augwarm.mod_count + 1) * sizeof *augwarm.mods);
+    if (!mem) {
+        AUG_LOG_ERRMEM;
+        goto cleanup;
+    }
+    augwarm.mods = mem;
+    if (augds_init_lens_get(mod, &augwarm.mods[augwarm.mod_count])) {
+        goto cleanup;
+    }
+    ++augwarm.mod_count;
+
+    if (!augwarm.running) {
+        if (augwarm.started) {
+            /* the previous thread found the queue empty and is finishing */
+            pthread_join(augwarm.tid, NULL);
+            augwarm.started = 0;
+        }
+
+        if ((r = pthread_create(&augwarm.tid, NULL, srpds_aug_warmup_thread, NULL))) {
+            SRPLG_LOG_WRN(srpds_name, "Creating the warm-up thread failed (%s).", strerror(r));
+            for (i = 0; i < augwarm.mod_count; ++i) {
+                augds_init_lens_free(&augwarm.mods[i]);
+            }
+            augwarm.mod_count = 0;
+        } else {
+            augwarm.started = 1;
+            augwarm.running = 1;
+        }
+    }
+
+cleanup:
+    pthread_mutex_unlock(&augwarm.lock);
+}
+
+/**
+ * @brief Stop the warm-up thread when the plugin is unloaded, the queued modules are not warmed up anymore.
+ *
+ * The thread must not run the code of the plugin after it is unloaded.
+ */
+static void __attribute__((destructor))
+srpds_aug_warmup_stop(void)
+{
+    uint32_t i;
+    int started;
+
+    pthread_mutex_lock(&augwarm.lock);
+    augwarm.stop = 1;
+    started = augwarm.started;
+    augwarm.started = 0;
+    for (i = 0; i < augwarm.mod_count; ++i) {
+        augds_init_lens_free(&augwarm.mods[i]);
+    }
+    free(augwarm.mods);
+    augwarm.mods = NULL;
+    augwarm.mod_count = 0;
+    pthread_mutex_unlock(&augwarm.lock);
 
+    /* wait for the module being warmed up */
+    if (started) {
+        pthread_join(augwarm.tid, NULL);
+    }
+}
+
+static int
+srpds_aug_init(const struct lys_module *mod, sr_datastore_t ds)
+{
     /* no initialization tasks to perform, the config files are persistent and must already exist */
 
+    /* but the config files can be parsed before the module is used */
+    if ((ds == SR_DS_STARTUP) && srpds_aug_warmup_wanted(mod->name)) {
+        srpds_aug_warmup(mod);
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Record a finished phase of a callback into the statistics of its module.
+ *
+ * @param[in] augmod Module of the callback.
+ * @param[in] phase Phase.
+ * @param[in] start Start of the phase.
+ */
+static void
+srpds_aug_stats_phase(const struct augmod *augmod, enum augstats_phase phase, uint64_t start)
+{
+    if (augmod->stats) {
+        augds_stats_lat(&augmod->stats->phases[phase], augds_stats_time() - start);
+    }
+}
+
+/**
+ * @brief Count all the nodes of a data tree.
+ *
+ * @param[in] tree Data tree with siblings.
+ * @return Number of nodes.
+ */
+static uint64_t
+srpds_aug_stats_count(const struct lyd_node *tree)
+{
+    const struct lyd_node *root;
+    struct lyd_node *elem;
+    uint64_t count = 0;
+
+    LY_LIST_FOR(tree, root) {
+        LYD_TREE_DFS_BEGIN(root, elem) {
+            ++count;
+            LYD_TREE_DFS_END(root, elem);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Reload the augeas data if some config files changed, always unless they are watched.
+ *
+ * @param[in] augmod Module to be loaded.
+ * @return SR error code.
+ */
+static int
+srpds_aug_reload(struct augmod *augmod)
+{
+    int rc;
+    uint64_t start;
+
+    if (!augds_watch_reload(&auginfo, augmod->mod)) {
+        /* no changes but the errors of the previous aug_load() are kept, reset the error of any previous call */
+        aug_get(auginfo.aug, "/augeas/root", NULL);
+        return augds_check_erraug(auginfo.aug);
+    }
+
+    start = augds_stats_time();
+    aug_load(auginfo.aug);
+    if ((rc = augds_check_erraug(auginfo.aug))) {
+        return rc;
+    }
+    srpds_aug_stats_phase(augmod, AUGSTATS_PH_PARSE, start);
+
+    /* account the reloaded data */
+    augds_mem_update(&auginfo, augmod);
+
     return SR_ERR_OK;
 }
 
@@ -84,14 +351,16 @@ srpds_aug_store(const struct lys_module *mod, sr_datastore_t ds, const struct ly
 {
     int rc = SR_ERR_OK;
     struct lyd_node *cur_data = NULL, *diff = NULL, *root;
+    struct augmod *augmod = NULL;
     struct ly_set *set = NULL;
     char *aug_file = NULL;
+    uint64_t start;
     uint32_t i;
 
     (void)mod_diff;
 
     /* init */
-    if ((rc = augds_init(&auginfo, mod, NULL))) {
+    if ((rc = augds_init(&auginfo, mod, &augmod))) {
         goto cleanup;
     }
 
@@ -101,19 +370,25 @@ srpds_aug_store(const struct lys_module *mod, sr_datastore_t ds, const struct ly
     }
 
     /* get diff with the updated data */
+    start = augds_stats_time();
     if (lyd_diff_siblings(cur_data, mod_data, 0, &diff)) {
         AUG_LOG_ERRLY_GOTO(mod->ctx, rc, cleanup);
     }
+    srpds_aug_stats_phase(augmod, AUGSTATS_PH_DIFF, start);
     if (!diff) {
         /* no changes */
         goto cleanup;
     }
+    if (augmod->stats) {
+        augds_stats_add(&augmod->stats->diff_nodes, srpds_aug_stats_count(diff));
+    }
 
     /* get all the changed files */
     if (lyd_find_xpath(diff, "/*/config-file", &set)) {
         AUG_LOG_ERRLY_GOTO(LYD_CTX(diff), rc, cleanup);
     }
 
+    start = augds_stats_time();
     for (i = 0; i < set->count; ++i) {
         /* get augeas file path */
         if (asprintf(&aug_file, "/files%s", lyd_get_value(set->dnodes[i])) == -1) {
@@ -134,13 +409,20 @@ srpds_aug_store(const struct lys_module *mod, sr_datastore_t ds, const struct ly
         free(aug_file);
         aug_file = NULL;
     }
+    srpds_aug_stats_phase(augmod, AUGSTATS_PH_STORE_DIFF, start);
 
     /* store new augeas data */
+    start = augds_stats_time();
     if (aug_save(auginfo.aug) == -1) {
         AUG_LOG_ERRAUG_GOTO(auginfo.aug, rc, cleanup);
     }
+    srpds_aug_stats_phase(augmod, AUGSTATS_PH_SAVE, start);
 
 cleanup:
+    if (rc && augmod) {
+        /* the augeas data may have been modified, discard them on the next load */
+        augds_watch_changed(&auginfo, mod);
+    }
     lyd_free_siblings(cur_data);
     lyd_free_siblings(diff);
     ly_set_free(set, NULL);
@@ -156,9 +438,11 @@ srpds_aug_recover(const struct lys_module *mod, sr_datastore_t ds)
     char *bck_path = NULL;
     struct lyd_node *mod_data = NULL;
 
+    pthread_mutex_lock(&auglock);
+
     /* init */
     if (augds_init(&auginfo, mod, NULL)) {
-        return;
+        goto cleanup;
     }
 
     /* check whether the file(s) is valid */
@@ -205,6 +489,7 @@ cleanup:
     free(files);
     free(bck_path);
     lyd_free_all(mod_data);
+    pthread_mutex_unlock(&auglock);
 }
 
 static int
@@ -215,6 +500,7 @@ srpds_aug_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpa
     uint32_t i, file_count;
     struct augmod *augmod;
     const char **files = NULL;
+    uint64_t start;
 
     (void)mod;
     (void)ds;
@@ -229,8 +515,7 @@ srpds_aug_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpa
     }
 
     /* reload data if they changed */
-    aug_load(auginfo.aug);
-    if ((rc = augds_check_erraug(auginfo.aug))) {
+    if ((rc = srpds_aug_reload(augmod))) {
         goto cleanup;
     }
 
@@ -239,6 +524,7 @@ srpds_aug_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpa
         goto cleanup;
     }
 
+    start = augds_stats_time();
     for (i = 0; i < file_count; ++i) {
         /* transform augeas context data to YANG data */
         if ((rc = augds_aug2yang_augnode_r(auginfo.aug, augmod->toplevel, augmod->toplevel_count, files[i],
@@ -246,6 +532,10 @@ srpds_aug_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpa
             goto cleanup;
         }
     }
+    srpds_aug_stats_phase(augmod, AUGSTATS_PH_AUG2YANG, start);
+    if (augmod->stats) {
+        augds_stats_add(&augmod->stats->loaded_nodes, srpds_aug_stats_count(*mod_data));
+    }
 
     /* assume valid */
     assert(!lyd_validate_module(mod_data, augmod->mod, LYD_VALIDATE_NO_STATE, NULL));
@@ -296,6 +586,8 @@ srpds_aug_access_set(const struct lys_module *mod, sr_datastore_t ds, const char
     (void)ds;
     assert(mod && (owner || group || perm));
 
+    pthread_mutex_lock(&auglock);
+
     /* init */
     if ((rc = augds_init(&auginfo, mod, NULL))) {
         goto cleanup;
@@ -318,6 +610,7 @@ srpds_aug_access_set(const struct lys_module *mod, sr_datastore_t ds, const char
 
 cleanup:
     free(files);
+    pthread_mutex_unlock(&auglock);
     return rc;
 }
 
@@ -338,6 +631,8 @@ srpds_aug_access_get(const struct lys_module *mod, sr_datastore_t ds, char **own
         *group = NULL;
     }
 
+    pthread_mutex_lock(&auglock);
+
     /* init */
     if ((rc = augds_init(&auginfo, mod, NULL))) {
         goto cleanup;
@@ -398,6 +693,7 @@ cleanup:
         free(*group);
         *group = NULL;
     }
+    pthread_mutex_unlock(&auglock);
     return rc;
 }
 
@@ -485,8 +781,7 @@ srpds_aug_last_modif(const struct lys_module *mod, sr_datastore_t ds, struct tim
     }
 
     /* reload data if they changed */
-    aug_load(auginfo.aug);
-    if ((rc = augds_check_erraug(auginfo.aug))) {
+    if ((rc = srpds_aug_reload(augmod))) {
         goto cleanup;
     }
 
@@ -512,19 +807,198 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Open the trace on the first call.
+ *
+ * @return Whether the callbacks are being recorded.
+ */
+static int
+srpds_aug_trace_open(void)
+{
+    const char *path;
+
+    if (!augtrace.init) {
+        augtrace.init = 1;
+        augtrace.fd = -1;
+        if ((path = getenv(AUG_TRACE_ENV)) && path[0]) {
+            augtrace.fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+            if (augtrace.fd == -1) {
+                SRPLG_LOG_WRN(srpds_name, "Opening trace \"%s\" failed (%s).", path, strerror(errno));
+            }
+        }
+    }
+
+    return augtrace.fd > -1;
+}
+
+/**
+ * @brief Record a finished callback into the trace, if recording.
+ *
+ * @param[in] cb Callback name.
+ * @param[in] mod Module of the callback.
+ * @param[in] ds Datastore of the callback.
+ * @param[in] usec Duration of the callback.
+ * @param[in] rc Return code of the callback.
+ * @param[in] xpaths Optional XPaths of the callback.
+ * @param[in] xpath_count Count of @p xpaths.
+ * @param[in] tree Optional data tree of the callback.
+ */
+static void
+srpds_aug_trace(const char *cb, const struct lys_module *mod, sr_datastore_t ds, uint64_t usec, int rc,
+        const char **xpaths, uint32_t xpath_count, const struct lyd_node *tree)
+{
+    struct timespec ts;
+    char *lyb = NULL, *buf = NULL;
+    size_t buf_len;
+    int lyb_len = 0;
+    uint32_t i;
+    FILE *f;
+
+    if (!srpds_aug_trace_open()) {
+        return;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    if (tree) {
+        if (lyd_print_mem(&lyb, tree, LYD_LYB, LYD_PRINT_WITHSIBLINGS)) {
+            SRPLG_LOG_WRN(srpds_name, "Recording \"%s\" data failed.", cb);
+        } else {
+            lyb_len = lyd_lyb_data_length(lyb);
+        }
+    }
+
+    f = open_memstream(&buf, &buf_len);
+    if (!f) {
+        AUG_LOG_ERRMEM;
+        goto cleanup;
+    }
+    fprintf(f, "%s %s %d %" PRIu64 " %" PRIu64 " %d %" PRIu32 " %d\n", cb, mod->name, (int)ds,
+            (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000, usec, rc, xpath_count, (lyb_len > 0) ? lyb_len : 0);
+    for (i = 0; i < xpath_count; ++i) {
+        fprintf(f, "%s\n", xpaths[i]);
+    }
+    if (lyb_len > 0) {
+        fwrite(lyb, 1, lyb_len, f);
+    }
+    fputc('\n', f);
+    fclose(f);
+
+    /* single append so that the records of several processes sharing the trace are not interleaved */
+    if (write(augtrace.fd, buf, buf_len) != (ssize_t)buf_len) {
+        SRPLG_LOG_WRN(srpds_name, "Recording \"%s\" failed (%s).", cb, strerror(errno));
+    }
+
+cleanup:
+    free(lyb);
+    free(buf);
+}
+
+/**
+ * @brief Record a finished callback into the statistics of its module.
+ *
+ * @param[in] mod Module of the callback.
+ * @param[in] cb Callback.
+ * @param[in] usec Duration of the callback.
+ */
+static void
+srpds_aug_stats_cb(const struct lys_module *mod, enum augstats_cb cb, uint64_t usec)
+{
+    uint32_t i;
+
+    for (i = 0; i < auginfo.mod_count; ++i) {
+        if (auginfo.mods[i].mod == mod) {
+            if (auginfo.mods[i].stats) {
+                augds_stats_lat(&auginfo.mods[i].stats->cbs[cb], usec);
+            }
+            break;
+        }
+    }
+}
+
+static int
+srpds_aug_store_recorded(const struct lys_module *mod, sr_datastore_t ds, const struct lyd_node *mod_diff,
+        const struct lyd_node *mod_data)
+{
+    uint64_t usec;
+    int rc;
+
+    pthread_mutex_lock(&auglock);
+    usec = augds_stats_time();
+    rc = srpds_aug_store(mod, ds, mod_diff, mod_data);
+    usec = augds_stats_time() - usec;
+
+    srpds_aug_stats_cb(mod, AUGSTATS_CB_STORE, usec);
+    srpds_aug_trace(mod_diff ? "store" : "store-data", mod, ds, usec, rc, NULL, 0, mod_diff ? mod_diff : mod_data);
+    pthread_mutex_unlock(&auglock);
+    return rc;
+}
+
+static int
+srpds_aug_load_recorded(const struct lys_module *mod, sr_datastore_t ds, const char **xpaths, uint32_t xpath_count,
+        struct lyd_node **mod_data)
+{
+    uint64_t usec;
+    int rc;
+
+    pthread_mutex_lock(&auglock);
+    usec = augds_stats_time();
+    rc = srpds_aug_load(mod, ds, xpaths, xpath_count, mod_data);
+    usec = augds_stats_time() - usec;
+
+    srpds_aug_stats_cb(mod, AUGSTATS_CB_LOAD, usec);
+    srpds_aug_trace("load", mod, ds, usec, rc, xpaths, xpath_count, NULL);
+    pthread_mutex_unlock(&auglock);
+    return rc;
+}
+
+static int
+srpds_aug_access_check_recorded(const struct lys_module *mod, sr_datastore_t ds, int *read, int *write)
+{
+    uint64_t usec;
+    int rc;
+
+    pthread_mutex_lock(&auglock);
+    usec = augds_stats_time();
+    rc = srpds_aug_access_check(mod, ds, read, write);
+    usec = augds_stats_time() - usec;
+
+    srpds_aug_stats_cb(mod, AUGSTATS_CB_ACCESS_CHECK, usec);
+    srpds_aug_trace("access-check", mod, ds, usec, rc, NULL, 0, NULL);
+    pthread_mutex_unlock(&auglock);
+    return rc;
+}
+
+static int
+srpds_aug_last_modif_recorded(const struct lys_module *mod, sr_datastore_t ds, struct timespec *mtime)
+{
+    uint64_t usec;
+    int rc;
+
+    pthread_mutex_lock(&auglock);
+    usec = augds_stats_time();
+    rc = srpds_aug_last_modif(mod, ds, mtime);
+    usec = augds_stats_time() - usec;
+
+    srpds_aug_stats_cb(mod, AUGSTATS_CB_LAST_MODIF, usec);
+    srpds_aug_trace("last-modif", mod, ds, usec, rc, NULL, 0, NULL);
+    pthread_mutex_unlock(&auglock);
+    return rc;
+}
+
 SRPLG_DATASTORE = {
     .name = srpds_name,
     .install_cb = srpds_aug_install,
     .uninstall_cb = srpds_aug_uninstall,
     .init_cb = srpds_aug_init,
-    .store_cb = srpds_aug_store,
+    .store_cb = srpds_aug_store_recorded,
     .recover_cb = srpds_aug_recover,
-    .load_cb = srpds_aug_load,
+    .load_cb = srpds_aug_load_recorded,
     .copy_cb = srpds_aug_copy,
     .candidate_modified_cb = srpds_aug_candidate_modified,
     .candidate_reset_cb = srpds_aug_candidate_reset,
     .access_set_cb = srpds_aug_access_set,
     .access_get_cb = srpds_aug_access_get,
-    .access_check_cb = srpds_aug_access_check,
-    .last_modif_cb = srpds_aug_last_modif,
+    .access_check_cb = srpds_aug_access_check_recorded,
+    .last_modif_cb = srpds_aug_last_modif_recorded,
 };
@@ -19,6 +19,7 @@
 
 #include "srdsa_common.h"
 
+#include <pthread.h>
 #include <stdint.h>
 
 #define PCRE2_CODE_UNIT_WIDTH 8
@@ -34,6 +35,15 @@
 
 #define AUG_FILE_BACKUP_SUFFIX ".augsave"
 
+#define AUG_TRACE_ENV "SRDS_AUGEAS_TRACE"   /**< environment variable with the file to record the callbacks into */
+
+#define AUG_WATCH_ENV "SRDS_AUGEAS_WATCH"   /**< environment variable enabling the config file watcher, if set to 1 */
+
+#define AUG_WARMUP_ENV "SRDS_AUGEAS_WARMUP" /**< environment variable with the modules to warm up, "all" for all */
+
+#define AUG_MEM_LIMIT_ENV "SRDS_AUGEAS_MEM_LIMIT"   /**< environment variable with the memory limit of the modules */
+#define AUG_MEM_NODE_SIZE 128       /**< estimated memory of an Augeas tree node with its label and value */
+
 #define AUG_LOG_ERRINT SRPLG_LOG_ERR(srpds_name, "Internal error (%s:%d).", __FILE__, __LINE__)
 #define AUG_LOG_ERRMEM SRPLG_LOG_ERR(srpds_name, "Memory allocation failed (%s:%d).", __FILE__, __LINE__)
 
@@ -63,6 +73,18 @@ enum augds_diff_op {
     AUGDS_OP_NONE
 };
 
+/**
+ * @brief Compiled PCRE2 pattern shared by all the augnodes of all the modules with the same pattern.
+ */
+struct augpattern {
+    char *expr;                     /**< pattern, YANG pattern if compiled by libyang, otherwise PCRE2 pattern */
+    int yang;                       /**< whether expr is a YANG pattern and pcode a copy of the libyang code */
+    pcre2_code *pcode;              /**< compiled pattern, also JIT-compiled if supported */
+    pcre2_match_data *match_data;   /**< match data reused by all the matches */
+    uint32_t match_opts;            /**< options of the matches, the anchors of pcode are usually compiled */
+    uint32_t refs;                  /**< number of augnode pattern groups using the pattern */
+};
+
 struct augnode {
     const char *data_path;          /**< data-path of the augeas-extension in the schema node */
     const char *value_path;         /**< value-yang-path of the augeas-extension in the schema node */
@@ -70,10 +92,13 @@ struct augnode {
         const char *data_path;      /**< data-path of the node */
         struct augnode_pattern {
             struct augnode_pattern_group {
-                const pcre2_code *pcode;
+                struct augpattern *pattern; /**< shared compiled pattern */
                 uint32_t inverted;
             } *groups;
             uint32_t group_count;
+            char *literal_buf;      /**< buffer with all the labels from the label-literals extension */
+            const char **literals;  /**< sorted labels pointing to literal_buf used instead of groups, if set */
+            uint32_t literal_count; /**< count of literals */
         } *patterns;                /**< optional compiled PCRE2 pattern(s) of the schema pattern matching Augeas labels */
         uint32_t pattern_count;     /**< count of patterns */
     } *case_nodes;                  /**< nodes from which one must match for the case to be created */
@@ -89,19 +114,127 @@ struct augnode {
     struct augnode *parent;         /**< augnode parent */
 };
 
+/**
+ * @brief Watcher of the config files of the loaded modules, used only if ::AUG_WATCH_ENV is set.
+ *
+ * The directories matching the 'incl' patterns of every module are watched by inotify and a thread marks
+ * the modules whose files were changed, so that aug_load() is called only if there are some changes.
+ */
+struct augwatch {
+    int init;                       /**< whether the watcher was initialized */
+    int fd;                         /**< inotify instance, -1 if not watching */
+    int stop_fd;                    /**< eventfd to stop the thread */
+    pthread_t tid;                  /**< watcher thread */
+
+    pthread_mutex_t lock;           /**< lock for all the members below, shared with the thread */
+    struct augwatch_dir {
+        int wd;                     /**< inotify watch descriptor of the directory */
+        char *path;                 /**< directory path */
+        char *pattern;              /**< glob matching the file names in the directory, NULL for any */
+        const struct lys_module *mod;   /**< module with the files in the directory */
+    } *dirs;                        /**< array of watched directories */
+    uint32_t dir_count;             /**< count of dirs */
+    const struct lys_module **changed;  /**< modules with changed files since the last aug_load() */
+    uint32_t changed_count;         /**< count of changed */
+    int overflow;                   /**< set if some events were lost and all the modules may have changed */
+    int failed;                     /**< set if the thread failed and all the modules must always be reloaded */
+};
+
 struct auginfo {
     augeas *aug;    /**< augeas handle */
+    int autoload_all;   /**< set if some YANG module has no autoload extensions and aug_init() must load all the Augeas
+                             modules, otherwise they are loaded only when needed by the lenses of the YANG modules */
 
     struct augmod {
         const struct lys_module *mod;   /**< libyang module */
         struct augnode *toplevel;       /**< array of top-level nodes */
         uint32_t toplevel_count;        /**< top-level node count */
+        struct augstats_mod *stats;     /**< shared statistics of the module, NULL if disabled */
+        uint64_t last_use;              /**< value of use_count when the module was last used */
+        uint64_t info_size;             /**< memory of the augnodes */
+        uint64_t data_size;             /**< estimated memory of the Augeas data of the config files */
+        int evicted;                    /**< set if the Augeas data were evicted and the lens is not loaded */
     } *mods;                            /**< array of all loaded libyang/augeas modules */
     uint32_t mod_count;                 /**< module count */
+    uint64_t use_count;                 /**< counter of the module uses for the LRU eviction */
+    uint64_t mem_limit;                 /**< memory limit of the modules from ::AUG_MEM_LIMIT_ENV, 0 if unlimited */
 
-    pcre2_code *pcode_uint64;       /**< compiled PCRE2 pattern to match uint64 values, to be reused */
+    struct augpattern **patterns;   /**< compiled PCRE2 patterns of all the modules sorted by their expression */
+    uint32_t pattern_count;         /**< count of patterns */
+    struct augwatch watch;          /**< watcher of the config files */
 };
 
+/**
+ * @brief Trace of the callbacks called by sysrepo, recorded only if ::AUG_TRACE_ENV is set.
+ *
+ * Every record starts with the line "<callback> <module> <datastore> <timestamp> <usec> <rc> <xpath-count>
+ * <lyb-size>", the timestamp is realtime in microseconds and usec the duration of the callback. It is followed by
+ * xpath-count lines with the XPaths of a load and lyb-size bytes of a diff of a store ("store") or its data if
+ * the diff was not available ("store-data") in LYB format with a terminating newline.
+ */
+struct augtrace {
+    int init;       /**< whether the trace was initialized */
+    int fd;         /**< trace file opened for appending, -1 if not recording */
+};
+
+/**
+ * @brief Augeas transform of a YANG module, a copy independent of its libyang context.
+ */
+struct auglens {
+    char *mod_name;                 /**< YANG module name */
+    char *lens;                     /**< Augeas lens (module) name */
+    char *autoload_lens;            /**< qualified name of the autoloaded lens, NULL without the autoload extensions */
+    struct auglens_filter {
+        int incl;                   /**< set for 'incl', otherwise 'excl' */
+        char *glob;                 /**< glob of the config files */
+    } *filters;                     /**< filter of the autoloaded lens in the order of the transform */
+    uint32_t filter_count;          /**< count of filters */
+};
+
+/**
+ * @brief Modules whose config files are parsed in the background after the plugin is initialized for them.
+ *
+ * The context of the modules may be replaced before they are warmed up so the thread uses only their copied
+ * Augeas transforms. Their libyang information is created by the first callback, which supplies the current context,
+ * and it finds the config files already parsed.
+ */
+struct augwarm {
+    pthread_mutex_t lock;           /**< lock for all the members */
+    struct auglens *mods;           /**< queue of the transforms of the modules to warm up */
+    uint32_t mod_count;             /**< count of mods */
+    pthread_t tid;                  /**< thread warming up the queued modules */
+    int started;                    /**< whether the thread was started and must be joined */
+    int running;                    /**< whether the thread is running and takes the newly queued modules */
+    int stop;                       /**< set if the thread must stop */
+};
+
+/**
+ * @brief Copy the Augeas transform of a YANG module.
+ *
+ * @param[in] mod YANG module.
+ * @param[out] auglens Copied transform, free with ::augds_init_lens_free().
+ * @return SR error code.
+ */
+int augds_init_lens_get(const struct lys_module *mod, struct auglens *auglens);
+
+/**
+ * @brief Free a copied Augeas transform.
+ *
+ * @param[in] auglens Transform to free.
+ */
+void augds_init_lens_free(struct auglens *auglens);
+
+/**
+ * @brief Set the Augeas transform of a module and parse its config files, the augeas handle is created if needed.
+ *
+ * No libyang information is used so it can be called without the context of the module.
+ *
+ * @param[in] auginfo Base auginfo structure to use.
+ * @param[in] auglens Augeas transform of the module.
+ * @return SR error code.
+ */
+int augds_init_lens(struct auginfo *auginfo, const struct auglens *auglens);
+
 /**
  * @brief Initialize augeas structure for a YANG module.
  *
@@ -119,6 +252,58 @@ int augds_init(struct auginfo *auginfo, const struct lys_module *mod, struct aug
  */
 void augds_destroy(struct auginfo *auginfo);
 
+/**
+ * @brief Account the memory of the Augeas data of a module after they were loaded and evict the Augeas data of
+ * the least recently used modules while over the memory limit.
+ *
+ * The information of the evicted modules is kept, their lens is only removed from the lenses loaded by aug_load()
+ * and it is added back by ::augds_init() once they are used again.
+ *
+ * @param[in] auginfo Base auginfo structure.
+ * @param[in] augmod Module whose Augeas data were loaded, it is never evicted.
+ */
+void augds_mem_update(struct auginfo *auginfo, struct augmod *augmod);
+
+/**
+ * @brief Start watching the config files of a module, the watcher is started on the first call if enabled.
+ *
+ * The module is marked as changed so that the next ::augds_watch_reload() reloads it.
+ *
+ * @param[in] auginfo Base auginfo structure.
+ * @param[in] mod YANG module with the 'incl' patterns of its lens set.
+ */
+void augds_watch_module(struct auginfo *auginfo, const struct lys_module *mod);
+
+/**
+ * @brief Mark a module as changed so that the next ::augds_watch_reload() reloads it.
+ *
+ * Used if the augeas data of the module were modified but not saved.
+ *
+ * @param[in] auginfo Base auginfo structure.
+ * @param[in] mod YANG module to reload.
+ */
+void augds_watch_changed(struct auginfo *auginfo, const struct lys_module *mod);
+
+/**
+ * @brief Learn whether the augeas data must be reloaded because some config files of a module were changed.
+ *
+ * The pending config file events are processed first so that every change finished before the call is noticed.
+ * If there are changes, all the modules are considered reloaded and the watches of the newly created directories
+ * are added.
+ *
+ * @param[in] auginfo Base auginfo structure.
+ * @param[in] mod YANG module to be loaded.
+ * @return Whether aug_load() must be called, always if not watching.
+ */
+int augds_watch_reload(struct auginfo *auginfo, const struct lys_module *mod);
+
+/**
+ * @brief Stop the watcher and free all its watches.
+ *
+ * @param[in] watch Watcher to destroy.
+ */
+void augds_watch_destroy(struct augwatch *watch);
+
 /**
  * @brief Learn operation of a diff node.
  *
@@ -22,12 +22,22 @@
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <fnmatch.h>
+#include <glob.h>
 #include <grp.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <pthread.h>
 #include <pwd.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #define PCRE2_CODE_UNIT_WIDTH 8
@@ -38,6 +48,12 @@
 #include <sysrepo.h>
 #include <sysrepo/plugins_datastore.h>
 
+/**
+ * @brief Mapped statistics file, NULL if the statistics are disabled.
+ */
+static struct augstats *augstats;
+static int augstats_init;
+
 int
 augds_get_pwd(uid_t *uid, char **user)
 {
@@ -586,15 +602,24 @@ augds_get_config_files(augeas *aug, const struct lys_module *mod, int fs_path, c
 {
     int rc = SR_ERR_OK, i, label_count = 0;
     char *path = NULL, **label_matches = NULL;
-    const char *value, *lens_name;
+    const char *value, *lens_name, *lens;
     void *mem;
 
     *files = NULL;
     *file_count = 0;
 
-    /* get all the path labels */
+    /* get the lens of the files, '@<lens>' or the qualified name of the autoloaded lens */
     augds_get_lens(mod, &lens_name);
-    if (asprintf(&path, "/augeas/files//*[lens='@%s']/path", lens_name) == -1) {
+    if (asprintf(&path, "/augeas/load/%s/lens", lens_name) == -1) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    if (aug_get(aug, path, &lens) != 1) {
+        AUG_LOG_ERRAUG_GOTO(aug, rc, cleanup);
+    }
+
+    /* get all the path labels */
+    free(path);
+    if (asprintf(&path, "/augeas/files//*[lens='%s']/path", lens) == -1) {
         AUG_LOG_ERRMEM_GOTO(rc, cleanup);
     }
     label_count = aug_match(aug, path, &label_matches);
@@ -703,3 +728,667 @@ augds_get_term_value(const struct lyd_node *node)
 
     return val;
 }
+
+/**
+ * @brief Map the statistics file, create it if it does not exist.
+ *
+ * The file must be a regular file owned by the effective user, otherwise it could be prepared by another user
+ * to block the statistics or to redirect them by a symlink.
+ *
+ * @return Mapped statistics, NULL if disabled.
+ */
+static struct augstats *
+augds_stats_map(void)
+{
+    const char *path;
+    struct augstats *stats;
+    struct stat st;
+    uint32_t version = 0;
+    int fd;
+
+    path = getenv(AUG_STATS_ENV);
+    if (!path || !path[0]) {
+        /* disabled */
+        return NULL;
+    }
+
+    fd = open(path, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        SRPLG_LOG_WRN(srpds_name, "Opening statistics \"%s\" failed (%s).", path, strerror(errno));
+        return NULL;
+    }
+    if (fstat(fd, &st) == -1) {
+        SRPLG_LOG_WRN(srpds_name, "Stat of statistics \"%s\" failed (%s).", path, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    if (!S_ISREG(st.st_mode) || (st.st_uid != geteuid())) {
+        SRPLG_LOG_WRN(srpds_name, "Statistics \"%s\" are not a regular file owned by the user.", path);
+        close(fd);
+        return NULL;
+    }
+
+    /* the size is always the same so the file is never truncated */
+    if (ftruncate(fd, sizeof *stats) == -1) {
+        SRPLG_LOG_WRN(srpds_name, "Resizing statistics \"%s\" failed (%s).", path, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    stats = mmap(NULL, sizeof *stats, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stats == MAP_FAILED) {
+        SRPLG_LOG_WRN(srpds_name, "Mapping statistics \"%s\" failed (%s).", path, strerror(errno));
+        return NULL;
+    }
+
+    /* a new file is zeroed, a file of another version must not be used */
+    if (!__atomic_compare_exchange_n(&stats->version, &version, AUG_STATS_VERSION, 0, __ATOMIC_ACQ_REL,
+            __ATOMIC_ACQUIRE) && (version != AUG_STATS_VERSION)) {
+        SRPLG_LOG_WRN(srpds_name, "Statistics \"%s\" of version %" PRIu32 " not supported.", path, version);
+        munmap(stats, sizeof *stats);
+        return NULL;
+    }
+
+    return stats;
+}
+
+struct augstats_mod *
+augds_stats_module(const char *name)
+{
+    struct augstats_mod *smod;
+    uint32_t i, state;
+
+    if (!augstats_init) {
+        augstats_init = 1;
+        augstats = augds_stats_map();
+    }
+    if (!augstats || (strlen(name) >= AUG_STATS_NAME_LEN)) {
+        return NULL;
+    }
+
+    for (i = 0; i < AUG_STATS_MODULES; ++i) {
+        smod = &augstats->mods[i];
+
+        state = 0;
+        if (__atomic_compare_exchange_n(&smod->state, &state, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            /* claimed a free slot */
+            strcpy(smod->name, name);
+            __atomic_store_n(&smod->state, 2, __ATOMIC_RELEASE);
+            return smod;
+        }
+
+        /* another process may be just setting the name */
+        while (state == 1) {
+            sched_yield();
+            state = __atomic_load_n(&smod->state, __ATOMIC_ACQUIRE);
+        }
+        if (!strcmp(smod->name, name)) {
+            return smod;
+        }
+    }
+
+    /* full */
+    return NULL;
+}
+
+uint64_t
+augds_stats_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void
+augds_stats_add(uint64_t *counter, uint64_t value)
+{
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+void
+augds_stats_lat(struct augstats_lat *lat, uint64_t usec)
+{
+    uint64_t max;
+    uint32_t bucket;
+
+    __atomic_fetch_add(&lat->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&lat->total_usec, usec, __ATOMIC_RELAXED);
+
+    max = __atomic_load_n(&lat->max_usec, __ATOMIC_RELAXED);
+    while ((usec > max) &&
+            !__atomic_compare_exchange_n(&lat->max_usec, &max, usec, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+
+    /* bucket i counts durations < 2^i */
+    bucket = usec ? 64 - __builtin_clzll(usec) : 0;
+    if (bucket >= AUG_STATS_BUCKETS) {
+        bucket = AUG_STATS_BUCKETS - 1;
+    }
+    __atomic_fetch_add(&lat->buckets[bucket], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Events of the watched directories meaning a config file may have changed.
+ */
+#define AUG_WATCH_MASK (IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | \
+        IN_DELETE_SELF | IN_MOVE_SELF)
+
+/**
+ * @brief Mark a module as changed, the watcher must be locked.
+ *
+ * @param[in] watch Watcher.
+ * @param[in] mod Changed module.
+ * @return Whether the module was newly marked.
+ */
+static int
+augds_watch_mark(struct augwatch *watch, const struct lys_module *mod)
+{
+    void *mem;
+    uint32_t i;
+
+    for (i = 0; i < watch->changed_count; ++i) {
+        if (watch->changed[i] == mod) {
+            return 0;
+        }
+    }
+
+    mem = realloc(watch->changed, (watch->changed_count + 1) * sizeof *watch->changed);
+    if (!mem) {
+        /* consider all the modules changed instead */
+        watch->overflow = 1;
+        return 1;
+    }
+    watch->changed = mem;
+    watch->changed[watch->changed_count++] = mod;
+    return 1;
+}
+
+/**
+ * @brief Process an inotify event, the watcher must be locked.
+ *
+ * @param[in] watch Watcher.
+ * @param[in] ev Event to process.
+ */
+static void
+augds_watch_event(struct augwatch *watch, const struct inotify_event *ev)
+{
+    struct augwatch_dir *dir;
+    uint32_t i;
+
+    if (ev->mask & IN_Q_OVERFLOW) {
+        SRPLG_LOG_WRN(srpds_name, "Config file events were lost, reloading all the modules.");
+        watch->overflow = 1;
+        return;
+    }
+
+    i = 0;
+    while (i < watch->dir_count) {
+        dir = &watch->dirs[i];
+        if (dir->wd != ev->wd) {
+            ++i;
+            continue;
+        }
+
+        if ((ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) || !dir->pattern ||
+                (ev->len && !fnmatch(dir->pattern, ev->name, 0))) {
+            if (augds_watch_mark(watch, dir->mod)) {
+                SRPLG_LOG_INF(srpds_name, "Config file \"%s%s%s\" of module \"%s\" changed.", dir->path,
+                        ev->len ? "/" : "", ev->len ? ev->name : "", dir->mod->name);
+            }
+        }
+
+        if (ev->mask & IN_MOVE_SELF) {
+            /* the path is no longer valid, it is watched again on the next reload */
+            inotify_rm_watch(watch->fd, ev->wd);
+        } else if (ev->mask & IN_IGNORED) {
+            /* the watch was removed */
+            free(dir->path);
+            free(dir->pattern);
+            --watch->dir_count;
+            memmove(dir, dir + 1, (watch->dir_count - i) * sizeof *dir);
+            continue;
+        }
+
+        ++i;
+    }
+}
+
+/**
+ * @brief Process all the pending inotify events, the watcher must be locked.
+ *
+ * Called by the thread and also before every reload decision so that the changes made before the decision are never
+ * missed, even if the thread has not processed them yet.
+ *
+ * @param[in] watch Watcher.
+ * @return 0 on success;
+ * @return -1 on error.
+ */
+static int
+augds_watch_drain(struct augwatch *watch)
+{
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *ev;
+    ssize_t len;
+    char *ptr;
+
+    while (1) {
+        len = read(watch->fd, buf, sizeof buf);
+        if (len == -1) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN) {
+                /* no more events */
+                return 0;
+            }
+            SRPLG_LOG_ERR(srpds_name, "Reading the config file events failed (%s).", strerror(errno));
+            return -1;
+        }
+
+        for (ptr = buf; ptr < buf + len; ptr += sizeof *ev + ev->len) {
+            ev = (const struct inotify_event *)ptr;
+            augds_watch_event(watch, ev);
+        }
+    }
+}
+
+/**
+ * @brief Watcher thread processing the inotify events until stopped.
+ *
+ * @param[in] arg Watcher.
+ * @return NULL.
+ */
+static void *
+augds_watch_thread(void *arg)
+{
+    struct augwatch *watch = arg;
+    struct pollfd pfds[2];
+    int r;
+
+    pfds[0].fd = watch->fd;
+    pfds[0].events = POLLIN;
+    pfds[1].fd = watch->stop_fd;
+    pfds[1].events = POLLIN;
+
+    while (1) {
+        if (poll(pfds, 2, -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SRPLG_LOG_ERR(srpds_name, "Poll of the config file events failed (%s).", strerror(errno));
+            break;
+        }
+        if (pfds[1].revents) {
+            /* stopped */
+            break;
+        }
+
+        /* the events are read only with the lock held, they may have already been drained by a reload */
+        pthread_mutex_lock(&watch->lock);
+        r = augds_watch_drain(watch);
+        pthread_mutex_unlock(&watch->lock);
+        if (r) {
+            break;
+        }
+    }
+
+    /* consider everything changed from now on, nothing is being watched */
+    pthread_mutex_lock(&watch->lock);
+    watch->failed = 1;
+    pthread_mutex_unlock(&watch->lock);
+    return NULL;
+}
+
+/**
+ * @brief Stop the watcher and free all its watches, it is not used anymore.
+ *
+ * @param[in] watch Watcher to stop.
+ */
+static void
+augds_watch_stop(struct augwatch *watch)
+{
+    uint64_t stop = 1;
+    uint32_t i;
+
+    if (watch->fd == -1) {
+        return;
+    }
+
+    /* stop the thread, it may have already failed */
+    if (write(watch->stop_fd, &stop, sizeof stop) != sizeof stop) {
+        pthread_cancel(watch->tid);
+    }
+    pthread_join(watch->tid, NULL);
+    close(watch->stop_fd);
+    close(watch->fd);
+    watch->fd = -1;
+
+    for (i = 0; i < watch->dir_count; ++i) {
+        free(watch->dirs[i].path);
+        free(watch->dirs[i].pattern);
+    }
+    free(watch->dirs);
+    watch->dirs = NULL;
+    watch->dir_count = 0;
+    free(watch->changed);
+    watch->changed = NULL;
+    watch->changed_count = 0;
+    pthread_mutex_destroy(&watch->lock);
+}
+
+/**
+ * @brief Start the watcher, if enabled.
+ *
+ * @param[in] watch Watcher to start.
+ */
+static void
+augds_watch_start(struct augwatch *watch)
+{
+    const char *env;
+    int r;
+
+    watch->init = 1;
+    watch->fd = -1;
+
+    env = getenv(AUG_WATCH_ENV);
+    if (!env || strcmp(env, "1")) {
+        return;
+    }
+
+    memset(watch, 0, sizeof *watch);
+    watch->init = 1;
+    pthread_mutex_init(&watch->lock, NULL);
+
+    if ((watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) == -1) {
+        SRPLG_LOG_WRN(srpds_name, "Creating inotify instance failed (%s).", strerror(errno));
+        goto error;
+    }
+    if ((watch->stop_fd = eventfd(0, EFD_CLOEXEC)) == -1) {
+        SRPLG_LOG_WRN(srpds_name, "Creating eventfd failed (%s).", strerror(errno));
+        close(watch->fd);
+        goto error;
+    }
+    if ((r = pthread_create(&watch->tid, NULL, augds_watch_thread, watch))) {
+        SRPLG_LOG_WRN(srpds_name, "Creating the watcher thread failed (%s).", strerror(r));
+        close(watch->stop_fd);
+        close(watch->fd);
+        goto error;
+    }
+
+    return;
+
+error:
+    watch->fd = -1;
+    pthread_mutex_destroy(&watch->lock);
+}
+
+/**
+ * @brief Watch a directory with the config files of a module.
+ *
+ * @param[in] watch Watcher.
+ * @param[in] path Directory path.
+ * @param[in] pattern Glob matching the file names in @p path, NULL for any.
+ * @param[in] mod Module with the files.
+ * @return SR error code, SR_ERR_NOT_FOUND if @p path does not exist.
+ */
+static int
+augds_watch_add(struct augwatch *watch, const char *path, const char *pattern, const struct lys_module *mod)
+{
+    int rc = SR_ERR_OK, wd;
+    struct augwatch_dir *dir;
+    void *mem;
+    uint32_t i;
+
+    wd = inotify_add_watch(watch->fd, path, AUG_WATCH_MASK | IN_ONLYDIR);
+    if (wd == -1) {
+        if ((errno == ENOENT) || (errno == ENOTDIR)) {
+            return SR_ERR_NOT_FOUND;
+        }
+        SRPLG_LOG_WRN(srpds_name, "Watching \"%s\" failed (%s).", path, strerror(errno));
+        return SR_ERR_SYS;
+    }
+
+    pthread_mutex_lock(&watch->lock);
+
+    /* the same directory may already be watched */
+    for (i = 0; i < watch->dir_count; ++i) {
+        dir = &watch->dirs[i];
+        if ((dir->wd == wd) && (dir->mod == mod) && !strcmp(dir->path, path) &&
+                ((!dir->pattern && !pattern) || (dir->pattern && pattern && !strcmp(dir->pattern, pattern)))) {
+            goto cleanup;
+        }
+    }
+
+    mem = realloc(watch->dirs, (watch->dir_count + 1) * sizeof *watch->dirs);
+    if (!mem) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    watch->dirs = mem;
+    dir = &watch->dirs[watch->dir_count];
+
+    dir->wd = wd;
+    dir->path = strdup(path);
+    dir->pattern = pattern ? strdup(pattern) : NULL;
+    dir->mod = mod;
+    if (!dir->path || (pattern && !dir->pattern)) {
+        free(dir->path);
+        free(dir->pattern);
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    ++watch->dir_count;
+
+cleanup:
+    pthread_mutex_unlock(&watch->lock);
+    return rc;
+}
+
+/**
+ * @brief Watch the directories with the config files matching an 'incl' pattern of a module.
+ *
+ * The directories matching a glob are watched only if they exist. A directory that does not exist is
+ * replaced by its closest existing ancestor to notice its creation.
+ *
+ * @param[in] watch Watcher.
+ * @param[in] root Augeas root with a trailing slash.
+ * @param[in] incl Absolute 'incl' pattern.
+ * @param[in] mod Module with the files.
+ * @return SR error code.
+ */
+static int
+augds_watch_incl(struct augwatch *watch, const char *root, const char *incl, const struct lys_module *mod)
+{
+    int rc = SR_ERR_OK;
+    char *path = NULL, *ptr;
+    const char *pattern;
+    glob_t gl = {0};
+    size_t i;
+
+    if (incl[0] != '/') {
+        /* not a path */
+        return SR_ERR_OK;
+    }
+
+    if (asprintf(&path, "%s%s", root, incl + 1) == -1) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+
+    /* split into the directory and the file name pattern, it may use braces unsupported by fnmatch() */
+    ptr = strrchr(path, '/');
+    *ptr = '\0';
+    pattern = strchr(ptr + 1, '{') ? NULL : ptr + 1;
+
+    if (strpbrk(path, "*?[")) {
+        /* watch all the matching directories */
+        if (!glob(path, GLOB_ONLYDIR | GLOB_NOSORT, NULL, &gl)) {
+            for (i = 0; i < gl.gl_pathc; ++i) {
+                rc = augds_watch_add(watch, gl.gl_pathv[i], pattern, mod);
+                if (rc && (rc != SR_ERR_NOT_FOUND)) {
+                    goto cleanup;
+                }
+            }
+        }
+        rc = SR_ERR_OK;
+        goto cleanup;
+    }
+
+    while (((rc = augds_watch_add(watch, path[0] ? path : "/", pattern, mod)) == SR_ERR_NOT_FOUND) && path[0]) {
+        /* watch for the creation of the directory in its parent */
+        ptr = strrchr(path, '/');
+        *ptr = '\0';
+        pattern = ptr + 1;
+    }
+    if (rc == SR_ERR_NOT_FOUND) {
+        rc = SR_ERR_OK;
+    }
+
+cleanup:
+    globfree(&gl);
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Watch the directories of all the 'incl' patterns of a module.
+ *
+ * @param[in] auginfo Base auginfo structure.
+ * @param[in] mod YANG module.
+ * @return SR error code.
+ */
+static int
+augds_watch_module_incl(struct auginfo *auginfo, const struct lys_module *mod)
+{
+    int rc = SR_ERR_OK, i, incl_count = 0;
+    char *path = NULL, **incls = NULL;
+    const char *lens, *root, *incl;
+
+    /* learn the root, the files are relative to it */
+    if ((aug_get(auginfo->aug, "/augeas/root", &root) != 1) || !root) {
+        AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
+    }
+
+    /* get all the 'incl' patterns of the lens */
+    augds_get_lens(mod, &lens);
+    if (asprintf(&path, "/augeas/load/%s/incl", lens) == -1) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    incl_count = aug_match(auginfo->aug, path, &incls);
+    if (incl_count == -1) {
+        incl_count = 0;
+        AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
+    }
+
+    for (i = 0; i < incl_count; ++i) {
+        if (aug_get(auginfo->aug, incls[i], &incl) != 1) {
+            AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
+        }
+        if ((rc = augds_watch_incl(&auginfo->watch, root, incl, mod))) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    free(path);
+    for (i = 0; i < incl_count; ++i) {
+        free(incls[i]);
+    }
+    free(incls);
+    return rc;
+}
+
+void
+augds_watch_module(struct auginfo *auginfo, const struct lys_module *mod)
+{
+    struct augwatch *watch = &auginfo->watch;
+
+    if (!watch->init) {
+        augds_watch_start(watch);
+    }
+    if (watch->fd == -1) {
+        return;
+    }
+
+    if (augds_watch_module_incl(auginfo, mod)) {
+        /* reload always instead */
+        SRPLG_LOG_WRN(srpds_name, "Config files of module \"%s\" cannot be watched, the watcher is stopped.",
+                mod->name);
+        augds_watch_stop(watch);
+        return;
+    }
+
+    /* it may have been changed before being watched */
+    augds_watch_changed(auginfo, mod);
+}
+
+void
+augds_watch_changed(struct auginfo *auginfo, const struct lys_module *mod)
+{
+    struct augwatch *watch = &auginfo->watch;
+
+    if (!watch->init || (watch->fd == -1)) {
+        return;
+    }
+
+    pthread_mutex_lock(&watch->lock);
+    augds_watch_mark(watch, mod);
+    pthread_mutex_unlock(&watch->lock);
+}
+
+int
+augds_watch_reload(struct auginfo *auginfo, const struct lys_module *mod)
+{
+    struct augwatch *watch = &auginfo->watch;
+    int reload, failed;
+    uint32_t i;
+
+    if (watch->fd == -1) {
+        return 1;
+    }
+
+    pthread_mutex_lock(&watch->lock);
+    if (!watch->failed && augds_watch_drain(watch)) {
+        watch->failed = 1;
+    }
+    failed = watch->failed;
+    reload = watch->overflow;
+    for (i = 0; !reload && (i < watch->changed_count); ++i) {
+        if (watch->changed[i] == mod) {
+            reload = 1;
+        }
+    }
+    if (reload) {
+        /* aug_load() reloads the changed files of all the modules */
+        watch->changed_count = 0;
+        watch->overflow = 0;
+    }
+    pthread_mutex_unlock(&watch->lock);
+
+    if (failed) {
+        /* reload always instead */
+        augds_watch_stop(watch);
+        return 1;
+    } else if (!reload) {
+        return 0;
+    }
+
+    /* watch the directories that may have been created, before they are loaded */
+    for (i = 0; i < auginfo->mod_count; ++i) {
+        if (augds_watch_module_incl(auginfo, auginfo->mods[i].mod)) {
+            SRPLG_LOG_WRN(srpds_name, "Config files of module \"%s\" cannot be watched, the watcher is stopped.",
+                    auginfo->mods[i].mod->name);
+            augds_watch_stop(watch);
+            break;
+        }
+    }
+
+    return 1;
+}
+
+void
+augds_watch_destroy(struct augwatch *watch)
+{
+    if (!watch->init) {
+        return;
+    }
+
+    augds_watch_stop(watch);
+    watch->init = 0;
+}
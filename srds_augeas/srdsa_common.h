@@ -17,11 +17,14 @@
 #ifndef SRDSA_COMMON_H_
 #define SRDSA_COMMON_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <augeas.h>
 #include <libyang/libyang.h>
 
+#include "srdsa_stats.h"
+
 enum augds_ext_node_type;
 
 /**
@@ -134,4 +137,35 @@ void augds_node_get_type(const struct lysc_node *node, enum augds_ext_node_type
  */
 const char *augds_get_term_value(const struct lyd_node *node);
 
+/**
+ * @brief Get the statistics of a module, the statistics file is mapped on the first call.
+ *
+ * @param[in] name Module name.
+ * @return Statistics of the module, NULL if the statistics are disabled or full.
+ */
+struct augstats_mod *augds_stats_module(const char *name);
+
+/**
+ * @brief Get monotonic time for the statistics.
+ *
+ * @return Current time in microseconds.
+ */
+uint64_t augds_stats_time(void);
+
+/**
+ * @brief Add a value to a statistics counter.
+ *
+ * @param[in] counter Counter to update.
+ * @param[in] value Value to add.
+ */
+void augds_stats_add(uint64_t *counter, uint64_t value);
+
+/**
+ * @brief Record a duration in the latency statistics.
+ *
+ * @param[in] lat Latency statistics to update.
+ * @param[in] usec Duration in microseconds.
+ */
+void augds_stats_lat(struct augstats_lat *lat, uint64_t usec);
+
 #endif /* SRDSA_COMMON_H_ */
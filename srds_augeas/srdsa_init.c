@@ -38,31 +38,125 @@
 #include <sysrepo.h>
 #include <sysrepo/plugins_datastore.h>
 
+/**
+ * @brief Find a compiled pattern in the cache.
+ *
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
+ * @param[in] expr Pattern expression.
+ * @param[in] yang Whether @p expr is a YANG pattern.
+ * @param[out] idx Index of the pattern if found, otherwise the index to insert it at.
+ * @return Whether the pattern was found.
+ */
+static int
+augds_init_pattern_find(const struct auginfo *auginfo, const char *expr, int yang, uint32_t *idx)
+{
+    const struct augpattern *pattern;
+    uint32_t low = 0, high = auginfo->pattern_count, mid;
+    int r;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        pattern = auginfo->patterns[mid];
+
+        r = (pattern->yang != yang) ? pattern->yang - yang : strcmp(pattern->expr, expr);
+        if (!r) {
+            *idx = mid;
+            return 1;
+        } else if (r < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    *idx = low;
+    return 0;
+}
+
+/**
+ * @brief Free a compiled pattern.
+ *
+ * @param[in] pattern Pattern to free.
+ */
+static void
+augds_init_pattern_free(struct augpattern *pattern)
+{
+    if (!pattern) {
+        return;
+    }
+
+    free(pattern->expr);
+    pcre2_match_data_free(pattern->match_data);
+    pcre2_code_free(pattern->pcode);
+    free(pattern);
+}
+
+/**
+ * @brief Release a reference of a compiled pattern, it is removed from the cache and freed with the last one.
+ *
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
+ * @param[in] pattern Pattern to release, may be NULL.
+ */
+static void
+augds_init_pattern_release(struct auginfo *auginfo, struct augpattern *pattern)
+{
+    uint32_t idx;
+
+    if (!pattern || --pattern->refs) {
+        return;
+    }
+
+    if (augds_init_pattern_find(auginfo, pattern->expr, pattern->yang, &idx)) {
+        --auginfo->pattern_count;
+        memmove(&auginfo->patterns[idx], &auginfo->patterns[idx + 1],
+                (auginfo->pattern_count - idx) * sizeof *auginfo->patterns);
+    }
+    augds_init_pattern_free(pattern);
+}
+
+/**
+ * @brief Free augnode patterns.
+ *
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
+ * @param[in] patterns Array of patterns to free.
+ * @param[in] pattern_count Count of @p patterns.
+ */
+static void
+augds_free_info_patterns(struct auginfo *auginfo, struct augnode_pattern *patterns, uint32_t pattern_count)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < pattern_count; ++i) {
+        for (j = 0; j < patterns[i].group_count; ++j) {
+            augds_init_pattern_release(auginfo, patterns[i].groups[j].pattern);
+        }
+        free(patterns[i].groups);
+        free(patterns[i].literal_buf);
+        free(patterns[i].literals);
+    }
+    free(patterns);
+}
+
 /**
  * @brief Free auginfo augnode.
  *
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
  * @param[in] augnode Augnode to free.
  */
 static void
-augds_free_info_node(struct augnode *augnode)
+augds_free_info_node(struct auginfo *auginfo, struct augnode *augnode)
 {
-    uint32_t i, j;
+    uint32_t i;
 
     for (i = 0; i < augnode->cnode_count; ++i) {
-        for (j = 0; j < augnode->case_nodes[i].pattern_count; ++j) {
-            free(augnode->case_nodes[i].patterns[j].groups);
-        }
-        free(augnode->case_nodes[i].patterns);
+        augds_free_info_patterns(auginfo, augnode->case_nodes[i].patterns, augnode->case_nodes[i].pattern_count);
     }
     free(augnode->case_nodes);
 
-    for (i = 0; i < augnode->pattern_count; ++i) {
-        free(augnode->patterns[i].groups);
-    }
-    free(augnode->patterns);
+    augds_free_info_patterns(auginfo, augnode->patterns, augnode->pattern_count);
 
     for (i = 0; i < augnode->child_count; ++i) {
-        augds_free_info_node(&augnode->child[i]);
+        augds_free_info_node(auginfo, &augnode->child[i]);
     }
     free(augnode->child);
 }
@@ -93,20 +187,154 @@ augds_init_auginfo_add_case_node(struct augnode *anode, const char *data_path, s
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Compile a pattern.
+ *
+ * @param[in] pattern Pattern to compile.
+ * @param[out] pcode Compiled PCRE2 code.
+ * @return SR error code.
+ */
+static int
+augds_init_auginfo_compile_pattern(const char *pattern, pcre2_code **pcode)
+{
+    char *pattern_d = NULL;
+    int err_code;
+    uint32_t compile_opts;
+    PCRE2_SIZE err_offset;
+
+    /* prepare options and pattern */
+    compile_opts = PCRE2_UTF | PCRE2_ANCHORED | PCRE2_DOLLAR_ENDONLY | PCRE2_NO_AUTO_CAPTURE;
+
+    /* handle end anchor */
+#ifdef PCRE2_ENDANCHORED
+    compile_opts |= PCRE2_ENDANCHORED;
+#else
+    asprintf(&pattern_d, "%s$", pattern);
+    pattern = pattern_d;
+#endif
+
+    /* compile the pattern */
+    *pcode = pcre2_compile((PCRE2_SPTR)pattern, PCRE2_ZERO_TERMINATED, compile_opts, &err_code,
+            &err_offset, NULL);
+    free(pattern_d);
+
+    if (!*pcode) {
+        PCRE2_UCHAR err_msg[AUG_PCRE2_MSG_LIMIT] = {0};
+
+        pcre2_get_error_message(err_code, err_msg, AUG_PCRE2_MSG_LIMIT);
+
+        SRPLG_LOG_ERR(srpds_name, "Regular expression \"%s\" is not valid (\"%s\": %s).", pattern,
+                pattern + err_offset, (const char *)err_msg);
+        return SR_ERR_INTERNAL;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Get a compiled pattern from the cache, it is compiled and added into it if not there yet.
+ *
+ * Many nodes of many modules use the same patterns so they share a single compiled pattern.
+ *
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
+ * @param[in] expr Pattern expression.
+ * @param[in] ly_pcode Code of the YANG pattern @p expr compiled by libyang, NULL if @p expr is a PCRE2 pattern.
+ * @param[out] pattern Compiled pattern with a new reference.
+ * @return SR error code.
+ */
+static int
+augds_init_pattern_get(struct auginfo *auginfo, const char *expr, const pcre2_code *ly_pcode,
+        struct augpattern **pattern)
+{
+    int rc = SR_ERR_OK;
+    struct augpattern *pat = NULL;
+    uint32_t idx, opts;
+    void *mem;
+
+    if (augds_init_pattern_find(auginfo, expr, ly_pcode ? 1 : 0, &idx)) {
+        /* cached */
+        *pattern = auginfo->patterns[idx];
+        ++(*pattern)->refs;
+        return SR_ERR_OK;
+    }
+
+    pat = calloc(1, sizeof *pat);
+    if (!pat) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    pat->expr = strdup(expr);
+    if (!pat->expr) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    pat->yang = ly_pcode ? 1 : 0;
+
+    if (ly_pcode) {
+        /* use a copy of the code compiled by libyang, which does not JIT-compile it */
+        pat->pcode = pcre2_code_copy(ly_pcode);
+        if (!pat->pcode) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+    } else if ((rc = augds_init_auginfo_compile_pattern(expr, &pat->pcode))) {
+        goto cleanup;
+    }
+
+    /* JIT may not be supported, the matches are interpreted then */
+    pcre2_jit_compile(pat->pcode, PCRE2_JIT_COMPLETE);
+
+    pat->match_data = pcre2_match_data_create_from_pattern(pat->pcode, NULL);
+    if (!pat->match_data) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+
+    /* anchor the matches only if the pattern is not anchored, JIT is never used for anchored matches */
+    pcre2_pattern_info(pat->pcode, PCRE2_INFO_ARGOPTIONS, &opts);
+    if (!(opts & PCRE2_ANCHORED)) {
+        pat->match_opts |= PCRE2_ANCHORED;
+    }
+#ifdef PCRE2_ENDANCHORED
+    /* PCRE2_ENDANCHORED was added in PCRE2 version 10.30 */
+    if (!(opts & PCRE2_ENDANCHORED)) {
+        pat->match_opts |= PCRE2_ENDANCHORED;
+    }
+#endif
+
+    /* add into the cache */
+    mem = realloc(auginfo->patterns, (auginfo->pattern_count + 1) * sizeof *auginfo->patterns);
+    if (!mem) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    auginfo->patterns = mem;
+    memmove(&auginfo->patterns[idx + 1], &auginfo->patterns[idx],
+            (auginfo->pattern_count - idx) * sizeof *auginfo->patterns);
+    auginfo->patterns[idx] = pat;
+    ++auginfo->pattern_count;
+
+    pat->refs = 1;
+    *pattern = pat;
+    pat = NULL;
+
+cleanup:
+    augds_init_pattern_free(pat);
+    return rc;
+}
+
 /**
  * @brief Add a new pattern to an array.
  *
- * @param[in] pcode Compiled PCRE2 pattern code to store.
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
+ * @param[in] expr PCRE2 pattern to store.
  * @param[in] inverted Whether the match is inverted or not.
  * @param[in,out] patterns Array of patterns to add to.
  * @param[in,out] pattern_count Count of @p patterns.
  * @return SR error value.
  */
 static int
-augds_init_auginfo_add_pattern(const pcre2_code *pcode, uint32_t inverted, struct augnode_pattern **patterns,
-        uint32_t *pattern_count)
+augds_init_auginfo_add_pattern(struct auginfo *auginfo, const char *expr, uint32_t inverted,
+        struct augnode_pattern **patterns, uint32_t *pattern_count)
 {
+    struct augnode_pattern *pattern;
     void *mem;
+    int rc;
 
     /* add pattern */
     mem = realloc(*patterns, (*pattern_count + 1) * sizeof **patterns);
@@ -114,34 +342,41 @@ augds_init_auginfo_add_pattern(const pcre2_code *pcode, uint32_t inverted, struc
         AUG_LOG_ERRMEM_RET;
     }
     *patterns = mem;
+    pattern = &(*patterns)[*pattern_count];
+    memset(pattern, 0, sizeof *pattern);
+    ++(*pattern_count);
 
     /* add one group */
-    (*patterns)[*pattern_count].groups = malloc(sizeof *(*patterns)[*pattern_count].groups);
-    if (!(*patterns)[*pattern_count].groups) {
+    pattern->groups = malloc(sizeof *pattern->groups);
+    if (!pattern->groups) {
         AUG_LOG_ERRMEM_RET;
     }
 
-    (*patterns)[*pattern_count].groups[0].pcode = pcode;
-    (*patterns)[*pattern_count].groups[0].inverted = inverted;
+    if ((rc = augds_init_pattern_get(auginfo, expr, NULL, &pattern->groups[0].pattern))) {
+        return rc;
+    }
+    pattern->groups[0].inverted = inverted;
 
-    (*patterns)[*pattern_count].group_count = 1;
-    ++(*pattern_count);
+    pattern->group_count = 1;
     return SR_ERR_OK;
 }
 
 /**
  * @brief Add a new pattern to an array with multiple separate PCRE2 patterns.
  *
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
  * @param[in] ly_patterns Array of libyang compiled patterns.
  * @param[in,out] patterns Array of patterns to add to.
  * @param[in,out] pattern_count Count of @p patterns.
  * @return SR error value.
  */
 static int
-augds_init_auginfo_add_pattern2(struct lysc_pattern **ly_patterns, struct augnode_pattern **patterns,
-        uint32_t *pattern_count)
+augds_init_auginfo_add_pattern2(struct auginfo *auginfo, struct lysc_pattern **ly_patterns,
+        struct augnode_pattern **patterns, uint32_t *pattern_count)
 {
+    struct augnode_pattern *pattern;
     void *mem;
+    int rc;
     LY_ARRAY_COUNT_TYPE u;
 
     mem = realloc(*patterns, (*pattern_count + 1) * sizeof **patterns);
@@ -149,71 +384,122 @@ augds_init_auginfo_add_pattern2(struct lysc_pattern **ly_patterns, struct augnod
         AUG_LOG_ERRMEM_RET;
     }
     *patterns = mem;
+    pattern = &(*patterns)[*pattern_count];
+    memset(pattern, 0, sizeof *pattern);
+    ++(*pattern_count);
 
     /* add all the patterns as separate groups */
-    (*patterns)[*pattern_count].groups = calloc(LY_ARRAY_COUNT(ly_patterns), sizeof *(*patterns)[*pattern_count].groups);
-    if (!(*patterns)[*pattern_count].groups) {
+    pattern->groups = calloc(LY_ARRAY_COUNT(ly_patterns), sizeof *pattern->groups);
+    if (!pattern->groups) {
         AUG_LOG_ERRMEM_RET;
     }
 
     LY_ARRAY_FOR(ly_patterns, u) {
-        (*patterns)[*pattern_count].groups[u].pcode = ly_patterns[u]->code;
-        (*patterns)[*pattern_count].groups[u].inverted = ly_patterns[u]->inverted;
+        if ((rc = augds_init_pattern_get(auginfo, ly_patterns[u]->expr, ly_patterns[u]->code,
+                &pattern->groups[u].pattern))) {
+            return rc;
+        }
+        pattern->groups[u].inverted = ly_patterns[u]->inverted;
+        ++pattern->group_count;
     }
 
-    (*patterns)[*pattern_count].group_count = LY_ARRAY_COUNT(ly_patterns);
-    ++(*pattern_count);
     return SR_ERR_OK;
 }
 
 /**
- * @brief Compile a pattern.
+ * @brief Compare two literals, callback for qsort().
  *
- * @param[in] pattern Pattern to compile.
- * @param[out] pcode Compiled PCRE2 code.
+ * @param[in] lit1 Pointer to the first literal.
+ * @param[in] lit2 Pointer to the second literal.
+ * @return Result of strcmp().
+ */
+static int
+augds_init_auginfo_literal_cmp(const void *lit1, const void *lit2)
+{
+    return strcmp(*(const char **)lit1, *(const char **)lit2);
+}
+
+/**
+ * @brief Get literals from the label-literals extension to match Augeas labels for this node.
+ *
+ * The literals replace the pattern because a lookup in a sorted array is much faster than PCRE2 matching.
+ *
+ * @param[in] node YANG node with the data-path '$$'.
+ * @param[in,out] patterns Array of patterns to add to.
+ * @param[in,out] pattern_count Count of @p patterns.
+ * @param[out] found Set if the extension was found and the literals added.
  * @return SR error code.
  */
 static int
-augds_init_auginfo_compile_pattern(const char *pattern, pcre2_code **pcode)
+augds_init_auginfo_get_literals(const struct lysc_node *node, struct augnode_pattern **patterns,
+        uint32_t *pattern_count, int *found)
 {
-    char *pattern_d = NULL;
-    int err_code;
-    uint32_t compile_opts;
-    PCRE2_SIZE err_offset;
+    const char *arg = NULL;
+    struct augnode_pattern *pattern;
+    char *ptr;
+    void *mem;
+    uint32_t count;
+    LY_ARRAY_COUNT_TYPE u;
 
-    /* prepare options and pattern */
-    compile_opts = PCRE2_UTF | PCRE2_ANCHORED | PCRE2_DOLLAR_ENDONLY | PCRE2_NO_AUTO_CAPTURE;
+    *found = 0;
 
-    /* handle end anchor */
-#ifdef PCRE2_ENDANCHORED
-    compile_opts |= PCRE2_ENDANCHORED;
-#else
-    asprintf(&pattern_d, "%s$", pattern);
-    pattern = pattern_d;
-#endif
+    LY_ARRAY_FOR(node->exts, u) {
+        if (!strcmp(node->exts[u].def->module->name, "augeas-extension") &&
+                !strcmp(node->exts[u].def->name, "label-literals")) {
+            arg = node->exts[u].argument;
+            break;
+        }
+    }
+    if (!arg || !arg[0]) {
+        return SR_ERR_OK;
+    }
 
-    /* compile the pattern */
-    *pcode = pcre2_compile((PCRE2_SPTR)pattern, PCRE2_ZERO_TERMINATED, compile_opts, &err_code,
-            &err_offset, NULL);
-    free(pattern_d);
+    /* add pattern */
+    mem = realloc(*patterns, (*pattern_count + 1) * sizeof **patterns);
+    if (!mem) {
+        AUG_LOG_ERRMEM_RET;
+    }
+    *patterns = mem;
+    pattern = &(*patterns)[*pattern_count];
+    memset(pattern, 0, sizeof *pattern);
+    ++(*pattern_count);
 
-    if (!*pcode) {
-        PCRE2_UCHAR err_msg[AUG_PCRE2_MSG_LIMIT] = {0};
+    pattern->literal_buf = strdup(arg);
+    if (!pattern->literal_buf) {
+        AUG_LOG_ERRMEM_RET;
+    }
 
-        pcre2_get_error_message(err_code, err_msg, AUG_PCRE2_MSG_LIMIT);
+    /* literals are separated by a single space */
+    count = 1;
+    for (ptr = pattern->literal_buf; *ptr; ++ptr) {
+        if (*ptr == ' ') {
+            ++count;
+        }
+    }
+    pattern->literals = malloc(count * sizeof *pattern->literals);
+    if (!pattern->literals) {
+        AUG_LOG_ERRMEM_RET;
+    }
 
-        SRPLG_LOG_ERR(srpds_name, "Regular expression \"%s\" is not valid (\"%s\": %s).", pattern,
-                pattern + err_offset, (const char *)err_msg);
-        return SR_ERR_INTERNAL;
+    pattern->literals[pattern->literal_count++] = pattern->literal_buf;
+    for (ptr = pattern->literal_buf; *ptr; ++ptr) {
+        if (*ptr == ' ') {
+            *ptr = '\0';
+            pattern->literals[pattern->literal_count++] = ptr + 1;
+        }
     }
 
+    /* augyang prints them sorted but do not rely on it */
+    qsort(pattern->literals, pattern->literal_count, sizeof *pattern->literals, augds_init_auginfo_literal_cmp);
+
+    *found = 1;
     return SR_ERR_OK;
 }
 
 /**
  * @brief Get pattern to match Augeas labels for this node.
  *
- * @param[in] auginfo Base auginfo structure with the compiled uint64 pattern cache.
+ * @param[in] auginfo Base auginfo structure with the pattern cache.
  * @param[in] node YANG node with the pattern.
  * @param[in,out] patterns Array of patterns to add to.
  * @param[in,out] pattern_count Count of @p patterns.
@@ -241,15 +527,12 @@ augds_init_auginfo_get_pattern(struct auginfo *auginfo, const struct lysc_node *
     if (type->basetype == LY_TYPE_STRING) {
         /* use the compiled pattern by libyang */
         stype = (const struct lysc_type_str *)type;
-        if ((rc = augds_init_auginfo_add_pattern2(stype->patterns, patterns, pattern_count))) {
+        if ((rc = augds_init_auginfo_add_pattern2(auginfo, stype->patterns, patterns, pattern_count))) {
             return rc;
         }
     } else if (type->basetype == LY_TYPE_UINT64) {
         /* use the pattern compiled ourselves */
-        if (!auginfo->pcode_uint64 && (rc = augds_init_auginfo_compile_pattern("[0-9]+", &auginfo->pcode_uint64))) {
-            return rc;
-        }
-        if ((rc = augds_init_auginfo_add_pattern(auginfo->pcode_uint64, 0, patterns, pattern_count))) {
+        if ((rc = augds_init_auginfo_add_pattern(auginfo, "[0-9]+", 0, patterns, pattern_count))) {
             return rc;
         }
     } else if (type->basetype == LY_TYPE_UNION) {
@@ -259,7 +542,7 @@ augds_init_auginfo_get_pattern(struct auginfo *auginfo, const struct lysc_node *
             type = utype->types[u];
             if (type->basetype == LY_TYPE_STRING) {
                 stype = (const struct lysc_type_str *)type;
-                if ((rc = augds_init_auginfo_add_pattern2(stype->patterns, patterns, pattern_count))) {
+                if ((rc = augds_init_auginfo_add_pattern2(auginfo, stype->patterns, patterns, pattern_count))) {
                     return rc;
                 }
             } else {
@@ -287,7 +570,7 @@ static int
 augds_init_auginfo_case(struct auginfo *auginfo, const struct lysc_node *node, struct augnode *anode,
         int *mand_found)
 {
-    int r;
+    int r, found;
     struct augnode_case_node *acnode;
     const struct lysc_node *child;
     enum augds_ext_node_type node_type;
@@ -314,9 +597,15 @@ augds_init_auginfo_case(struct auginfo *auginfo, const struct lysc_node *node, s
             *mand_found = 1;
 
             if (node_type == AUGDS_EXT_NODE_LABEL) {
-                /* use the label pattern of the first child */
+                /* use the label literals, if any */
+                if ((r = augds_init_auginfo_get_literals(node, &acnode->patterns, &acnode->pattern_count, &found))) {
+                    return r;
+                }
+
+                /* otherwise the label pattern of the first child */
                 child = lys_getnext(NULL, node, NULL, 0);
-                if ((r = augds_init_auginfo_get_pattern(auginfo, child, &acnode->patterns, &acnode->pattern_count))) {
+                if (!found && (r = augds_init_auginfo_get_pattern(auginfo, child, &acnode->patterns,
+                        &acnode->pattern_count))) {
                     return r;
                 }
             } /* otherwise matching the label is enough */
@@ -390,7 +679,7 @@ augds_init_auginfo_siblings_r(struct auginfo *auginfo, const struct lys_module *
     struct augnode *anode;
     void *mem;
     uint32_t i, j;
-    int r, mand_found;
+    int r, mand_found, found;
 
     while ((node = lys_getnext(node, parent ? parent->schema : NULL, mod ? mod->compiled : NULL, 0))) {
         /* learn about the node */
@@ -431,8 +720,13 @@ augds_init_auginfo_siblings_r(struct auginfo *auginfo, const struct lys_module *
         anode->schema2 = node2;
 
         if (node_type == AUGDS_EXT_NODE_LABEL) {
-            /* get the pattern */
-            augds_init_auginfo_get_pattern(auginfo, node, &anode->patterns, &anode->pattern_count);
+            /* get the label literals or the pattern */
+            if ((r = augds_init_auginfo_get_literals(node, &anode->patterns, &anode->pattern_count, &found))) {
+                return r;
+            }
+            if (!found) {
+                augds_init_auginfo_get_pattern(auginfo, node, &anode->patterns, &anode->pattern_count);
+            }
         } else if ((node_type == AUGDS_EXT_NODE_NONE) && node->parent && (node->parent->nodetype == LYS_CASE)) {
             /* special case handling to be able to properly load these data, 1) there may be optional nodes and we need
              * to handle situations without them (every node has its own case struct) or 2) there can be more suitable
@@ -457,78 +751,403 @@ augds_init_auginfo_siblings_r(struct auginfo *auginfo, const struct lys_module *
     return SR_ERR_OK;
 }
 
-int
-augds_init(struct auginfo *auginfo, const struct lys_module *mod, struct augmod **augmod)
+/**
+ * @brief Get the qualified name of the lens autoloaded by the Augeas module of a YANG module.
+ *
+ * @param[in] mod YANG module.
+ * @return Lens name from the autoload-lens extension, NULL if the YANG module does not have it.
+ */
+static const char *
+augds_init_autoload_lens(const struct lys_module *mod)
 {
-    int rc = SR_ERR_OK;
-    uint32_t i;
-    const char *lens;
-    char *path = NULL, *value = NULL;
-    void *ptr;
-    struct augmod *augm = NULL;
+    LY_ARRAY_COUNT_TYPE u;
+    const struct lysc_ext *ext;
 
-    if (!auginfo->aug) {
-        /* init augeas with all modules but no loaded files */
-        auginfo->aug = aug_init(NULL, NULL, AUG_NO_LOAD | AUG_NO_ERR_CLOSE | AUG_SAVE_BACKUP);
-        if ((rc = augds_check_erraug(auginfo->aug))) {
-            goto cleanup;
+    LY_ARRAY_FOR(mod->compiled->exts, u) {
+        ext = mod->compiled->exts[u].def;
+        if (!strcmp(ext->module->name, "augeas-extension") && !strcmp(ext->name, "autoload-lens")) {
+            return mod->compiled->exts[u].argument;
         }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set the transform of a lens from the autoload extensions of its YANG module.
+ *
+ * The qualified lens name makes Augeas load only its module and the modules it depends on, which would
+ * otherwise need to be all loaded by aug_init() for '@<lens>' to be found.
+ *
+ * @param[in] aug Augeas handle created with AUG_NO_MODL_AUTOLOAD.
+ * @param[in] auglens Augeas transform of the YANG module with the autoloaded lens.
+ * @return SR error code.
+ */
+static int
+augds_init_autoload(augeas *aug, const struct auglens *auglens)
+{
+    int rc = SR_ERR_OK;
+    char *path = NULL;
+    uint32_t i, incl = 0, excl = 0;
 
-        /* remove all lenses except this one so we are left only with 'incl' and 'excl' for all the lenses */
-        aug_rm(auginfo->aug, "/augeas/load/*/lens");
+    if (asprintf(&path, "/augeas/load/%s/lens", auglens->lens) == -1) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    if (aug_set(aug, path, auglens->autoload_lens) == -1) {
+        AUG_LOG_ERRAUG_GOTO(aug, rc, cleanup);
     }
 
-    /* try to find this module in auginfo, it must be there if already initialized */
-    for (i = 0; i < auginfo->mod_count; ++i) {
-        if (auginfo->mods[i].mod == mod) {
-            /* found */
-            augm = &auginfo->mods[i];
-            goto cleanup;
+    /* the filter in the same order as the autoload transform */
+    for (i = 0; i < auglens->filter_count; ++i) {
+        free(path);
+        if (asprintf(&path, "/augeas/load/%s/%s[%" PRIu32 "]", auglens->lens,
+                auglens->filters[i].incl ? "incl" : "excl", auglens->filters[i].incl ? ++incl : ++excl) == -1) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+        if (aug_set(aug, path, auglens->filters[i].glob) == -1) {
+            AUG_LOG_ERRAUG_GOTO(aug, rc, cleanup);
         }
     }
 
-    /* get lens name */
+cleanup:
+    free(path);
+    return rc;
+}
+
+int
+augds_init_lens_get(const struct lys_module *mod, struct auglens *auglens)
+{
+    int rc = SR_ERR_OK, is_incl;
+    const char *lens, *autoload_lens, *name;
+    void *mem;
+    LY_ARRAY_COUNT_TYPE u;
+
+    memset(auglens, 0, sizeof *auglens);
+
     if ((rc = augds_get_lens(mod, &lens))) {
         goto cleanup;
     }
+    if (!(auglens->mod_name = strdup(mod->name)) || !(auglens->lens = strdup(lens))) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
 
-    /* set this lens so that it can be loaded */
+    autoload_lens = augds_init_autoload_lens(mod);
+    if (!autoload_lens) {
+        /* YANG module generated without the autoload extensions */
+        goto cleanup;
+    }
+    if (!(auglens->autoload_lens = strdup(autoload_lens))) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+
+    LY_ARRAY_FOR(mod->compiled->exts, u) {
+        name = mod->compiled->exts[u].def->name;
+        if (strcmp(mod->compiled->exts[u].def->module->name, "augeas-extension") ||
+                (strcmp(name, "autoload-incl") && strcmp(name, "autoload-excl"))) {
+            continue;
+        }
+        is_incl = !strcmp(name, "autoload-incl");
+
+        mem = realloc(auglens->filters, (auglens->filter_count + 1) * sizeof *auglens->filters);
+        if (!mem) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+        auglens->filters = mem;
+        auglens->filters[auglens->filter_count].incl = is_incl;
+        if (!(auglens->filters[auglens->filter_count].glob = strdup(mod->compiled->exts[u].argument))) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+        ++auglens->filter_count;
+    }
+
+cleanup:
+    if (rc) {
+        augds_init_lens_free(auglens);
+    }
+    return rc;
+}
+
+void
+augds_init_lens_free(struct auglens *auglens)
+{
+    uint32_t i;
+
+    free(auglens->mod_name);
+    free(auglens->lens);
+    free(auglens->autoload_lens);
+    for (i = 0; i < auglens->filter_count; ++i) {
+        free(auglens->filters[i].glob);
+    }
+    free(auglens->filters);
+    memset(auglens, 0, sizeof *auglens);
+}
+
+/**
+ * @brief Get the memory of augnode patterns.
+ *
+ * @param[in] patterns Array of patterns.
+ * @param[in] pattern_count Count of @p patterns.
+ * @return Memory in bytes, without the compiled PCRE2 patterns owned by libyang.
+ */
+static uint64_t
+augds_init_info_size_patterns(const struct augnode_pattern *patterns, uint32_t pattern_count)
+{
+    uint64_t size;
+    uint32_t i, j;
+
+    size = pattern_count * sizeof *patterns;
+    for (i = 0; i < pattern_count; ++i) {
+        size += patterns[i].group_count * sizeof *patterns[i].groups;
+        size += patterns[i].literal_count * sizeof *patterns[i].literals;
+        for (j = 0; j < patterns[i].literal_count; ++j) {
+            size += strlen(patterns[i].literals[j]) + 1;
+        }
+    }
+
+    return size;
+}
+
+/**
+ * @brief Get the memory of augnodes, recursively.
+ *
+ * @param[in] augnodes Array of augnodes.
+ * @param[in] augnode_count Count of @p augnodes.
+ * @return Memory in bytes.
+ */
+static uint64_t
+augds_init_info_size_r(const struct augnode *augnodes, uint32_t augnode_count)
+{
+    uint64_t size;
+    uint32_t i, j;
+
+    size = augnode_count * sizeof *augnodes;
+    for (i = 0; i < augnode_count; ++i) {
+        size += augnodes[i].cnode_count * sizeof *augnodes[i].case_nodes;
+        for (j = 0; j < augnodes[i].cnode_count; ++j) {
+            size += augds_init_info_size_patterns(augnodes[i].case_nodes[j].patterns,
+                    augnodes[i].case_nodes[j].pattern_count);
+        }
+        size += augds_init_info_size_patterns(augnodes[i].patterns, augnodes[i].pattern_count);
+        size += augds_init_info_size_r(augnodes[i].child, augnodes[i].child_count);
+    }
+
+    return size;
+}
+
+/**
+ * @brief Get the memory limit of the modules.
+ *
+ * @return Memory limit in bytes from ::AUG_MEM_LIMIT_ENV with an optional 'K', 'M', or 'G' suffix, 0 if unlimited.
+ */
+static uint64_t
+augds_init_mem_limit(void)
+{
+    const char *str;
+    char *ptr;
+    uint64_t limit;
+
+    str = getenv(AUG_MEM_LIMIT_ENV);
+    if (!str || !str[0]) {
+        return 0;
+    }
+
+    errno = 0;
+    limit = strtoull(str, &ptr, 10);
+    switch (*ptr) {
+    case 'G':
+    case 'g':
+        limit *= 1024;
+    /* fallthrough */
+    case 'M':
+    case 'm':
+        limit *= 1024;
+    /* fallthrough */
+    case 'K':
+    case 'k':
+        limit *= 1024;
+        ++ptr;
+        break;
+    }
+    if (errno || (str[0] == '-') || (ptr == str) || *ptr) {
+        SRPLG_LOG_WRN(srpds_name, "Invalid memory limit \"%s\", the modules are not limited.", str);
+        return 0;
+    }
+
+    return limit;
+}
+
+/**
+ * @brief Load the Augeas data of a module whose data were evicted.
+ *
+ * @param[in] auginfo Base auginfo structure.
+ * @param[in] augmod Evicted module.
+ * @return SR error code.
+ */
+static int
+augds_init_restore(struct auginfo *auginfo, struct augmod *augmod)
+{
+    int rc = SR_ERR_OK;
+    const char *lens, *autoload_lens;
+    char *path = NULL, *value = NULL;
+
+    /* load the lens again, its 'incl' and 'excl' were kept */
+    if ((rc = augds_get_lens(augmod->mod, &lens))) {
+        goto cleanup;
+    }
+    autoload_lens = augds_init_autoload_lens(augmod->mod);
     if (asprintf(&path, "/augeas/load/%s/lens", lens) == -1) {
         AUG_LOG_ERRMEM_GOTO(rc, cleanup);
     }
-    if (asprintf(&value, "@%s", lens) == -1) {
+    if (auginfo->autoload_all) {
+        if (asprintf(&value, "@%s", lens) == -1) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+    } else if (!(value = strdup(autoload_lens))) {
         AUG_LOG_ERRMEM_GOTO(rc, cleanup);
     }
     if (aug_set(auginfo->aug, path, value) == -1) {
         AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
     }
 
-#ifdef AUG_TEST_INPUT_FILES
-    /* for testing, remove all default includes */
+    /* parse its config files */
+    aug_load(auginfo->aug);
+    if ((rc = augds_check_erraug(auginfo->aug))) {
+        goto cleanup;
+    }
+    augmod->evicted = 0;
+
+    augds_mem_update(auginfo, augmod);
+
+cleanup:
     free(path);
+    free(value);
+    return rc;
+}
+
+#if defined (AUG_TEST_INPUT_FILES) && !defined (AUG_TEST_LENS_INPUT_FILES)
+
+/**
+ * @brief Test input files of a lens, the same AUG_TEST_INPUT_FILES for all the lenses.
+ *
+ * @param[in] lens Augeas lens (module) name.
+ */
+# define AUG_TEST_LENS_INPUT_FILES(lens) AUG_TEST_INPUT_FILES
+
+#endif
+
+#ifdef AUG_TEST_LENS_INPUT_FILES
+
+/**
+ * @brief Set only the test input files to be loaded by a lens.
+ *
+ * @param[in] aug Augeas handle.
+ * @param[in] lens Augeas lens (module) name.
+ * @param[in] files Test input files separated by ';'.
+ * @return SR error code.
+ */
+static int
+augds_init_test_files(augeas *aug, const char *lens, const char *files)
+{
+    int rc = SR_ERR_OK;
+    uint32_t i;
+    char *path = NULL, *value = NULL, *ptr;
+
+    /* remove all default includes */
     if (asprintf(&path, "/augeas/load/%s/incl", lens) == -1) {
         AUG_LOG_ERRMEM_GOTO(rc, cleanup);
     }
-    aug_rm(auginfo->aug, path);
+    aug_rm(aug, path);
 
     /* create new file instead of creating a backup and overwriting */
-    if (aug_set(auginfo->aug, "/augeas/save", "newfile") == -1) {
-        AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
+    if (aug_set(aug, "/augeas/save", "newfile") == -1) {
+        AUG_LOG_ERRAUG_GOTO(aug, rc, cleanup);
     }
 
     /* set only test files to be loaded */
-    free(value);
-    value = strdup(AUG_TEST_INPUT_FILES);
+    value = strdup(files);
+    if (!value) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
     i = 1;
     for (ptr = strtok(value, ";"); ptr; ptr = strtok(NULL, ";")) {
         free(path);
         if (asprintf(&path, "/augeas/load/%s/incl[%" PRIu32 "]", lens, i++) == -1) {
             AUG_LOG_ERRMEM_GOTO(rc, cleanup);
         }
-        if (aug_set(auginfo->aug, path, ptr) == -1) {
+        if (aug_set(aug, path, ptr) == -1) {
+            AUG_LOG_ERRAUG_GOTO(aug, rc, cleanup);
+        }
+    }
+
+cleanup:
+    free(path);
+    free(value);
+    return rc;
+}
+
+#endif
+
+int
+augds_init_lens(struct auginfo *auginfo, const struct auglens *auglens)
+{
+    int rc = SR_ERR_OK;
+    const char *lens = auglens->lens;
+    char *path = NULL, *value = NULL;
+
+    if (!auglens->autoload_lens && !auginfo->autoload_all) {
+        /* YANG module generated without the autoload extensions, all the Augeas modules must be loaded */
+        if (auginfo->aug) {
+            SRPLG_LOG_INF(srpds_name, "Module \"%s\" requires loading all the Augeas modules.",
+                    auglens->mod_name);
+            augds_destroy(auginfo);
+        }
+        auginfo->autoload_all = 1;
+    }
+
+    if (!auginfo->aug) {
+        auginfo->mem_limit = augds_init_mem_limit();
+
+        if (auginfo->autoload_all) {
+            /* init augeas with all modules but no loaded files */
+            auginfo->aug = aug_init(NULL, NULL, AUG_NO_LOAD | AUG_NO_ERR_CLOSE | AUG_SAVE_BACKUP);
+            if ((rc = augds_check_erraug(auginfo->aug))) {
+                goto cleanup;
+            }
+
+            /* remove all lenses except this one so we are left only with 'incl' and 'excl' for all the lenses */
+            aug_rm(auginfo->aug, "/augeas/load/*/lens");
+        } else {
+            /* init augeas without any modules, they are loaded when needed */
+            auginfo->aug = aug_init(NULL, NULL, AUG_NO_MODL_AUTOLOAD | AUG_NO_LOAD | AUG_NO_ERR_CLOSE |
+                    AUG_SAVE_BACKUP);
+            if ((rc = augds_check_erraug(auginfo->aug))) {
+                goto cleanup;
+            }
+        }
+    }
+
+    /* set this lens so that it can be loaded */
+    if (!auginfo->autoload_all) {
+        if ((rc = augds_init_autoload(auginfo->aug, auglens))) {
+            goto cleanup;
+        }
+    } else {
+        if (asprintf(&path, "/augeas/load/%s/lens", lens) == -1) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+        if (asprintf(&value, "@%s", lens) == -1) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+        if (aug_set(auginfo->aug, path, value) == -1) {
             AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
         }
     }
+
+#ifdef AUG_TEST_LENS_INPUT_FILES
+    /* for testing, only the test files are loaded */
+    if ((rc = augds_init_test_files(auginfo->aug, lens, AUG_TEST_LENS_INPUT_FILES(lens)))) {
+        goto cleanup;
+    }
 #endif
 
     /* load data to populate parsed files */
@@ -537,6 +1156,45 @@ augds_init(struct auginfo *auginfo, const struct lys_module *mod, struct augmod
         goto cleanup;
     }
 
+cleanup:
+    free(path);
+    free(value);
+    return rc;
+}
+
+int
+augds_init(struct auginfo *auginfo, const struct lys_module *mod, struct augmod **augmod)
+{
+    int rc = SR_ERR_OK;
+    uint32_t i;
+    void *ptr;
+    struct augmod *augm = NULL;
+    struct auglens auglens = {0};
+
+    /* try to find this module in auginfo, it must be there if already initialized */
+    for (i = 0; i < auginfo->mod_count; ++i) {
+        if (auginfo->mods[i].mod == mod) {
+            /* found */
+            augm = &auginfo->mods[i];
+            augm->last_use = ++auginfo->use_count;
+            if (augm->stats) {
+                augds_stats_add(&augm->stats->init_hits, 1);
+            }
+            if (augm->evicted) {
+                rc = augds_init_restore(auginfo, augm);
+            }
+            goto cleanup;
+        }
+    }
+
+    /* get the Augeas transform and parse the config files */
+    if ((rc = augds_init_lens_get(mod, &auglens))) {
+        goto cleanup;
+    }
+    if ((rc = augds_init_lens(auginfo, &auglens))) {
+        goto cleanup;
+    }
+
     /* create new auginfo module */
     ptr = realloc(auginfo->mods, (auginfo->mod_count + 1) * sizeof *auginfo->mods);
     if (!ptr) {
@@ -550,13 +1208,27 @@ augds_init(struct auginfo *auginfo, const struct lys_module *mod, struct augmod
     augm->mod = mod;
     augm->toplevel = NULL;
     augm->toplevel_count = 0;
+    augm->stats = augds_stats_module(mod->name);
+    augm->last_use = ++auginfo->use_count;
+    augm->data_size = 0;
+    augm->evicted = 0;
     if ((rc = augds_init_auginfo_siblings_r(auginfo, mod, NULL, &augm->toplevel, &augm->toplevel_count))) {
         goto cleanup;
     }
+    augm->info_size = augds_init_info_size_r(augm->toplevel, augm->toplevel_count);
+    if (augm->stats) {
+        augds_stats_add(&augm->stats->init_misses, 1);
+        __atomic_store_n(&augm->stats->info_bytes, augm->info_size, __ATOMIC_RELAXED);
+    }
+
+    /* account its Augeas data, which may evict other modules */
+    augds_mem_update(auginfo, augm);
+
+    /* watch its config files, if enabled */
+    augds_watch_module(auginfo, mod);
 
 cleanup:
-    free(path);
-    free(value);
+    augds_init_lens_free(&auglens);
     if (augmod) {
         *augmod = augm;
     }
@@ -575,11 +1247,14 @@ augds_destroy(struct auginfo *auginfo)
     struct augmod *mod;
     uint32_t i, j;
 
+    /* stop watching the config files of the modules */
+    augds_watch_destroy(&auginfo->watch);
+
     /* free auginfo */
     for (i = 0; i < auginfo->mod_count; ++i) {
         mod = &auginfo->mods[i];
         for (j = 0; j < mod->toplevel_count; ++j) {
-            augds_free_info_node(&mod->toplevel[j]);
+            augds_free_info_node(auginfo, &mod->toplevel[j]);
         }
         free(mod->toplevel);
     }
@@ -591,6 +1266,139 @@ augds_destroy(struct auginfo *auginfo)
     aug_close(auginfo->aug);
     auginfo->aug = NULL;
 
-    /* free compiled patterns */
-    pcre2_code_free(auginfo->pcode_uint64);
+    /* free the compiled patterns, only those leaked by a failed initialization are left */
+    for (i = 0; i < auginfo->pattern_count; ++i) {
+        augds_init_pattern_free(auginfo->patterns[i]);
+    }
+    free(auginfo->patterns);
+    auginfo->patterns = NULL;
+    auginfo->pattern_count = 0;
+}
+
+/**
+ * @brief Estimate the memory of the Augeas data of a module.
+ *
+ * @param[in] aug Augeas handle.
+ * @param[in] mod YANG module.
+ * @return Memory in bytes, 0 on error.
+ */
+static uint64_t
+augds_mem_data_size(augeas *aug, const struct lys_module *mod)
+{
+    const char **files = NULL;
+    char *path = NULL;
+    uint32_t i, file_count;
+    uint64_t count = 0;
+    int r;
+
+    if (augds_get_config_files(aug, mod, 0, &files, &file_count)) {
+        return 0;
+    }
+
+    /* count all the nodes of the files, there is no way to learn the exact memory */
+    for (i = 0; i < file_count; ++i) {
+        if (asprintf(&path, "%s//*", files[i]) == -1) {
+            AUG_LOG_ERRMEM;
+            break;
+        }
+        r = aug_match(aug, path, NULL);
+        free(path);
+        if (r > 0) {
+            count += r;
+        }
+        ++count;
+    }
+
+    free(files);
+    return count * AUG_MEM_NODE_SIZE;
+}
+
+/**
+ * @brief Evict the Augeas data of a module.
+ *
+ * @param[in] auginfo Base auginfo structure.
+ * @param[in] augmod Module to evict.
+ * @return SR error code.
+ */
+static int
+augds_mem_evict(struct auginfo *auginfo, struct augmod *augmod)
+{
+    int rc = SR_ERR_OK;
+    const char **files = NULL, *lens;
+    char *path = NULL;
+    uint32_t i, file_count;
+
+    /* get the files while their metadata still exist */
+    if ((rc = augds_get_config_files(auginfo->aug, augmod->mod, 0, &files, &file_count))) {
+        goto cleanup;
+    }
+
+    /* stop loading the lens so that its files are not parsed again by aug_load() */
+    if ((rc = augds_get_lens(augmod->mod, &lens))) {
+        goto cleanup;
+    }
+    if (asprintf(&path, "/augeas/load/%s/lens", lens) == -1) {
+        AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+    }
+    if (aug_rm(auginfo->aug, path) == -1) {
+        AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
+    }
+
+    for (i = 0; i < file_count; ++i) {
+        free(path);
+        if (asprintf(&path, "/augeas%s", files[i]) == -1) {
+            AUG_LOG_ERRMEM_GOTO(rc, cleanup);
+        }
+
+        /* remove the data and then the metadata with the file path, without them aug_save() would delete the file */
+        if ((aug_rm(auginfo->aug, files[i]) == -1) || (aug_rm(auginfo->aug, path) == -1)) {
+            AUG_LOG_ERRAUG_GOTO(auginfo->aug, rc, cleanup);
+        }
+    }
+
+    SRPLG_LOG_INF(srpds_name, "Augeas data of module \"%s\" evicted (%" PRIu64 " kB).", augmod->mod->name,
+            augmod->data_size / 1024);
+    augmod->evicted = 1;
+    augmod->data_size = 0;
+    if (augmod->stats) {
+        augds_stats_add(&augmod->stats->evictions, 1);
+    }
+
+cleanup:
+    free(path);
+    free(files);
+    return rc;
+}
+
+void
+augds_mem_update(struct auginfo *auginfo, struct augmod *augmod)
+{
+    struct augmod *lru;
+    uint64_t used;
+    uint32_t i;
+
+    augmod->data_size = augds_mem_data_size(auginfo->aug, augmod->mod);
+    if (augmod->stats) {
+        __atomic_store_n(&augmod->stats->data_bytes, augmod->data_size, __ATOMIC_RELAXED);
+    }
+
+    if (!auginfo->mem_limit) {
+        return;
+    }
+
+    do {
+        /* learn the used memory and the least recently used module with some data */
+        used = 0;
+        lru = NULL;
+        for (i = 0; i < auginfo->mod_count; ++i) {
+            used += auginfo->mods[i].info_size + auginfo->mods[i].data_size;
+            if ((&auginfo->mods[i] != augmod) && !auginfo->mods[i].evicted &&
+                    (!lru || (auginfo->mods[i].last_use < lru->last_use))) {
+                lru = &auginfo->mods[i];
+            }
+        }
+        if ((used <= auginfo->mem_limit) || !lru) {
+            break;
+        }
+    } while (!augds_mem_evict(auginfo, lru));
 }
@@ -161,7 +161,20 @@ augds_ext_label_node_equal(const char *ext_node, const char *label_node, enum au
 }
 
 /**
- * @brief Check whether an Augeas label matches at least one compiled pattern group.
+ * @brief Compare a label with a literal, callback for bsearch().
+ *
+ * @param[in] label Label to find.
+ * @param[in] lit Pointer to the literal.
+ * @return Result of strcmp().
+ */
+static int
+augds_pattern_literal_cmp(const void *label, const void *lit)
+{
+    return strcmp(label, *(const char **)lit);
+}
+
+/**
+ * @brief Check whether an Augeas label matches at least one compiled pattern group or is one of the literals.
  *
  * @param[in] patterns Array of patterns.
  * @param[in] pattern_count Count of @p patterns.
@@ -172,32 +185,30 @@ augds_ext_label_node_equal(const char *ext_node, const char *label_node, enum au
 static int
 augds_pattern_label_match(struct augnode_pattern *patterns, uint32_t pattern_count, const char *label_node, int *match)
 {
-    pcre2_match_data *match_data;
     struct augnode_pattern_group *group;
-    uint32_t match_opts, i, j;
+    uint32_t i, j;
     int r, group_match;
 
     *match = 0;
 
     for (i = 0; i < pattern_count; ++i) {
+        if (patterns[i].literals) {
+            /* the label must be one of the literals */
+            if (bsearch(label_node, patterns[i].literals, patterns[i].literal_count, sizeof *patterns[i].literals,
+                    augds_pattern_literal_cmp)) {
+                *match = 1;
+                break;
+            }
+            continue;
+        }
+
         group_match = 1;
         for (j = 0; j < patterns[i].group_count; ++j) {
             group = &patterns[i].groups[j];
 
-            match_data = pcre2_match_data_create_from_pattern(group->pcode, NULL);
-            if (!match_data) {
-                AUG_LOG_ERRMEM_RET;
-            }
-
-            match_opts = PCRE2_ANCHORED;
-#ifdef PCRE2_ENDANCHORED
-            /* PCRE2_ENDANCHORED was added in PCRE2 version 10.30 */
-            match_opts |= PCRE2_ENDANCHORED;
-#endif
-
             /* evaluate */
-            r = pcre2_match(group->pcode, (PCRE2_SPTR)label_node, PCRE2_ZERO_TERMINATED, 0, match_opts, match_data, NULL);
-            pcre2_match_data_free(match_data);
+            r = pcre2_match(group->pattern->pcode, (PCRE2_SPTR)label_node, PCRE2_ZERO_TERMINATED, 0,
+                    group->pattern->match_opts, group->pattern->match_data, NULL);
             if ((r != PCRE2_ERROR_NOMATCH) && (r < 0)) {
                 PCRE2_UCHAR pcre2_errmsg[AUG_PCRE2_MSG_LIMIT] = {0};
 
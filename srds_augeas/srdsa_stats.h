@@ -0,0 +1,87 @@
+/**
+ * @file srdsa_stats.h
+ * @author agent <agent@local>
+ * @brief statistics of the augeas DS plugin shared by all the processes
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+#ifndef SRDSA_STATS_H_
+#define SRDSA_STATS_H_
+
+#include <stdint.h>
+
+#define AUG_STATS_ENV "SRDS_AUGEAS_STATS"   /**< environment variable with the statistics file, unset or empty disables them */
+
+#define AUG_STATS_VERSION 1         /**< version of the layout of the statistics file */
+#define AUG_STATS_MODULES 512       /**< maximum number of modules with statistics */
+#define AUG_STATS_BUCKETS 24        /**< number of histogram buckets, bucket i counts durations < 2^i us */
+#define AUG_STATS_NAME_LEN 64       /**< maximum length of a module name including the terminating zero */
+
+/**
+ * @brief Datastore plugin callbacks with statistics.
+ */
+enum augstats_cb {
+    AUGSTATS_CB_LOAD = 0,
+    AUGSTATS_CB_STORE,
+    AUGSTATS_CB_LAST_MODIF,
+    AUGSTATS_CB_ACCESS_CHECK,
+    AUGSTATS_CB_COUNT
+};
+
+/**
+ * @brief Phases of the callbacks with statistics.
+ */
+enum augstats_phase {
+    AUGSTATS_PH_PARSE = 0,          /**< aug_load() */
+    AUGSTATS_PH_AUG2YANG,           /**< augds_aug2yang_augnode_r() */
+    AUGSTATS_PH_DIFF,               /**< lyd_diff_siblings() */
+    AUGSTATS_PH_STORE_DIFF,         /**< augds_store_diff_r() */
+    AUGSTATS_PH_SAVE,               /**< aug_save() */
+    AUGSTATS_PH_COUNT
+};
+
+/**
+ * @brief Latency statistics, all the members are updated atomically.
+ */
+struct augstats_lat {
+    uint64_t count;                 /**< number of calls */
+    uint64_t total_usec;            /**< total duration */
+    uint64_t max_usec;              /**< longest duration */
+    uint64_t buckets[AUG_STATS_BUCKETS];    /**< histogram of the durations */
+};
+
+/**
+ * @brief Statistics of a module.
+ */
+struct augstats_mod {
+    uint32_t state;                 /**< 0 if free, 1 if being claimed, 2 if the name is set */
+    char name[AUG_STATS_NAME_LEN];  /**< module name */
+
+    uint64_t init_hits;             /**< callbacks using the initialized augmod */
+    uint64_t init_misses;           /**< initializations of the augmod */
+    uint64_t loaded_nodes;          /**< YANG data nodes created by the loads */
+    uint64_t diff_nodes;            /**< diff nodes applied by the stores */
+    uint64_t evictions;             /**< evictions of the Augeas data of the module over the memory limit */
+    uint64_t data_bytes;            /**< estimated memory of the Augeas data at the last load by any process */
+    uint64_t info_bytes;            /**< memory of the module information, set by the process initializing it */
+    struct augstats_lat cbs[AUGSTATS_CB_COUNT];         /**< callback statistics */
+    struct augstats_lat phases[AUGSTATS_PH_COUNT];      /**< phase statistics */
+};
+
+/**
+ * @brief Layout of the statistics file mapped by all the processes using the plugin.
+ */
+struct augstats {
+    uint32_t version;               /**< AUG_STATS_VERSION, set by the process creating the file */
+    struct augstats_mod mods[AUG_STATS_MODULES];    /**< statistics of the modules */
+};
+
+#endif /* SRDSA_STATS_H_ */
@@ -18,46 +18,92 @@
 
 #include "srplgda_config.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <inttypes.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 #include <libyang/libyang.h>
 #include <sysrepo.h>
 
+#include "srdsa_stats.h"
 #include "srplgda_common.h"
+#include "srplgda_queue.h"
 
 #define PLG_NAME "srplgd_augeas"
 
+/**
+ * @brief Plugin private data.
+ */
+struct aug_plugin {
+    sr_subscription_ctx_t *subscr;  /**< subscriptions to all the supported modules */
+    struct aug_queue *queue;        /**< queue of the actions applying the changes */
+    struct aug_module *modules;     /**< subscribed modules */
+    const struct augstats *stats;   /**< mapped statistics of the augeas DS plugin, NULL if not mapped yet */
+};
+
+/**
+ * @brief Restart a service if it is running.
+ *
+ * @param[in] arg Service name.
+ * @return SR_ERR value.
+ */
 static int
-aug_service_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *private_data)
+aug_restart_apply(const char *arg)
+{
+    return aug_execl(PLG_NAME, SYSTEMCTL_EXECUTABLE, "try-restart", arg, NULL);
+}
+
+/**
+ * @brief Reload the configuration of a service if it is running, restart it if it does not support reloading.
+ *
+ * @param[in] arg Service name.
+ * @return SR_ERR value.
+ */
+static int
+aug_reload_apply(const char *arg)
+{
+    return aug_execl(PLG_NAME, SYSTEMCTL_EXECUTABLE, "try-reload-or-restart", arg, NULL);
+}
+
+/**
+ * @brief Send SIGHUP to a daemon so that it rereads its configuration.
+ *
+ * @param[in] arg PID file path of the daemon.
+ * @return SR_ERR value.
+ */
+static int
+aug_sighup_apply(const char *arg)
 {
-    const char *service_name = private_data;
     int r;
+    pid_t pid;
 
-    if (event != SR_EV_DONE) {
+    if ((r = aug_pidfile(PLG_NAME, arg, &pid))) {
+        return r;
+    }
+    if (!pid) {
+        /* daemon not running */
         return SR_ERR_OK;
     }
 
-    if ((r = aug_execl(PLG_NAME, SYSTEMCTL_EXECUTABLE, "try-restart", service_name, NULL))) {
-        return r;
-    }
-    return SR_ERR_OK;
+    return aug_send_sig(PLG_NAME, pid, SIGHUP);
 }
 
 #ifdef ACTIVEMQ_EXECUTABLE
 
 static int
-aug_actimemq_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_actimemq_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     /* TODO activemq service */
     return aug_execl(PLG_NAME, ACTIVEMQ_EXECUTABLE, "restart", NULL);
 }
@@ -67,15 +113,10 @@ aug_actimemq_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id
 #ifdef AVAHI_DAEMON_EXECUTABLE
 
 static int
-aug_avahi_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_avahi_apply(const char *UNUSED(arg))
 {
     int r;
 
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     /* TODO avahi-daemon service */
     if ((r = aug_execl(PLG_NAME, AVAHI_DAEMON_EXECUTABLE, "--kill", NULL))) {
         return r;
@@ -85,45 +126,13 @@ aug_avahi_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id),
 
 #endif
 
-#ifdef CACHEFILESD_EXECUTABLE
-
-static int
-aug_cachefilesd_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
-{
-    int r;
-    pid_t pid;
-
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
-    /* TODO cachefilesd service */
-    if ((r = aug_pidfile(PLG_NAME, "/var/run/cachefilesd.pid", &pid))) {
-        return r;
-    }
-    if (!pid) {
-        /* daemon not running */
-        return SR_ERR_OK;
-    }
-
-    return aug_send_sig(PLG_NAME, pid, SIGHUP);
-}
-
-#endif
-
 #ifdef CARBON_SERVICES
 
 static int
-aug_carbon_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_carbon_apply(const char *UNUSED(arg))
 {
     int r;
 
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     /* service files on github https://github.com/graphite-project/carbon/tree/master/distro/redhat/init.d */
     if ((r = aug_execl(PLG_NAME, SYSTEMCTL_EXECUTABLE, "try-restart", "carbon-cache", NULL))) {
         return r;
@@ -142,15 +151,10 @@ aug_carbon_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id),
 #ifdef CLAMAV_SERVICES
 
 static int
-aug_clamav_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_clamav_apply(const char *UNUSED(arg))
 {
     int r;
 
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     if ((r = aug_execl(PLG_NAME, SYSTEMCTL_EXECUTABLE, "try-restart", "clamav-daemon", NULL))) {
         return r;
     }
@@ -165,16 +169,11 @@ aug_clamav_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id),
 #ifdef DHCPD_EXECUTABLE
 
 static int
-aug_dhcpd_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_dhcpd_apply(const char *UNUSED(arg))
 {
     int r;
     pid_t pid;
 
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     /* TODO on Ubuntu service isc-dhcp-server with PID file /run/dhcp-server/dhcpd.pid */
     if ((r = aug_pidfile(PLG_NAME, "/var/run/dhcpd.pid", &pid))) {
         return r;
@@ -199,39 +198,24 @@ aug_dhcpd_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id),
 #ifdef EXPORTFS_EXECUTABLE
 
 static int
-aug_exports_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_exports_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     return aug_execl(PLG_NAME, EXPORTFS_EXECUTABLE, "-ra", NULL);
 }
 
 #endif
 
 static int
-aug_ldso_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_ldso_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     return aug_execl(PLG_NAME, "/sbin/ldconfig", NULL);
 }
 
 #ifdef NETPLAN_EXECUTABLE
 
 static int
-aug_netplan_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_netplan_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     return aug_execl(PLG_NAME, NETPLAN_EXECUTABLE, "apply", NULL);
 }
 
@@ -240,13 +224,8 @@ aug_netplan_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id)
 #ifdef PG_CTL_EXECUTABLE
 
 static int
-aug_pg_hba_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_pg_hba_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     return aug_execl(PLG_NAME, PG_CTL_EXECUTABLE, "reload", NULL);
 }
 
@@ -255,17 +234,12 @@ aug_pg_hba_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id),
 #ifdef POSTMAP_EXECUTABLE
 
 static int
-aug_postmap_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *private_data)
+aug_postmap_apply(const char *arg)
 {
-    const char *file_name = private_data;
+    const char *file_name = arg;
     char *path;
     int r;
 
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     if (asprintf(&path, "/etc/postfix/%s", file_name) == -1) {
         return SR_ERR_NO_MEMORY;
     }
@@ -292,59 +266,18 @@ aug_postmap_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id)
 #ifdef POSTFIX_EXECUTABLE
 
 static int
-aug_postfix_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_postfix_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     return aug_execl(PLG_NAME, POSTFIX_EXECUTABLE, "reload", NULL);
 }
 
 #endif
 
-#ifdef RTADVD_EXECUTABLE
-
-static int
-aug_rtadvd_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
-{
-    int r;
-    pid_t pid;
-
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
-    if ((r = aug_pidfile(PLG_NAME, "/var/run/rtadvd.pid", &pid))) {
-        return r;
-    }
-    if (!pid) {
-        /* daemon not running */
-        return SR_ERR_OK;
-    }
-
-    /* rtadvd(8) */
-    if ((r = aug_send_sig(PLG_NAME, pid, SIGHUP))) {
-        return r;
-    }
-
-    return SR_ERR_OK;
-}
-
-#endif
-
 #ifdef SMBCONTROL_EXECUTABLE
 
 static int
-aug_samba_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_samba_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     /* ignore return value in case the daemons are not running */
     aug_execl(PLG_NAME, SMBCONTROL_EXECUTABLE, "reload-config", "nmbd", NULL);
     aug_execl(PLG_NAME, SMBCONTROL_EXECUTABLE, "reload-config", "smbd", NULL);
@@ -358,13 +291,8 @@ aug_samba_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id),
 #ifdef SYSCTL_EXECUTABLE
 
 static int
-aug_sysctl_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_sysctl_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     /* load kernel parameters from the config file */
     return aug_execl(PLG_NAME, SYSCTL_EXECUTABLE, "--load", NULL);
 }
@@ -374,470 +302,927 @@ aug_sysctl_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id),
 #ifdef WEBMIN_EXECUTABLE
 
 static int
-aug_webmin_change_cb(sr_session_ctx_t *UNUSED(session), uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
-        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *UNUSED(private_data))
+aug_webmin_apply(const char *UNUSED(arg))
 {
-    if (event != SR_EV_DONE) {
-        return SR_ERR_OK;
-    }
-
     return aug_execl(PLG_NAME, "/etc/webmin/restart", NULL);
 }
 
 #endif
 
-int
-sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
-{
-    sr_subscription_ctx_t *subscr = NULL;
-    const struct ly_ctx *ly_ctx;
-    const struct lys_module *ly_mod;
-    uint32_t i;
-    int rc = SR_ERR_OK;
+/**
+ * @brief Policy of applying the changes of a module.
+ */
+struct aug_policy {
+    const char *module;     /**< module name */
+    aug_apply_cb apply;     /**< action applying the changes */
+    const char *arg;        /**< argument of the action, service name or PID file path */
+    const char *files;      /**< space-separated fnmatch(3) patterns of the config files read by the daemon, patterns
+                                 prefixed by '!' exclude the files, NULL for all the files */
+    const char *ignore;     /**< space-separated names of the nodes whose subtree changes do not affect the daemon */
+};
 
-    sr_session_switch_ds(session, SR_DS_STARTUP);
+/**
+ * @brief Subscribed module.
+ */
+struct aug_module {
+    const struct aug_policy *policy;    /**< policy of the module */
+    struct aug_action *action;          /**< action applying the changes */
+};
 
-    /* subscribe to the found supported modules */
-    ly_ctx = sr_session_acquire_context(session);
-    i = ly_ctx_internal_modules_count(ly_ctx);
-    while ((ly_mod = ly_ctx_get_module_iter(ly_ctx, &i))) {
-        if (!strcmp(ly_mod->name, "activemq-conf") || !strcmp(ly_mod->name, "activemq-xml") ||
-                !strcmp(ly_mod->name, "jmxaccess") || !strcmp(ly_mod->name, "jmxpassword")) {
+/**
+ * @brief Policies of all the supported modules. Services able to apply their configuration without a restart are
+ * reloaded or signalled. The changes of the files or nodes not affecting the daemon are filtered out.
+ */
+static const struct aug_policy aug_policies[] = {
 #ifdef ACTIVEMQ_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_actimemq_change_cb, NULL, 0, 0, &subscr);
+    {"activemq-conf", aug_actimemq_apply, NULL, NULL, NULL},
+    {"activemq-xml", aug_actimemq_apply, NULL, NULL, NULL},
+    {"jmxaccess", aug_actimemq_apply, NULL, NULL, NULL},
+    {"jmxpassword", aug_actimemq_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "avahi")) {
 #ifdef AVAHI_DAEMON_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_avahi_change_cb, NULL, 0, 0, &subscr);
+    {"avahi", aug_avahi_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "cachefilesd")) {
 #ifdef CACHEFILESD_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_cachefilesd_change_cb, NULL, 0, 0, &subscr);
+    {"cachefilesd", aug_sighup_apply, "/var/run/cachefilesd.pid", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "carbon")) {
 #ifdef CARBON_SERVICES
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_carbon_change_cb, NULL, 0, 0, &subscr);
+    {"carbon", aug_carbon_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "cgconfig") || !strcmp(ly_mod->name, "cgrules")) {
 #ifdef CGCONFIG_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "cgconfig", 0, 0, &subscr);
+    {"cgconfig", aug_restart_apply, "cgconfig", NULL, NULL},
+    {"cgrules", aug_restart_apply, "cgconfig", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "chrony")) {
 #ifdef CHRONY_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "chrony", 0, 0, &subscr);
+    {"chrony", aug_restart_apply, "chrony", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "clamav")) {
 #ifdef CLAMAV_SERVICES
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_clamav_change_cb, NULL, 0, 0, &subscr);
+    {"clamav", aug_clamav_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "cockpit")) {
 #ifdef COCKPIT_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "cockpit", 0, 0, &subscr);
+    {"cockpit", aug_restart_apply, "cockpit", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "collectd")) {
 #ifdef COLLECTD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "collectd", 0, 0, &subscr);
+    {"collectd", aug_restart_apply, "collectd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "cron_user") || !strcmp(ly_mod->name, "cron")) {
 #ifdef CRON_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "cron", 0, 0, &subscr);
+    {"cron-user", aug_reload_apply, "cron", NULL, NULL},
+    {"cron", aug_reload_apply, "cron", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "cups")) {
 #ifdef CUPS_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "cups", 0, 0, &subscr);
+    {"cups", aug_reload_apply, "cups", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "cyrus-imapd")) {
 #ifdef CYRUS_IMAPD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "cyrus-imapd", 0, 0, &subscr);
+    {"cyrus-imapd", aug_reload_apply, "cyrus-imapd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "darkice")) {
 #ifdef DARKICE_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "darkice", 0, 0, &subscr);
+    {"darkice", aug_restart_apply, "darkice", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "devfsrules")) {
 #ifdef DEVFS_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "devfs", 0, 0, &subscr);
+    {"devfsrules", aug_restart_apply, "devfs", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "dhcpd")) {
 #ifdef DHCPD_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_dhcpd_change_cb, NULL, 0, 0, &subscr);
+    {"dhcpd", aug_dhcpd_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "dnsmasq")) {
 #ifdef DNSMASQ_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "dnsmasq", 0, 0, &subscr);
+    {"dnsmasq", aug_restart_apply, "dnsmasq", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "dovecot")) {
 #ifdef DOVECOT_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "dovecot", 0, 0, &subscr);
+    {"dovecot", aug_reload_apply, "dovecot", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "exports")) {
 #ifdef EXPORTFS_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_exports_change_cb, NULL, 0, 0, &subscr);
+    {"exports", aug_exports_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "fail2ban")) {
 #ifdef FAIL2BAN_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "fail2ban", 0, 0, &subscr);
+    {"fail2ban", aug_reload_apply, "fail2ban", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "httpd")) {
 #ifdef HTTPD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "httpd", 0, 0, &subscr);
+    {"httpd", aug_reload_apply, "httpd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "iscsid")) {
 #ifdef ISCSID_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "iscsid", 0, 0, &subscr);
+    {"iscsid", aug_restart_apply, "iscsid", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "kdump")) {
 #ifdef KDUMP_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "kdump", 0, 0, &subscr);
+    {"kdump", aug_restart_apply, "kdump", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "keepalived")) {
 #ifdef KEEPALIVED_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "keepalived", 0, 0, &subscr);
+    {"keepalived", aug_reload_apply, "keepalived", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "ldif") || !strcmp(ly_mod->name, "slapd")) {
 #ifdef SLAPD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "slapd", 0, 0, &subscr);
+    {"ldif", aug_restart_apply, "slapd", NULL, NULL},
+    {"slapd", aug_restart_apply, "slapd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "ldso")) {
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_ldso_change_cb, NULL, 0, 0, &subscr);
-        } else if (!strcmp(ly_mod->name, "lightdm")) {
+    {"ldso", aug_ldso_apply, NULL, NULL, NULL},
 #ifdef LIGHTDM_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "lightdm", 0, 0, &subscr);
+    {"lightdm", aug_restart_apply, "lightdm", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "logrotate")) {
 #ifdef LOGROTATE_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "logrotate", 0, 0, &subscr);
+    {"logrotate", aug_restart_apply, "logrotate", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "mailscanner_rules") || !strcmp(ly_mod->name, "mailscanner")) {
 #ifdef MAILSCANNER_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "MailScanner", 0, 0, &subscr);
+    {"mailscanner-rules", aug_reload_apply, "MailScanner", NULL, NULL},
+    {"mailscanner", aug_reload_apply, "MailScanner", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "mcollective")) {
 #ifdef MCOLLECTIVE_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "mcollective", 0, 0, &subscr);
+    {"mcollective", aug_reload_apply, "mcollective", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "memcached")) {
 #ifdef MEMCACHED_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "memcached", 0, 0, &subscr);
+    {"memcached", aug_restart_apply, "memcached", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "mongodbserver")) {
 #ifdef MONGOD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "mongod", 0, 0, &subscr);
+    {"mongodbserver", aug_restart_apply, "mongod", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "monit")) {
 #ifdef MONIT_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "monit", 0, 0, &subscr);
+    {"monit", aug_reload_apply, "monit", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "multipath")) {
 #ifdef MULTIPATHD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "multipathd", 0, 0, &subscr);
+    {"multipath", aug_reload_apply, "multipathd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "mysql")) {
 #ifdef MYSQL_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "mysql", 0, 0, &subscr);
+    {"mysql", aug_restart_apply, "mysql", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "nagioscfg") || !strcmp(ly_mod->name, "nagiosobjects") ||
-                !strcmp(ly_mod->name, "nrpe")) {
 #ifdef NAGIOS_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "nagios", 0, 0, &subscr);
+    {"nagioscfg", aug_reload_apply, "nagios", "!*/cgi.cfg", NULL},
+    {"nagiosobjects", aug_reload_apply, "nagios", NULL, NULL},
+    {"nrpe", aug_reload_apply, "nagios", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "netplan")) {
 #ifdef NETPLAN_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_netplan_change_cb, NULL, 0, 0, &subscr);
+    {"netplan", aug_netplan_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "nginx")) {
 #ifdef NGINX_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "nginx", 0, 0, &subscr);
+    {"nginx", aug_reload_apply, "nginx", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "nslcd")) {
 #ifdef NSLCD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "nslcd", 0, 0, &subscr);
+    {"nslcd", aug_restart_apply, "nslcd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "ntp") || !strcmp(ly_mod->name, "ntpd")) {
 #ifdef NTPD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "ntpd", 0, 0, &subscr);
+    {"ntp", aug_restart_apply, "ntpd", NULL, NULL},
+    {"ntpd", aug_restart_apply, "ntpd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "opendkim")) {
 #ifdef OPENDKIM_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "opendkim", 0, 0, &subscr);
+    {"opendkim", aug_reload_apply, "opendkim", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "openvpn")) {
 #ifdef OPENVPN_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "openvpn.target", 0, 0, &subscr);
+    {"openvpn", aug_restart_apply, "openvpn.target", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "pagekite")) {
 #ifdef PAGEKITE_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "pagekite", 0, 0, &subscr);
+    {"pagekite", aug_restart_apply, "pagekite", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "pg_hba") || !strcmp(ly_mod->name, "postgresql")) {
 #ifdef PG_CTL_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_pg_hba_change_cb, NULL, 0, 0, &subscr);
+    {"pg-hba", aug_pg_hba_apply, NULL, NULL, NULL},
+    {"postgresql", aug_pg_hba_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "pgbouncer")) {
 #ifdef PGBOUNCER_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "pgbouncer", 0, 0, &subscr);
+    {"pgbouncer", aug_reload_apply, "pgbouncer", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "postfix_access") || !strcmp(ly_mod->name, "postfix_passwordmap")) {
 #ifdef POSTMAP_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_postmap_change_cb, "access", 0, 0, &subscr);
+    {"postfix-access", aug_postmap_apply, "access", NULL, NULL},
+    {"postfix-passwordmap", aug_postmap_apply, "access", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "postfix_main") || !strcmp(ly_mod->name, "postfix_master")) {
 #ifdef POSTFIX_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_postfix_change_cb, NULL, 0, 0, &subscr);
+    {"postfix-main", aug_postfix_apply, NULL, NULL, NULL},
+    {"postfix-master", aug_postfix_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "postfix_sasl_smtpd")) {
 #ifdef SASLAUTHD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "postfix_sasl_smtpd", 0, 0, &subscr);
+    {"postfix-sasl-smtpd", aug_restart_apply, "saslauthd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "postfix_transport")) {
 #ifdef POSTMAP_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_postmap_change_cb, "transport", 0, 0, &subscr);
+    {"postfix-transport", aug_postmap_apply, "transport", NULL, NULL},
+    {"postfix-virtual", aug_postmap_apply, "virtual", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "postfix_virtual")) {
-#ifdef POSTMAP_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_postmap_change_cb, "virtual", 0, 0, &subscr);
-#endif
-        } else if (!strcmp(ly_mod->name, "puppet_auth") || !strcmp(ly_mod->name, "puppet") ||
-                !strcmp(ly_mod->name, "puppetfileserver") || !strcmp(ly_mod->name, "trapperkeeper")) {
 #ifdef PUPPET_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "puppet", 0, 0, &subscr);
+    {"puppet-auth", aug_reload_apply, "puppet", NULL, NULL},
+    {"puppet", aug_reload_apply, "puppet", NULL, NULL},
+    {"puppetfileserver", aug_reload_apply, "puppet", NULL, NULL},
+    {"trapperkeeper", aug_reload_apply, "puppet", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "qpid")) {
 #ifdef QPIDD_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "qpidd", 0, 0, &subscr);
+    {"qpid", aug_restart_apply, "qpidd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "rabbitmq")) {
 #ifdef RABBITMQ_SERVER_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "rabbitmq-server", 0, 0, &subscr);
+    {"rabbitmq", aug_restart_apply, "rabbitmq-server", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "radicale")) {
 #ifdef RADICALE_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "radicale", 0, 0, &subscr);
+    {"radicale", aug_restart_apply, "radicale", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "redis")) {
 #ifdef REDIS_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "redis.target", 0, 0, &subscr);
+    {"redis", aug_restart_apply, "redis.target", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "rsyncd")) {
 #ifdef RSYNCD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "rsyncd", 0, 0, &subscr);
+    {"rsyncd", aug_restart_apply, "rsyncd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "rsyslog")) {
 #ifdef RSYSLOG_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "rsyslog", 0, 0, &subscr);
+    {"rsyslog", aug_restart_apply, "rsyslog", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "rtadvd")) {
 #ifdef RTADVD_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_rtadvd_change_cb, NULL, 0, 0, &subscr);
+    {"rtadvd", aug_sighup_apply, "/var/run/rtadvd.pid", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "samba") || !strcmp(ly_mod->name, "smbusers")) {
 #ifdef SMBCONTROL_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_samba_change_cb, NULL, 0, 0, &subscr);
+    {"samba", aug_samba_apply, NULL, NULL, NULL},
+    {"smbusers", aug_samba_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "sip_conf")) {
 #ifdef ASTERISK_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "asterisk", 0, 0, &subscr);
+    {"sip-conf", aug_reload_apply, "asterisk", NULL, "title-comment"},
 #endif
-        } else if (!strcmp(ly_mod->name, "splunk")) {
 #ifdef SPLUNK_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "splunk", 0, 0, &subscr);
+    {"splunk", aug_restart_apply, "splunk", "/opt/splunk/*", NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "squid")) {
 #ifdef SQUID_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "squid", 0, 0, &subscr);
+    {"squid", aug_reload_apply, "squid", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "sshd")) {
 #ifdef SSHD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "sshd", 0, 0, &subscr);
+    {"sshd", aug_reload_apply, "sshd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "sssd")) {
 #ifdef SSSD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "sssd", 0, 0, &subscr);
+    {"sssd", aug_restart_apply, "sssd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "strongswan")) {
 #ifdef STRONGSWAN_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "strongswan", 0, 0, &subscr);
+    {"strongswan", aug_reload_apply, "strongswan", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "stunnel")) {
 #ifdef STUNNEL_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "stunnel", 0, 0, &subscr);
+    {"stunnel", aug_reload_apply, "stunnel", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "sysctl")) {
 #ifdef SYSCTL_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_sysctl_change_cb, NULL, 0, 0, &subscr);
+    {"sysctl", aug_sysctl_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "syslog")) {
 #ifdef SYSLOG_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "syslog", 0, 0, &subscr);
+    {"syslog", aug_restart_apply, "syslog", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "thttpd")) {
 #ifdef THTTPD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "thttpd", 0, 0, &subscr);
+    {"thttpd", aug_restart_apply, "thttpd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "tinc")) {
 #ifdef TINC_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "tinc", 0, 0, &subscr);
+    {"tinc", aug_reload_apply, "tinc", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "tmpfiles")) {
 #ifdef SYSTEMD_TMPFILES_CLEAN_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "systemd-tmpfiles-clean",
-                    0, 0, &subscr);
+    {"tmpfiles", aug_restart_apply, "systemd-tmpfiles-clean", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "tuned")) {
 #ifdef TUNED_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "tuned", 0, 0, &subscr);
+    {"tuned", aug_reload_apply, "tuned", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "vsftpd")) {
 #ifdef VSFTPD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "vsftpd", 0, 0, &subscr);
+    {"vsftpd", aug_restart_apply, "vsftpd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "webmin")) {
 #ifdef WEBMIN_EXECUTABLE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_webmin_change_cb, NULL, 0, 0, &subscr);
+    {"webmin", aug_webmin_apply, NULL, NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "xinetd")) {
 #ifdef XINETD_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "xinetd", 0, 0, &subscr);
+    {"xinetd", aug_reload_apply, "xinetd", NULL, NULL},
 #endif
-        } else if (!strcmp(ly_mod->name, "xymon")) {
 #ifdef XYMONLAUNCH_SERVICE
-            rc = sr_module_change_subscribe(session, ly_mod->name, NULL, aug_service_change_cb, "xymonlaunch", 0, 0, &subscr);
-#endif
+    {"xymon", aug_restart_apply, "xymonlaunch", NULL, NULL},
+#endif
+
+    /* access - config for pam_access.so, is reread on every login */
+    /* afs-cellalias - cellalias(5), no process to use the config file? */
+    /* aliases - local(8), should reread the aliases on each mail delivery */
+    /* anaconda - https://anaconda-installer.readthedocs.io/en/latest/configuration-files.html, install config file */
+    /* anacron - anacron(8), should reread jobs desription on each execution */
+    /* approx - approx(8), no daemon, config file read on every exec by inetd */
+    /* apt-update-manager - no deamon, config file read on every exec? */
+    /* aptcacherngsecurity - no dameon, config file read on every exec? */
+    /* aptconf - no dameon, config file read on every exec? */
+    /* aptpreferences - no dameon, config file read on every exec? */
+    /* aptsources - no dameon, config file read on every exec? */
+    /* authinfo2 - https://github.com/s3ql/s3ql, no deamon */
+    /* authorized-keys - reread on every use */
+    /* authselectpam - pam config, reread on every use */
+    /* automaster - autofs(8), no daemon, script config file */
+    /* automounter - autofs(5), no daemon */
+    /* backuppchosts - https://backuppc.github.io/backuppc/BackupPC.html, config file is reread automatically */
+    /* bbhosts - hobbitlaunch(8), a config file is being monitored for changes but not sure if it is this one? */
+    /* bootconf - no daemon */
+    /* ceph - https://ubuntu.com/ceph/docs/client-setup, only client, no daemon? */
+    /* channels - no daemon? */
+    /* cmdline - kernel command-line parameters */
+    /* cobblermodules, cobblersettings - package manager, no daemon */
+    /* cpanel - not able to find any relevant info? */
+    /* crypttab - systemd-cryptsetup@.service(8) service needs generated service files on boot */
+    /* desktop - lots of affected applications */
+    /* device_map - grub configuration */
+    /* dhclient - should work as a service but not sure what service to restart? */
+    /* dns_zone - no specific process to use the files */
+    /* dpkg - no daemon */
+    /* dput - no daemon */
+    /* ethers - ethers(5), no (specific) daemon */
+    /* fai_diskconfig - installation configuration */
+    /* fonts - no daemon */
+    /* fstab - no daemon */
+    /* fuse - no daemon */
+    /* gdm - has daemon but restarting it causes all users to log out */
+    /* getcap - no daemon */
+    /* group - would cause log out */
+    /* grub - no daemon */
+    /* grubenv - no daemon */
+    /* gshadow - would cause log out */
+    /* gtkbookmarks - applied as needed? */
+    /* host_conf - no daemon */
+    /* hostname - no daemon */
+    /* hosts_access - tcpd(8), used only by other daemons? */
+    /* hosts - hosts(5), no daemon */
+    /* htpasswd - restart httpd, rsyncd? */
+    /* inetd - inetd(8), should restart it? */
+    /* inittab - applied on next boot */
+    /* inputrc - readline(3), no daemon */
+    /* interaces - interfaces(5), specific inetrfaces would need to be disabled and enabled */
+    /* iproute2 - ip-route(8), no simple way of applying changes */
+    /* iptables - iptables(8), some changes should be possible to apply with iptables-restore */
+    /* jaas - not sure if has any daemon */
+    /* jettyrealm - Java app */
+    /* known_hosts - no daemon */
+    /* koji - several daemons, need restart? */
+    /* krb5 - service name(s) differs across distributions? */
+    /* limits - limits.conf(5), no daemon */
+    /* login_defs - applied when creating new users */
+    /* logwatch - executed by cron */
+    /* lokkit - interactive configuration */
+    /* lvm - not a good idea to restart the manager */
+    /* masterpasswd - no deamon */
+    /* mdadm_conf - requires a restart */
+    /* mke2fs - no daemon */
+    /* modprobe - default options for modprobe exec, rather leave it to the user */
+    /* modules_conf - default options for modprobe exec */
+    /* modules - read on boot */
+    /* netmasks - specific interface restart required */
+    /* networkmanager - better not restart it */
+    /* networks - no daemon */
+    /* nsswitch - no single daemon */
+    /* odbc - no daemon */
+    /* openshift_config - many managed projects */
+    /* openshift_http - managed by openshift? */
+    /* openshift_quickstarts - applied on start */
+    /* oz - no daemon */
+    /* pam - no daemon */
+    /* pamconf - no daemon */
+    /* passwd - no daemon */
+    /* pbuilder - no daemon */
+    /* php - no daemon */
+    /* phpvars - squirrelmail, a web service */
+    /* protocols - no daemon */
+    /* pylonspaste - no single daemon? */
+    /* pythonpaste - no single daemon? */
+    /* rancid - no daemon */
+    /* resolv - no daemon */
+    /* rhsm - Java apps? */
+    /* rmt - no daemon */
+    /* schroot - applied on next schroot access */
+    /* securetty - applied on next login */
+    /* semanage - library configuration */
+    /* services - library configuration */
+    /* shadow - no daemon */
+    /* shells - no daemon */
+    /* shellvars_list - no daemon */
+    /* shellvars - many config files */
+    /* simplelines - files reread on use */
+    /* simplevars - many config files */
+    /* solaris_system - no daemon */
+    /* soma - could not find info? */
+    /* sos - no daemon */
+    /* spacevars - many config files */
+    /* ssh - no daemon */
+    /* star - no daemon */
+    /* subversion - no daemon */
+    /* sudoers - no daemon */
+    /* sysconfig_route - restart NetworkManager service? */
+    /* systemd - restart the changed services? */
+    /* termcap - no daemon */
+    /* up2date - no daemons? */
+    /* updatedb - updatedb(8) run preiodically */
+    /* vfstab - no daemon */
+    /* vmware_config - applied automatically? */
+    /* xml - too generic */
+    /* xorg - Xorg(1), system needs restart */
+    /* xymon_alerting - no daemon? */
+    /* yum - no daemon? */
+};
+
+/**
+ * @brief Hash table of the policies indexed by module name.
+ */
+struct aug_policy_ht {
+    const struct aug_policy **slots;    /**< open addressing slots, NULL if empty */
+    uint32_t size;                      /**< number of slots, power of 2 */
+};
+
+/**
+ * @brief Compute hash of a module name.
+ *
+ * @param[in] name Module name.
+ * @return Jenkins one-at-a-time hash.
+ */
+static uint32_t
+aug_policy_hash(const char *name)
+{
+    uint32_t hash = 0;
+
+    for ( ; *name; ++name) {
+        hash += (unsigned char)*name;
+        hash += hash << 10;
+        hash ^= hash >> 6;
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+
+    return hash;
+}
+
+/**
+ * @brief Build the hash table of all the policies.
+ *
+ * @param[out] ht Hash table to fill.
+ * @return SR_ERR value.
+ */
+static int
+aug_policy_ht_new(struct aug_policy_ht *ht)
+{
+    uint32_t i, j, count;
+
+    count = sizeof aug_policies / sizeof *aug_policies;
+
+    /* keep the load factor at most 1/2 */
+    for (ht->size = 1; ht->size < count * 2; ht->size <<= 1) {}
+    ht->slots = calloc(ht->size, sizeof *ht->slots);
+    if (!ht->slots) {
+        SRPLG_LOG_ERR(PLG_NAME, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        return SR_ERR_NO_MEMORY;
+    }
+
+    for (i = 0; i < count; ++i) {
+        for (j = aug_policy_hash(aug_policies[i].module) & (ht->size - 1); ht->slots[j]; j = (j + 1) & (ht->size - 1)) {}
+        ht->slots[j] = &aug_policies[i];
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Find the policy of a module.
+ *
+ * @param[in] ht Hash table of the policies.
+ * @param[in] module Module name.
+ * @return Found policy, NULL if the module is not supported.
+ */
+static const struct aug_policy *
+aug_policy_ht_find(const struct aug_policy_ht *ht, const char *module)
+{
+    uint32_t i;
+
+    for (i = aug_policy_hash(module) & (ht->size - 1); ht->slots[i]; i = (i + 1) & (ht->size - 1)) {
+        if (!strcmp(ht->slots[i]->module, module)) {
+            return ht->slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check whether a word is in a space-separated list.
+ *
+ * @param[in] list Space-separated list.
+ * @param[in] word Word to find.
+ * @return Whether the word was found.
+ */
+static int
+aug_list_has(const char *list, const char *word)
+{
+    const char *ptr;
+    size_t len = strlen(word);
+
+    for (ptr = list; (ptr = strstr(ptr, word)); ptr += len) {
+        if (((ptr == list) || (ptr[-1] == ' ')) && ((ptr[len] == ' ') || !ptr[len])) {
+            return 1;
         }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check whether a config file is read by the daemon.
+ *
+ * @param[in] files Space-separated patterns, see ::aug_policy.files.
+ * @param[in] path Config file path.
+ * @return Whether the file is read by the daemon.
+ */
+static int
+aug_file_match(const char *files, const char *path)
+{
+    char pattern[PATH_MAX];
+    const char *ptr;
+    size_t len;
+    int include = 0, has_include = 0;
+
+    for (ptr = files; *ptr; ptr += len) {
+        while (*ptr == ' ') {
+            ++ptr;
+        }
+        len = strcspn(ptr, " ");
+        if (!len || (len >= sizeof pattern)) {
+            continue;
+        }
+        memcpy(pattern, ptr, len);
+        pattern[len] = '\0';
+
+        if (pattern[0] == '!') {
+            if (!fnmatch(pattern + 1, path, 0)) {
+                /* excluded */
+                return 0;
+            }
+        } else {
+            has_include = 1;
+            if (!fnmatch(pattern, path, 0)) {
+                include = 1;
+            }
+        }
+    }
+
+    /* with only excluding patterns, all the other files are read */
+    return include || !has_include;
+}
+
+/**
+ * @brief Check whether a change affects the daemon.
+ *
+ * @param[in] policy Policy of the module.
+ * @param[in] node Changed node from the diff.
+ * @return Whether the change is relevant.
+ */
+static int
+aug_change_relevant(const struct aug_policy *policy, const struct lyd_node *node)
+{
+    const struct lyd_node *top = NULL;
+
+    for ( ; node; node = lyd_parent(node)) {
+        if (policy->ignore && aug_list_has(policy->ignore, LYD_NAME(node))) {
+            return 0;
+        }
+        top = node;
+    }
+
+    /* the top-level list instance is keyed by the config file path */
+    if (policy->files && top && lyd_child(top) && !aug_file_match(policy->files, lyd_get_value(lyd_child(top)))) {
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Module change callback scheduling the action that applies the changes.
+ *
+ * The action is executed asynchronously by the queue so that a slow service restart does not block the events
+ * of the other modules. It is not scheduled at all if none of the changes affect the daemon.
+ */
+static int
+aug_change_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char *module_name,
+        const char *UNUSED(xpath), sr_event_t event, uint32_t UNUSED(request_id), void *private_data)
+{
+    struct aug_module *mod = private_data;
+    sr_change_iter_t *iter = NULL;
+    sr_change_oper_t op;
+    const struct lyd_node *node;
+    const char *prev_val, *prev_list;
+    char *path = NULL;
+    int prev_dflt, r, relevant = 0;
+
+    if (event != SR_EV_DONE) {
+        return SR_ERR_OK;
+    }
+
+    if (!mod->policy->files && !mod->policy->ignore) {
+        /* every change is relevant */
+        aug_queue_schedule(mod->action);
+        return SR_ERR_OK;
+    }
+
+    /* evaluate the filters on the changes */
+    if (asprintf(&path, "/%s:*//.", module_name) == -1) {
+        path = NULL;
+        r = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    if ((r = sr_get_changes_iter(session, path, &iter))) {
+        goto cleanup;
+    }
+    while (!relevant && !(r = sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt))) {
+        relevant = aug_change_relevant(mod->policy, node);
+    }
+    if (r == SR_ERR_NOT_FOUND) {
+        r = SR_ERR_OK;
+    }
+
+cleanup:
+    free(path);
+    sr_free_change_iter(iter);
+    if (r) {
+        /* apply the changes rather than ignore them */
+        SRPLG_LOG_WRN(PLG_NAME, "Failed to filter changes of module \"%s\" (%s).", module_name, sr_strerror(r));
+        relevant = 1;
+    }
+    if (relevant) {
+        aug_queue_schedule(mod->action);
+    } else {
+        SRPLG_LOG_INF(PLG_NAME, "Changes of module \"%s\" do not affect the daemon.", module_name);
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Subscribe to the changes of a module.
+ *
+ * @param[in] session Sysrepo session.
+ * @param[in] queue Queue of the actions.
+ * @param[in] module_name Name of the module to subscribe to.
+ * @param[in] policy Policy of the module.
+ * @param[out] mod Subscribed module to fill, passed to the callback.
+ * @param[in,out] subscr Subscription context.
+ * @return SR_ERR value.
+ */
+static int
+aug_subscribe(sr_session_ctx_t *session, struct aug_queue *queue, const char *module_name,
+        const struct aug_policy *policy, struct aug_module *mod, sr_subscription_ctx_t **subscr)
+{
+    int rc;
+
+    /* modules applied by the same action share it so their changes are coalesced */
+    if ((rc = aug_queue_action(queue, policy->apply, policy->arg, module_name, &mod->action))) {
+        return rc;
+    }
+    mod->policy = policy;
+
+    return sr_module_change_subscribe(session, module_name, NULL, aug_change_cb, mod, 0, 0, subscr);
+}
+
+/**
+ * @brief Map the statistics of the augeas DS plugin.
+ *
+ * @return Mapped statistics, NULL if they are disabled or do not exist (yet).
+ */
+static const struct augstats *
+aug_stats_map(void)
+{
+    const char *path;
+    const struct augstats *stats;
+    struct stat st;
+    int fd;
+
+    path = getenv(AUG_STATS_ENV);
+    if (!path || !path[0]) {
+        return NULL;
+    }
+
+    /* the file is created by the DS plugin */
+    fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd == -1) {
+        return NULL;
+    }
+    if ((fstat(fd, &st) == -1) || ((size_t)st.st_size < sizeof *stats)) {
+        close(fd);
+        return NULL;
+    }
+    if (!S_ISREG(st.st_mode) || (st.st_uid != geteuid())) {
+        SRPLG_LOG_ERR(PLG_NAME, "Statistics \"%s\" are not a regular file owned by the user.", path);
+        close(fd);
+        return NULL;
+    }
+    stats = mmap(NULL, sizeof *stats, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stats == MAP_FAILED) {
+        SRPLG_LOG_ERR(PLG_NAME, "Mapping statistics \"%s\" failed (%s).", path, strerror(errno));
+        return NULL;
+    }
+    if (__atomic_load_n(&stats->version, __ATOMIC_ACQUIRE) != AUG_STATS_VERSION) {
+        SRPLG_LOG_ERR(PLG_NAME, "Statistics \"%s\" of version %" PRIu32 " not supported.", path, stats->version);
+        munmap((void *)stats, sizeof *stats);
+        return NULL;
+    }
+
+    return stats;
+}
+
+/**
+ * @brief Create a uint64 leaf.
+ *
+ * @param[in] parent Parent of the leaf.
+ * @param[in] name Leaf name.
+ * @param[in] value Leaf value.
+ * @return libyang error.
+ */
+static LY_ERR
+aug_stats_new_u64(struct lyd_node *parent, const char *name, uint64_t value)
+{
+    char buf[24];
+
+    sprintf(buf, "%" PRIu64, value);
+    return lyd_new_term(parent, NULL, name, buf, 0, NULL);
+}
+
+/**
+ * @brief Create the latency statistics nodes.
+ *
+ * @param[in] parent Parent list instance.
+ * @param[in] lat Latency statistics to read.
+ * @return libyang error.
+ */
+static LY_ERR
+aug_stats_oper_lat(struct lyd_node *parent, const struct augstats_lat *lat)
+{
+    struct lyd_node *bucket;
+    uint64_t count;
+    uint32_t i;
+    char buf[24];
+    LY_ERR r;
+
+    if ((r = aug_stats_new_u64(parent, "count", __atomic_load_n(&lat->count, __ATOMIC_RELAXED)))) {
+        return r;
+    }
+    if ((r = aug_stats_new_u64(parent, "total", __atomic_load_n(&lat->total_usec, __ATOMIC_RELAXED)))) {
+        return r;
+    }
+    if ((r = aug_stats_new_u64(parent, "max", __atomic_load_n(&lat->max_usec, __ATOMIC_RELAXED)))) {
+        return r;
+    }
+
+    for (i = 0; i < AUG_STATS_BUCKETS; ++i) {
+        if (!(count = __atomic_load_n(&lat->buckets[i], __ATOMIC_RELAXED))) {
+            continue;
+        }
+
+        if (i == AUG_STATS_BUCKETS - 1) {
+            strcpy(buf, "infinity");
+        } else {
+            sprintf(buf, "%" PRIu64, (uint64_t)1 << i);
+        }
+        if ((r = lyd_new_list(parent, NULL, "bucket", 0, &bucket, buf))) {
+            return r;
+        }
+        if ((r = aug_stats_new_u64(bucket, "count", count))) {
+            return r;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Operational data callback providing the statistics of the augeas DS plugin.
+ */
+static int
+aug_stats_oper_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char *UNUSED(module_name),
+        const char *UNUSED(path), const char *UNUSED(request_xpath), uint32_t UNUSED(request_id),
+        struct lyd_node **parent, void *private_data)
+{
+    static const char *cb_names[AUGSTATS_CB_COUNT] = {"load", "store", "last-modif", "access-check"};
+    static const char *phase_names[AUGSTATS_PH_COUNT] = {"parse", "aug2yang", "diff", "store-diff", "save"};
+    struct aug_plugin *plg = private_data;
+    const struct augstats_mod *smod;
+    const struct ly_ctx *ly_ctx;
+    struct lyd_node *list, *node;
+    uint32_t i, j;
+    LY_ERR r = LY_SUCCESS;
+
+    if (!plg->stats && !(plg->stats = aug_stats_map())) {
+        /* no statistics yet */
+        return SR_ERR_OK;
+    }
+
+    ly_ctx = sr_session_acquire_context(session);
+    if ((r = lyd_new_path(NULL, ly_ctx, "/augeas-ds-stats:ds-stats", NULL, 0, parent))) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < AUG_STATS_MODULES; ++i) {
+        smod = &plg->stats->mods[i];
+        if (__atomic_load_n(&smod->state, __ATOMIC_ACQUIRE) != 2) {
+            continue;
+        }
+
+        if ((r = lyd_new_list(*parent, NULL, "module", 0, &list, smod->name))) {
+            goto cleanup;
+        }
+        if ((r = aug_stats_new_u64(list, "init-hits", __atomic_load_n(&smod->init_hits, __ATOMIC_RELAXED))) ||
+                (r = aug_stats_new_u64(list, "init-misses", __atomic_load_n(&smod->init_misses, __ATOMIC_RELAXED))) ||
+                (r = aug_stats_new_u64(list, "loaded-nodes", __atomic_load_n(&smod->loaded_nodes, __ATOMIC_RELAXED))) ||
+                (r = aug_stats_new_u64(list, "diff-nodes", __atomic_load_n(&smod->diff_nodes, __ATOMIC_RELAXED))) ||
+                (r = aug_stats_new_u64(list, "evictions", __atomic_load_n(&smod->evictions, __ATOMIC_RELAXED))) ||
+                (r = aug_stats_new_u64(list, "data-memory", __atomic_load_n(&smod->data_bytes, __ATOMIC_RELAXED))) ||
+                (r = aug_stats_new_u64(list, "info-memory", __atomic_load_n(&smod->info_bytes, __ATOMIC_RELAXED)))) {
+            goto cleanup;
+        }
+
+        for (j = 0; j < AUGSTATS_CB_COUNT; ++j) {
+            if (!__atomic_load_n(&smod->cbs[j].count, __ATOMIC_RELAXED)) {
+                continue;
+            }
+            if ((r = lyd_new_list(list, NULL, "callback", 0, &node, cb_names[j])) ||
+                    (r = aug_stats_oper_lat(node, &smod->cbs[j]))) {
+                goto cleanup;
+            }
+        }
+        for (j = 0; j < AUGSTATS_PH_COUNT; ++j) {
+            if (!__atomic_load_n(&smod->phases[j].count, __ATOMIC_RELAXED)) {
+                continue;
+            }
+            if ((r = lyd_new_list(list, NULL, "phase", 0, &node, phase_names[j])) ||
+                    (r = aug_stats_oper_lat(node, &smod->phases[j]))) {
+                goto cleanup;
+            }
+        }
+    }
+
+cleanup:
+    if (r) {
+        SRPLG_LOG_ERR(PLG_NAME, "Creating the statistics data failed (%s).", ly_last_errmsg());
+    }
+    sr_session_release_context(session);
+    return r ? SR_ERR_LY : SR_ERR_OK;
+}
+
+int
+sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
+{
+    sr_subscription_ctx_t *subscr = NULL;
+    struct aug_queue *queue = NULL;
+    struct aug_plugin *plg = NULL;
+    struct aug_policy_ht ht = {0};
+    const struct aug_policy *policy;
+    struct aug_module *modules = NULL;
+    const struct ly_ctx *ly_ctx;
+    const struct lys_module *ly_mod;
+    uint32_t i, mod_count = 0;
+    int rc = SR_ERR_OK;
+
+    plg = calloc(1, sizeof *plg);
+    if (!plg) {
+        SRPLG_LOG_ERR(PLG_NAME, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        return SR_ERR_NO_MEMORY;
+    }
+
+    /* start the workers applying the changes */
+    if ((rc = aug_queue_new(PLG_NAME, AUG_QUEUE_WORKERS, AUG_QUEUE_WINDOW, &queue))) {
+        free(plg);
+        return rc;
+    }
+
+    /* index the policies, every policy is used by one module at most */
+    modules = calloc(sizeof aug_policies / sizeof *aug_policies, sizeof *modules);
+    if (!modules) {
+        SRPLG_LOG_ERR(PLG_NAME, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        aug_queue_free(queue);
+        free(plg);
+        return SR_ERR_NO_MEMORY;
+    }
+    if ((rc = aug_policy_ht_new(&ht))) {
+        aug_queue_free(queue);
+        free(modules);
+        free(plg);
+        return rc;
+    }
+
+    sr_session_switch_ds(session, SR_DS_STARTUP);
+
+    /* subscribe to the found supported modules */
+    ly_ctx = sr_session_acquire_context(session);
+    i = ly_ctx_internal_modules_count(ly_ctx);
+    while ((ly_mod = ly_ctx_get_module_iter(ly_ctx, &i))) {
+        policy = aug_policy_ht_find(&ht, ly_mod->name);
+        if (!policy) {
+            continue;
+        }
+
+        rc = aug_subscribe(session, queue, ly_mod->name, policy, &modules[mod_count++], &subscr);
         if (rc) {
             SRPLG_LOG_ERR(PLG_NAME, "Failed to subscribe to module \"%s\" (%s).", ly_mod->name, sr_strerror(rc));
             goto cleanup;
         }
+    }
 
-        /* access - config for pam_access.so, is reread on every login */
-        /* afs-cellalias - cellalias(5), no process to use the config file? */
-        /* aliases - local(8), should reread the aliases on each mail delivery */
-        /* anaconda - https://anaconda-installer.readthedocs.io/en/latest/configuration-files.html, install config file */
-        /* anacron - anacron(8), should reread jobs desription on each execution */
-        /* approx - approx(8), no daemon, config file read on every exec by inetd */
-        /* apt-update-manager - no deamon, config file read on every exec? */
-        /* aptcacherngsecurity - no dameon, config file read on every exec? */
-        /* aptconf - no dameon, config file read on every exec? */
-        /* aptpreferences - no dameon, config file read on every exec? */
-        /* aptsources - no dameon, config file read on every exec? */
-        /* authinfo2 - https://github.com/s3ql/s3ql, no deamon */
-        /* authorized-keys - reread on every use */
-        /* authselectpam - pam config, reread on every use */
-        /* automaster - autofs(8), no daemon, script config file */
-        /* automounter - autofs(5), no daemon */
-        /* backuppchosts - https://backuppc.github.io/backuppc/BackupPC.html, config file is reread automatically */
-        /* bbhosts - hobbitlaunch(8), a config file is being monitored for changes but not sure if it is this one? */
-        /* bootconf - no daemon */
-        /* ceph - https://ubuntu.com/ceph/docs/client-setup, only client, no daemon? */
-        /* channels - no daemon? */
-        /* cmdline - kernel command-line parameters */
-        /* cobblermodules, cobblersettings - package manager, no daemon */
-        /* cpanel - not able to find any relevant info? */
-        /* crypttab - systemd-cryptsetup@.service(8) service needs generated service files on boot */
-        /* desktop - lots of affected applications */
-        /* device_map - grub configuration */
-        /* dhclient - should work as a service but not sure what service to restart? */
-        /* dns_zone - no specific process to use the files */
-        /* dpkg - no daemon */
-        /* dput - no daemon */
-        /* ethers - ethers(5), no (specific) daemon */
-        /* fai_diskconfig - installation configuration */
-        /* fonts - no daemon */
-        /* fstab - no daemon */
-        /* fuse - no daemon */
-        /* gdm - has daemon but restarting it causes all users to log out */
-        /* getcap - no daemon */
-        /* group - would cause log out */
-        /* grub - no daemon */
-        /* grubenv - no daemon */
-        /* gshadow - would cause log out */
-        /* gtkbookmarks - applied as needed? */
-        /* host_conf - no daemon */
-        /* hostname - no daemon */
-        /* hosts_access - tcpd(8), used only by other daemons? */
-        /* hosts - hosts(5), no daemon */
-        /* htpasswd - restart httpd, rsyncd? */
-        /* inetd - inetd(8), should restart it? */
-        /* inittab - applied on next boot */
-        /* inputrc - readline(3), no daemon */
-        /* interaces - interfaces(5), specific inetrfaces would need to be disabled and enabled */
-        /* iproute2 - ip-route(8), no simple way of applying changes */
-        /* iptables - iptables(8), some changes should be possible to apply with iptables-restore */
-        /* jaas - not sure if has any daemon */
-        /* jettyrealm - Java app */
-        /* known_hosts - no daemon */
-        /* koji - several daemons, need restart? */
-        /* krb5 - service name(s) differs across distributions? */
-        /* limits - limits.conf(5), no daemon */
-        /* login_defs - applied when creating new users */
-        /* logwatch - executed by cron */
-        /* lokkit - interactive configuration */
-        /* lvm - not a good idea to restart the manager */
-        /* masterpasswd - no deamon */
-        /* mdadm_conf - requires a restart */
-        /* mke2fs - no daemon */
-        /* modprobe - default options for modprobe exec, rather leave it to the user */
-        /* modules_conf - default options for modprobe exec */
-        /* modules - read on boot */
-        /* netmasks - specific interface restart required */
-        /* networkmanager - better not restart it */
-        /* networks - no daemon */
-        /* nsswitch - no single daemon */
-        /* odbc - no daemon */
-        /* openshift_config - many managed projects */
-        /* openshift_http - managed by openshift? */
-        /* openshift_quickstarts - applied on start */
-        /* oz - no daemon */
-        /* pam - no daemon */
-        /* pamconf - no daemon */
-        /* passwd - no daemon */
-        /* pbuilder - no daemon */
-        /* php - no daemon */
-        /* phpvars - squirrelmail, a web service */
-        /* protocols - no daemon */
-        /* pylonspaste - no single daemon? */
-        /* pythonpaste - no single daemon? */
-        /* rancid - no daemon */
-        /* resolv - no daemon */
-        /* rhsm - Java apps? */
-        /* rmt - no daemon */
-        /* schroot - applied on next schroot access */
-        /* securetty - applied on next login */
-        /* semanage - library configuration */
-        /* services - library configuration */
-        /* shadow - no daemon */
-        /* shells - no daemon */
-        /* shellvars_list - no daemon */
-        /* shellvars - many config files */
-        /* simplelines - files reread on use */
-        /* simplevars - many config files */
-        /* solaris_system - no daemon */
-        /* soma - could not find info? */
-        /* sos - no daemon */
-        /* spacevars - many config files */
-        /* ssh - no daemon */
-        /* star - no daemon */
-        /* subversion - no daemon */
-        /* sudoers - no daemon */
-        /* sysconfig_route - restart NetworkManager service? */
-        /* systemd - restart the changed services? */
-        /* termcap - no daemon */
-        /* up2date - no daemons? */
-        /* updatedb - updatedb(8) run preiodically */
-        /* vfstab - no daemon */
-        /* vmware_config - applied automatically? */
-        /* xml - too generic */
-        /* xorg - Xorg(1), system needs restart */
-        /* xymon_alerting - no daemon? */
-        /* yum - no daemon? */
+    /* provide the statistics of the DS plugin, if the module is installed */
+    ly_mod = ly_ctx_get_module_implemented(ly_ctx, "augeas-ds-stats");
+    if (ly_mod) {
+        rc = sr_oper_get_subscribe(session, ly_mod->name, "/augeas-ds-stats:ds-stats", aug_stats_oper_cb, plg, 0,
+                &subscr);
+        if (rc) {
+            SRPLG_LOG_ERR(PLG_NAME, "Failed to subscribe to the statistics (%s).", sr_strerror(rc));
+            goto cleanup;
+        }
     }
 
 cleanup:
     sr_session_release_context(session);
+    free(ht.slots);
     if (rc) {
         sr_unsubscribe(subscr);
+        aug_queue_free(queue);
+        free(modules);
+        free(plg);
     } else {
-        *private_data = subscr;
+        plg->subscr = subscr;
+        plg->queue = queue;
+        plg->modules = modules;
+        *private_data = plg;
     }
     return rc;
 }
@@ -845,10 +1230,18 @@ cleanup:
 void
 sr_plugin_cleanup_cb(sr_session_ctx_t *session, void *private_data)
 {
-    sr_subscription_ctx_t *subscr = private_data;
+    struct aug_plugin *plg = private_data;
 
     (void)session;
 
-    /* unsubscribe */
-    sr_unsubscribe(subscr);
+    /* unsubscribe so that no more actions are scheduled */
+    sr_unsubscribe(plg->subscr);
+
+    /* apply the pending changes and stop the workers */
+    aug_queue_free(plg->queue);
+    free(plg->modules);
+    if (plg->stats) {
+        munmap((void *)plg->stats, sizeof *plg->stats);
+    }
+    free(plg);
 }
@@ -0,0 +1,286 @@
+/**
+ * @file srplgda_queue.c
+ * @author agent <agent@local>
+ * @brief Augeas sysrepo-plugind plugin queue of actions applying the changes
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+#define _GNU_SOURCE
+
+#include "srplgda_queue.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sysrepo.h>
+
+/**
+ * @brief Compare two times.
+ *
+ * @param[in] ts1 First time.
+ * @param[in] ts2 Second time.
+ * @return Negative, zero, or positive number if @p ts1 is before, equal, or after @p ts2.
+ */
+static int
+aug_queue_ts_cmp(const struct timespec *ts1, const struct timespec *ts2)
+{
+    if (ts1->tv_sec != ts2->tv_sec) {
+        return (ts1->tv_sec < ts2->tv_sec) ? -1 : 1;
+    }
+    if (ts1->tv_nsec != ts2->tv_nsec) {
+        return (ts1->tv_nsec < ts2->tv_nsec) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Get the pending action that should be executed first, skip the running ones.
+ *
+ * @param[in] queue Queue with the lock held.
+ * @return Action or NULL if there is none.
+ */
+static struct aug_action *
+aug_queue_next(struct aug_queue *queue)
+{
+    struct aug_action *next = NULL;
+    uint32_t i;
+
+    for (i = 0; i < queue->action_count; ++i) {
+        if (!queue->actions[i]->pending || queue->actions[i]->running) {
+            continue;
+        }
+        if (!next || (aug_queue_ts_cmp(&queue->actions[i]->due, &next->due) < 0)) {
+            next = queue->actions[i];
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Worker thread executing the actions.
+ *
+ * @param[in] arg Queue.
+ * @return NULL.
+ */
+static void *
+aug_queue_worker(void *arg)
+{
+    struct aug_queue *queue = arg;
+    struct aug_action *action;
+    struct timespec now;
+    uint32_t coalesced;
+    int r;
+
+    pthread_mutex_lock(&queue->lock);
+    while (1) {
+        action = aug_queue_next(queue);
+        if (!action) {
+            if (queue->quit) {
+                break;
+            }
+
+            /* wait for a new action */
+            pthread_cond_wait(&queue->cond, &queue->lock);
+            continue;
+        }
+
+        if (!queue->quit) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (aug_queue_ts_cmp(&now, &action->due) < 0) {
+                /* wait for the end of the window, more events may be coalesced or another action scheduled */
+                pthread_cond_timedwait(&queue->cond, &queue->lock, &action->due);
+                continue;
+            }
+        }
+
+        /* take the action */
+        action->pending = 0;
+        action->running = 1;
+        coalesced = action->coalesced;
+        action->coalesced = 0;
+        pthread_mutex_unlock(&queue->lock);
+
+        r = action->apply(action->arg);
+        if (r) {
+            SRPLG_LOG_ERR(queue->plg_name, "Failed to apply changes by \"%s\" (%s).", action->name, sr_strerror(r));
+        } else {
+            SRPLG_LOG_INF(queue->plg_name, "Applied changes by \"%s\" (%" PRIu32 " change event(s)).", action->name,
+                    coalesced);
+        }
+
+        pthread_mutex_lock(&queue->lock);
+        action->running = 0;
+
+        /* the action may be pending again */
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return NULL;
+}
+
+int
+aug_queue_new(const char *plg_name, uint32_t worker_count, uint32_t window_ms, struct aug_queue **queue)
+{
+    int r;
+    pthread_condattr_t attr;
+
+    *queue = calloc(1, sizeof **queue);
+    if (!*queue) {
+        SRPLG_LOG_ERR(plg_name, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        return SR_ERR_NO_MEMORY;
+    }
+    (*queue)->plg_name = plg_name;
+    (*queue)->window_ms = window_ms;
+
+    /* the condition is used for timed waits on monotonic time */
+    pthread_mutex_init(&(*queue)->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&(*queue)->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    (*queue)->workers = calloc(worker_count ? worker_count : 1, sizeof *(*queue)->workers);
+    if (!(*queue)->workers) {
+        SRPLG_LOG_ERR(plg_name, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        aug_queue_free(*queue);
+        *queue = NULL;
+        return SR_ERR_NO_MEMORY;
+    }
+
+    /* start the workers */
+    for ((*queue)->worker_count = 0; (*queue)->worker_count < (worker_count ? worker_count : 1);
+            ++(*queue)->worker_count) {
+        r = pthread_create(&(*queue)->workers[(*queue)->worker_count], NULL, aug_queue_worker, *queue);
+        if (r) {
+            SRPLG_LOG_ERR(plg_name, "Creating thread failed (%s).", strerror(r));
+            aug_queue_free(*queue);
+            *queue = NULL;
+            return SR_ERR_SYS;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+void
+aug_queue_free(struct aug_queue *queue)
+{
+    uint32_t i;
+
+    if (!queue) {
+        return;
+    }
+
+    /* let the workers execute the pending actions and terminate */
+    pthread_mutex_lock(&queue->lock);
+    queue->quit = 1;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+
+    for (i = 0; i < queue->worker_count; ++i) {
+        pthread_join(queue->workers[i], NULL);
+    }
+    free(queue->workers);
+
+    for (i = 0; i < queue->action_count; ++i) {
+        free(queue->actions[i]->name);
+        free(queue->actions[i]);
+    }
+    free(queue->actions);
+
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->cond);
+    free(queue);
+}
+
+int
+aug_queue_action(struct aug_queue *queue, aug_apply_cb apply, const char *arg, const char *name,
+        struct aug_action **action)
+{
+    int rc = SR_ERR_OK;
+    uint32_t i;
+    void *mem;
+
+    pthread_mutex_lock(&queue->lock);
+
+    /* find the action, the same service is restarted only once */
+    for (i = 0; i < queue->action_count; ++i) {
+        if ((queue->actions[i]->apply == apply) && ((queue->actions[i]->arg == arg) ||
+                (queue->actions[i]->arg && arg && !strcmp(queue->actions[i]->arg, arg)))) {
+            *action = queue->actions[i];
+            goto cleanup;
+        }
+    }
+
+    /* create a new action */
+    mem = realloc(queue->actions, (queue->action_count + 1) * sizeof *queue->actions);
+    if (!mem) {
+        SRPLG_LOG_ERR(queue->plg_name, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    queue->actions = mem;
+
+    *action = calloc(1, sizeof **action);
+    if (!*action) {
+        SRPLG_LOG_ERR(queue->plg_name, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    (*action)->name = strdup(arg ? arg : name);
+    if (!(*action)->name) {
+        SRPLG_LOG_ERR(queue->plg_name, "Memory allocation failed (%s:%d).", __FILE__, __LINE__);
+        free(*action);
+        *action = NULL;
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    (*action)->apply = apply;
+    (*action)->arg = arg;
+    (*action)->queue = queue;
+    queue->actions[queue->action_count] = *action;
+    ++queue->action_count;
+
+cleanup:
+    pthread_mutex_unlock(&queue->lock);
+    return rc;
+}
+
+void
+aug_queue_schedule(struct aug_action *action)
+{
+    struct aug_queue *queue = action->queue;
+
+    pthread_mutex_lock(&queue->lock);
+
+    if (!action->pending) {
+        /* the window starts with the first event so the action is not postponed indefinitely */
+        clock_gettime(CLOCK_MONOTONIC, &action->due);
+        action->due.tv_sec += queue->window_ms / 1000;
+        action->due.tv_nsec += (queue->window_ms % 1000) * 1000000L;
+        if (action->due.tv_nsec >= 1000000000L) {
+            ++action->due.tv_sec;
+            action->due.tv_nsec -= 1000000000L;
+        }
+        action->pending = 1;
+    }
+    ++action->coalesced;
+
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file srplgda_queue.h
+ * @author agent <agent@local>
+ * @brief Augeas sysrepo-plugind plugin queue of actions applying the changes header
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+#ifndef SRPLGDA_QUEUE_H_
+#define SRPLGDA_QUEUE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <sysrepo.h>
+
+/**
+ * @brief Callback applying the changes of a module, for example restarting its service.
+ *
+ * @param[in] arg Argument of the action.
+ * @return SR_ERR value.
+ */
+typedef int (*aug_apply_cb)(const char *arg);
+
+/**
+ * @brief Action applying the changes. One action can be shared by several modules (the same service is restarted).
+ */
+struct aug_action {
+    aug_apply_cb apply;         /**< callback of the action */
+    const char *arg;            /**< argument of the callback */
+    char *name;                 /**< name of the action for logging */
+    struct aug_queue *queue;    /**< queue of the action */
+
+    struct timespec due;        /**< time when the pending action is executed */
+    int pending;                /**< whether the action is waiting to be executed */
+    int running;                /**< whether the action is being executed */
+    uint32_t coalesced;         /**< number of change events merged into the pending action */
+};
+
+/**
+ * @brief Queue of the actions executed by the worker threads.
+ *
+ * The change events of a module arriving during the window are coalesced into a single execution of its action.
+ * An action is never executed by more threads at once, but different actions are executed in parallel.
+ */
+struct aug_queue {
+    const char *plg_name;           /**< plugin name to use for logging */
+    pthread_mutex_t lock;           /**< lock for all the members and the actions */
+    pthread_cond_t cond;            /**< condition signalled on every change of the actions */
+
+    struct aug_action **actions;    /**< array of all the actions */
+    uint32_t action_count;          /**< count of actions */
+
+    pthread_t *workers;             /**< worker threads */
+    uint32_t worker_count;          /**< count of worker threads */
+    uint32_t window_ms;             /**< coalescing window in milliseconds */
+    int quit;                       /**< flag for the workers to execute all the pending actions and terminate */
+};
+
+/**
+ * @brief Create the queue and start its worker threads.
+ *
+ * @param[in] plg_name Plugin name to use for logging.
+ * @param[in] worker_count Number of worker threads.
+ * @param[in] window_ms Coalescing window in milliseconds.
+ * @param[out] queue Created queue.
+ * @return SR_ERR value.
+ */
+int aug_queue_new(const char *plg_name, uint32_t worker_count, uint32_t window_ms, struct aug_queue **queue);
+
+/**
+ * @brief Execute all the pending actions, stop the worker threads, and free the queue.
+ *
+ * @param[in] queue Queue to free.
+ */
+void aug_queue_free(struct aug_queue *queue);
+
+/**
+ * @brief Get the action for a callback and its argument, create it if it does not exist yet.
+ *
+ * @param[in] queue Queue of the action.
+ * @param[in] apply Callback of the action.
+ * @param[in] arg Argument of the callback, must be valid until the queue is freed.
+ * @param[in] name Name of the action for logging used if @p arg is NULL.
+ * @param[out] action Found or created action.
+ * @return SR_ERR value.
+ */
+int aug_queue_action(struct aug_queue *queue, aug_apply_cb apply, const char *arg, const char *name,
+        struct aug_action **action);
+
+/**
+ * @brief Schedule the action for execution after the coalescing window.
+ *
+ * If the action is already pending, the event is merged into it. If it is just being executed, it is executed again
+ * so that the latest changes are applied.
+ *
+ * @param[in] action Action to schedule.
+ */
+void aug_queue_schedule(struct aug_action *action);
+
+#endif /* SRPLGDA_QUEUE_H_ */
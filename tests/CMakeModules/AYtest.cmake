@@ -1,4 +1,4 @@
-if(NOT ${CMAKE_ARGC} EQUAL 9)
+if(NOT ${CMAKE_ARGC} EQUAL 9 AND NOT ${CMAKE_ARGC} EQUAL 10)
     message(FATAL_ERROR "[aytest] ERROR: wrong number of parameters.")
 endif()
 
@@ -8,6 +8,8 @@ set(YANG_GEN_DIR ${CMAKE_ARGV5})
 set(AUGYANG_BIN ${CMAKE_ARGV6})
 set(YANGLINT_BIN ${CMAKE_ARGV7})
 set(MOD ${CMAKE_ARGV8})
+# optional augyang flag, the expected module is then compared only partially
+set(FLAG ${CMAKE_ARGV9})
 
 if(NOT PROJECT_DIR)
     message(FATAL_ERROR "[aytest] ERROR: PROJECT_DIR variable is empty.")
@@ -38,13 +40,35 @@ set(EXPFILE "${YANG_EXP_DIR}/${MOD}.yang")
 string(REPLACE "-" "_" AUGFILE ${MOD})
 
 # generate yang file
-execute_process(COMMAND ${AUGYANG_BIN} -O ${YANG_GEN_DIR} ${AUGFILE} RESULT_VARIABLE ret)
+execute_process(COMMAND ${AUGYANG_BIN} ${FLAG} -O ${YANG_GEN_DIR} ${AUGFILE} RESULT_VARIABLE ret)
 if(NOT ret EQUAL 0)
     message(FATAL_ERROR "[aytest] '${MOD}' module generation failed.")
 endif()
 
 # compare generated yang file with expected one
-if ("${MOD}" MATCHES "^(ldif|dns-zone|gdm|krb5|php|rsyncd|semanage|strongswan|stunnel|sudoers)$")
+if ("${FLAG}" STREQUAL "-m")
+    # only the regexes are minimized, their language is checked by test_regex
+    execute_process(COMMAND diff -I "pattern " -I "when " ${GENFILE} ${EXPFILE} RESULT_VARIABLE ret)
+elseif ("${FLAG}" STREQUAL "-T")
+    # the types differ, but augeas-types must be imported exactly if some type refers to it
+    file(READ ${GENFILE} gen)
+    string(FIND "${gen}" "import augeas-types {" import_pos)
+    string(FIND "${gen}" "type augt:" type_pos)
+    if((import_pos EQUAL -1) AND NOT (type_pos EQUAL -1))
+        message(FATAL_ERROR "[aytest] '${MOD}' module refers to augeas-types without importing it.")
+    elseif(NOT (import_pos EQUAL -1) AND (type_pos EQUAL -1))
+        message(FATAL_ERROR "[aytest] '${MOD}' module imports augeas-types without using it.")
+    endif()
+    set(ret 0)
+elseif ("${FLAG}" STREQUAL "-A")
+    # only the autoloaded lens and its filter are added, all the tested Augeas modules have an autoload transform
+    file(READ ${GENFILE} gen)
+    string(FIND "${gen}" "  augex:autoload-lens \"" lens_pos)
+    if(lens_pos EQUAL -1)
+        message(FATAL_ERROR "[aytest] '${MOD}' module is missing the autoloaded lens.")
+    endif()
+    execute_process(COMMAND diff -I "augex:autoload-" ${GENFILE} ${EXPFILE} RESULT_VARIABLE ret)
+elseif ("${MOD}" MATCHES "^(ldif|dns-zone|gdm|krb5|php|rsyncd|semanage|strongswan|stunnel|sudoers)$")
     message(WARNING "The 'diff' command ignores yang-pattern and when-pattern.")
     execute_process(COMMAND diff -I "pattern " -I "when " ${GENFILE} ${EXPFILE} RESULT_VARIABLE ret)
 else()
@@ -55,7 +79,10 @@ if(ret EQUAL 1)
 endif()
 
 # check if generated file is valid yang module
-execute_process(COMMAND ${YANGLINT_BIN} ${PROJECT_DIR}/modules/augeas-extension.yang ${GENFILE}
+if ("${FLAG}" STREQUAL "-T")
+    set(TYPESFILE "${YANG_GEN_DIR}/augeas-types.yang")
+endif()
+execute_process(COMMAND ${YANGLINT_BIN} ${PROJECT_DIR}/modules/augeas-extension.yang ${TYPESFILE} ${GENFILE}
     RESULT_VARIABLE ret ERROR_VARIABLE out)
 if(NOT out STREQUAL "")
     message(SEND_ERROR "${out}")
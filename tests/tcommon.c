@@ -19,9 +19,13 @@
 #include "tconfig.h"
 
 #include <assert.h>
+#include <errno.h>
+#include <ftw.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -61,6 +65,173 @@ tsetup_glob(void **state, const char *yang_mod, const struct srplg_ds_s *ds_plg,
     return 0;
 }
 
+/**
+ * @brief Copy a file.
+ *
+ * @param[in] from Source file.
+ * @param[in] to Created target file.
+ * @return 0 on success;
+ * @return non-zero on error.
+ */
+static int
+tcopy_file(const char *from, const char *to)
+{
+    FILE *in, *out = NULL;
+    char buf[1024];
+    size_t len;
+    int ret = 0;
+
+    if (!(in = fopen(from, "r")) || !(out = fopen(to, "w"))) {
+        ret = 1;
+        goto cleanup;
+    }
+    while ((len = fread(buf, 1, sizeof buf, in))) {
+        if (fwrite(buf, 1, len, out) != len) {
+            ret = 1;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    if (in) {
+        fclose(in);
+    }
+    if (out && fclose(out)) {
+        ret = 1;
+    }
+    return ret;
+}
+
+/**
+ * @brief Create all the parent directories of a file.
+ *
+ * @param[in] path Absolute file path, it is modified but restored.
+ * @return 0 on success;
+ * @return non-zero on error.
+ */
+static int
+tmkdir_parents(char *path)
+{
+    char *ptr;
+
+    for (ptr = strchr(path + 1, '/'); ptr; ptr = strchr(ptr + 1, '/')) {
+        *ptr = '\0';
+        if ((mkdir(path, 0700) == -1) && (errno != EEXIST)) {
+            *ptr = '/';
+            return 1;
+        }
+        *ptr = '/';
+    }
+
+    return 0;
+}
+
+int
+tsetup_root(void **state, const char *yang_mod, const struct srplg_ds_s *ds_plg, ...)
+{
+    struct tstate *st;
+    const char *file, *path;
+    char *from = NULL, *to = NULL;
+    va_list ap;
+    int ret = 0;
+
+    if (tsetup_glob(state, yang_mod, ds_plg, NULL)) {
+        return 1;
+    }
+    st = *state;
+
+    /* temporary root */
+    st->root = strdup("/tmp/srds_augeas_test.XXXXXX");
+    if (!st->root || !mkdtemp(st->root)) {
+        free(st->root);
+        st->root = NULL;
+        return 1;
+    }
+
+    /* copy the config files */
+    va_start(ap, ds_plg);
+    while ((file = va_arg(ap, const char *))) {
+        path = va_arg(ap, const char *);
+        if ((asprintf(&from, "%s/%s", AUG_CONFIG_FILES_DIR, file) == -1) ||
+                (asprintf(&to, "%s%s", st->root, path) == -1)) {
+            ret = 1;
+            goto cleanup;
+        }
+        if (tmkdir_parents(to) || tcopy_file(from, to)) {
+            ret = 1;
+            goto cleanup;
+        }
+
+        free(from);
+        from = NULL;
+        free(to);
+        to = NULL;
+    }
+
+    /* Augeas of the plugin uses the root */
+    if (setenv("AUGEAS_ROOT", st->root, 1)) {
+        ret = 1;
+    }
+
+cleanup:
+    va_end(ap);
+    free(from);
+    free(to);
+    return ret;
+}
+
+/**
+ * @brief Remove a file or an empty directory, callback for nftw().
+ */
+static int
+tremove_cb(const char *path, const struct stat *sb, int typeflag, struct FTW *ftwbuf)
+{
+    (void)sb;
+    (void)typeflag;
+    (void)ftwbuf;
+
+    return remove(path);
+}
+
+int
+tteardown_root(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    char *root = st->root;
+    int ret;
+
+    /* the plugin must not use the root anymore */
+    ret = tteardown_glob(state);
+    unsetenv("AUGEAS_ROOT");
+
+    if (root) {
+        if (nftw(root, tremove_cb, 16, FTW_DEPTH | FTW_PHYS)) {
+            ret = 1;
+        }
+        free(root);
+    }
+
+    return ret;
+}
+
+int
+tload_print(struct tstate *st, const struct lys_module *mod, char **str)
+{
+    int ret;
+
+    lyd_free_siblings(st->data);
+    st->data = NULL;
+
+    if ((ret = st->ds_plg->load_cb(mod, SR_DS_STARTUP, NULL, 0, &st->data))) {
+        return ret;
+    }
+    if (lyd_print_mem(str, st->data, LYD_XML, LYD_PRINT_WITHSIBLINGS)) {
+        return 1;
+    }
+
+    return 0;
+}
+
 int
 tteardown_glob(void **state)
 {
@@ -89,6 +260,11 @@ tteardown(void **state)
     lyd_free_siblings(st->data);
     st->data = NULL;;
 
+    if (!st->aug_input_files) {
+        /* the config files are in a temporary root */
+        return 0;
+    }
+
     /* remove all created files */
     files = strdup(st->aug_input_files);
     for (file = strtok(files, ";"); file; file = strtok(NULL, ";")) {
@@ -0,0 +1,153 @@
+/**
+ * @file test_autoload.c
+ * @author agent <agent@local>
+ * @brief SR DS plugin test of the modules with the autoloaded lens
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include "tconfig.h"
+
+/* augeas SR DS plugin, the config files are in a temporary root */
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+#include <libyang/libyang.h>
+#include <sysrepo/plugins_datastore.h>
+
+/* generated without the autoloaded lens */
+#define AUG_TEST_MODULE "passwd"
+
+/* generated with the autoloaded lens */
+#define AUG_TEST_MODULE_AUTOLOAD "hosts"
+
+static struct lys_module *amod;
+
+static int
+setup_f(void **state)
+{
+    struct tstate *st;
+
+    if (tsetup_root(state, AUG_TEST_MODULE, &srpds__, AUG_TEST_MODULE, "/etc/passwd", AUG_TEST_MODULE_AUTOLOAD,
+            "/etc/hosts", NULL)) {
+        return 1;
+    }
+    st = *state;
+
+    if (lys_parse_path(st->ctx, AUG_AUTOLOAD_YANG_DIR "/" AUG_TEST_MODULE_AUTOLOAD ".yang", LYS_IN_YANG, &amod)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check the value of an Augeas node of the plugin.
+ *
+ * @param[in] path Augeas path.
+ * @param[in] expected Expected value.
+ */
+static void
+tassert_aug_value(const char *path, const char *expected)
+{
+    const char *value;
+
+    assert_int_equal(1, aug_get(auginfo.aug, path, &value));
+    assert_string_equal(expected, value);
+}
+
+/**
+ * @brief Check that the config file of the module with the autoloaded lens is found.
+ */
+static void
+tassert_config_file(void)
+{
+    const char **files;
+    uint32_t file_count;
+
+    assert_int_equal(SR_ERR_OK, augds_get_config_files(auginfo.aug, amod, 0, &files, &file_count));
+    assert_int_equal(1, file_count);
+    assert_string_equal("/files/etc/hosts", files[0]);
+    free(files);
+}
+
+static void
+test_autoload(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    char *str;
+
+    assert_int_equal(0, tload_print(st, amod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    free(str);
+
+    /* only the autoloaded lens with its filter from the YANG module */
+    assert_int_equal(0, auginfo.autoload_all);
+    assert_int_equal(1, aug_match(auginfo.aug, "/augeas/load/*", NULL));
+    tassert_aug_value("/augeas/load/Hosts/lens", "Hosts.lns");
+    tassert_aug_value("/augeas/load/Hosts/incl", "/etc/hosts");
+
+    /* the files are found by the qualified lens name */
+    tassert_config_file();
+}
+
+static void
+test_mixed(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    char *str, *str2, *str_reload;
+
+    assert_int_equal(0, tload_print(st, amod, &str));
+    assert_int_equal(0, auginfo.autoload_all);
+
+    /* the handle is recreated with all the Augeas modules */
+    assert_int_equal(0, tload_print(st, st->mod, &str2));
+    assert_non_null(strstr(str2, "avahi"));
+    assert_int_equal(1, auginfo.autoload_all);
+    assert_int_equal(1, auginfo.mod_count);
+    tassert_aug_value("/augeas/load/Passwd/lens", "@Passwd");
+    assert_int_equal(0, aug_match(auginfo.aug, "/augeas/load/Hosts/lens", NULL));
+
+    /* the module with the autoloaded lens is initialized again in the new handle */
+    assert_int_equal(0, tload_print(st, amod, &str_reload));
+    assert_string_equal(str, str_reload);
+    free(str_reload);
+    assert_int_equal(2, auginfo.mod_count);
+    tassert_aug_value("/augeas/load/Hosts/lens", "@Hosts");
+    tassert_config_file();
+
+    assert_int_equal(0, tload_print(st, st->mod, &str_reload));
+    assert_string_equal(str2, str_reload);
+    free(str_reload);
+
+    free(str);
+    free(str2);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_autoload),
+        cmocka_unit_test(test_mixed),
+    };
+
+    return cmocka_run_group_tests(tests, setup_f, tteardown_root);
+}
@@ -0,0 +1,191 @@
+/**
+ * @file test_mem_limit.c
+ * @author agent <agent@local>
+ * @brief SR DS plugin memory limit test
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include "tconfig.h"
+
+/* augeas SR DS plugin, the config files are in a temporary root */
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+#include <libyang/libyang.h>
+#include <sysrepo/plugins_datastore.h>
+
+#define AUG_TEST_MODULE "hosts"
+#define AUG_TEST_MODULE2 "passwd"
+
+/* second module sharing the Augeas handle with the test module */
+static const struct lys_module *mod2;
+
+static int
+setup_f(void **state)
+{
+    struct tstate *st;
+
+    /* every module is over the limit so it evicts all the others */
+    setenv(AUG_MEM_LIMIT_ENV, "1", 1);
+
+    if (tsetup_root(state, AUG_TEST_MODULE, &srpds__, AUG_TEST_MODULE, "/etc/hosts", AUG_TEST_MODULE2,
+            "/etc/passwd", NULL)) {
+        return 1;
+    }
+    st = *state;
+
+    mod2 = ly_ctx_load_module(st->ctx, AUG_TEST_MODULE2, NULL, NULL);
+    if (!mod2) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int
+teardown_f(void **state)
+{
+    unsetenv(AUG_MEM_LIMIT_ENV);
+
+    return tteardown_root(state);
+}
+
+/**
+ * @brief Find the module in the plugin.
+ *
+ * @param[in] mod YANG module.
+ * @return Initialized module.
+ */
+static const struct augmod *
+tmem_augmod(const struct lys_module *mod)
+{
+    uint32_t i;
+
+    for (i = 0; i < auginfo.mod_count; ++i) {
+        if (auginfo.mods[i].mod == mod) {
+            return &auginfo.mods[i];
+        }
+    }
+
+    fail_msg("Module \"%s\" not initialized.", mod->name);
+    return NULL;
+}
+
+/**
+ * @brief Read a whole file.
+ *
+ * @param[in] path File path.
+ * @return File content.
+ */
+static char *
+tread_file(const char *path)
+{
+    char *buf = NULL;
+    size_t len = 0;
+    FILE *f;
+
+    f = fopen(path, "r");
+    assert_non_null(f);
+    assert_int_not_equal(-1, getdelim(&buf, &len, '\0', f));
+    fclose(f);
+
+    return buf;
+}
+
+static void
+test_evict_reload(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    char *str, *str2, *str_reload;
+
+    /* only the last used module keeps its Augeas data */
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    assert_int_equal(0, tmem_augmod(st->mod)->evicted);
+
+    assert_int_equal(0, tload_print(st, mod2, &str2));
+    assert_non_null(strstr(str2, "avahi"));
+    assert_int_equal(1, tmem_augmod(st->mod)->evicted);
+    assert_int_equal(0, tmem_augmod(mod2)->evicted);
+    assert_int_equal(0, aug_match(auginfo.aug, "/files/etc/hosts", NULL));
+    assert_int_equal(1, aug_match(auginfo.aug, "/files/etc/passwd", NULL));
+
+    /* the evicted module is loaded again with the same data */
+    assert_int_equal(0, tload_print(st, st->mod, &str_reload));
+    assert_string_equal(str, str_reload);
+    free(str_reload);
+    assert_int_equal(0, tmem_augmod(st->mod)->evicted);
+    assert_int_equal(1, tmem_augmod(mod2)->evicted);
+    assert_int_equal(1, aug_match(auginfo.aug, "/files/etc/hosts", NULL));
+    assert_int_equal(0, aug_match(auginfo.aug, "/files/etc/passwd", NULL));
+
+    assert_int_equal(0, tload_print(st, mod2, &str_reload));
+    assert_string_equal(str2, str_reload);
+    free(str_reload);
+    assert_int_equal(1, tmem_augmod(st->mod)->evicted);
+
+    free(str);
+    free(str2);
+}
+
+static void
+test_evict_store(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    struct lyd_node *node;
+    char *path, *orig, *content;
+
+    /* load the data evicting the second module */
+    assert_int_equal(SR_ERR_OK, st->ds_plg->load_cb(st->mod, SR_DS_STARTUP, NULL, 0, &st->data));
+    assert_int_equal(1, tmem_augmod(mod2)->evicted);
+
+    /* store a change */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(st->data, "host-list[_seq='1']/canonical", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "bar"));
+    assert_int_equal(SR_ERR_OK, st->ds_plg->store_cb(st->mod, SR_DS_STARTUP, NULL, st->data));
+
+    assert_int_not_equal(-1, asprintf(&path, "%s/etc/hosts", st->root));
+    content = tread_file(path);
+    free(path);
+    assert_non_null(strstr(content, "127.0.0.1 bar foo.example.com\n"));
+    free(content);
+
+    /* the config file of the evicted module is not touched by saving */
+    assert_int_not_equal(-1, asprintf(&path, "%s/etc/passwd", st->root));
+    content = tread_file(path);
+    free(path);
+    orig = tread_file(AUG_CONFIG_FILES_DIR "/" AUG_TEST_MODULE2);
+    assert_string_equal(orig, content);
+    free(orig);
+    free(content);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_evict_reload),
+        cmocka_unit_test_teardown(test_evict_store, tteardown),
+    };
+
+    return cmocka_run_group_tests(tests, setup_f, teardown_f);
+}
@@ -0,0 +1,172 @@
+/**
+ * @file test_pattern_cache.c
+ * @author agent <agent@local>
+ * @brief SR DS plugin compiled pattern cache test
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include "tconfig.h"
+
+/* augeas SR DS plugin */
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+#include <libyang/libyang.h>
+
+/* both leaves use the same pattern, once inverted */
+#define TPAT_MODULE \
+    "module tpat {\n" \
+    "  namespace \"urn:tpat\";\n" \
+    "  prefix tp;\n" \
+    "  leaf plain {\n" \
+    "    type string {\n" \
+    "      pattern '[a-z]+';\n" \
+    "    }\n" \
+    "  }\n" \
+    "  leaf inverted {\n" \
+    "    type string {\n" \
+    "      pattern '[a-z]+' {\n" \
+    "        modifier invert-match;\n" \
+    "      }\n" \
+    "    }\n" \
+    "  }\n" \
+    "}\n"
+
+/**
+ * @brief Learn whether a label matches the patterns.
+ *
+ * @param[in] patterns Array of patterns.
+ * @param[in] pattern_count Count of @p patterns.
+ * @param[in] label Label to match.
+ * @return Whether @p label matches.
+ */
+static int
+tmatch(struct augnode_pattern *patterns, uint32_t pattern_count, const char *label)
+{
+    int match;
+
+    assert_int_equal(SR_ERR_OK, augds_pattern_label_match(patterns, pattern_count, label, &match));
+    return match;
+}
+
+/**
+ * @brief Check the matches of a pattern '[a-z]+' and its inverted use, alternately to reuse the match data.
+ *
+ * @param[in] plain Pattern.
+ * @param[in] inverted Inverted pattern.
+ */
+static void
+tcheck_matches(struct augnode_pattern *plain, struct augnode_pattern *inverted)
+{
+    assert_int_equal(1, tmatch(plain, 1, "abc"));
+    assert_int_equal(0, tmatch(inverted, 1, "abc"));
+    assert_int_equal(0, tmatch(plain, 1, "ABC"));
+    assert_int_equal(1, tmatch(inverted, 1, "ABC"));
+
+    /* the whole label must match */
+    assert_int_equal(0, tmatch(plain, 1, "abc1"));
+    assert_int_equal(1, tmatch(inverted, 1, "abc1"));
+    assert_int_equal(0, tmatch(plain, 1, "1abc"));
+    assert_int_equal(1, tmatch(inverted, 1, "1abc"));
+    assert_int_equal(0, tmatch(plain, 1, ""));
+    assert_int_equal(1, tmatch(inverted, 1, ""));
+}
+
+static void
+test_yang_pattern(void **state)
+{
+    struct auginfo info = {0};
+    struct ly_ctx *ctx;
+    const struct lysc_node_leaf *leaf;
+    struct augnode_pattern *plain = NULL, *inverted = NULL;
+    uint32_t plain_count = 0, inverted_count = 0;
+
+    (void)state;
+
+    assert_int_equal(LY_SUCCESS, ly_ctx_new(NULL, 0, &ctx));
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(ctx, TPAT_MODULE, LYS_IN_YANG, NULL));
+
+    leaf = (const struct lysc_node_leaf *)lys_find_path(ctx, NULL, "/tpat:plain", 0);
+    assert_non_null(leaf);
+    assert_int_equal(SR_ERR_OK, augds_init_auginfo_add_pattern2(&info,
+            ((struct lysc_type_str *)leaf->type)->patterns, &plain, &plain_count));
+    leaf = (const struct lysc_node_leaf *)lys_find_path(ctx, NULL, "/tpat:inverted", 0);
+    assert_non_null(leaf);
+    assert_int_equal(SR_ERR_OK, augds_init_auginfo_add_pattern2(&info,
+            ((struct lysc_type_str *)leaf->type)->patterns, &inverted, &inverted_count));
+
+    /* one cached pattern, the inversion is kept by the groups */
+    assert_int_equal(1, info.pattern_count);
+    assert_true(plain->groups[0].pattern == inverted->groups[0].pattern);
+    assert_int_equal(2, plain->groups[0].pattern->refs);
+    assert_int_equal(0, plain->groups[0].inverted);
+    assert_int_equal(1, inverted->groups[0].inverted);
+
+    tcheck_matches(plain, inverted);
+
+    /* the pattern is freed with its last use */
+    augds_free_info_patterns(&info, plain, plain_count);
+    assert_int_equal(1, info.pattern_count);
+    assert_int_equal(0, tmatch(inverted, 1, "abc"));
+    assert_int_equal(1, tmatch(inverted, 1, "ABC"));
+    augds_free_info_patterns(&info, inverted, inverted_count);
+    assert_int_equal(0, info.pattern_count);
+
+    free(info.patterns);
+    ly_ctx_destroy(ctx);
+}
+
+static void
+test_pcre2_pattern(void **state)
+{
+    struct auginfo info = {0};
+    struct augnode_pattern *plain = NULL, *inverted = NULL;
+    uint32_t plain_count = 0, inverted_count = 0;
+
+    (void)state;
+
+    assert_int_equal(SR_ERR_OK, augds_init_auginfo_add_pattern(&info, "[a-z]+", 0, &plain, &plain_count));
+    assert_int_equal(SR_ERR_OK, augds_init_auginfo_add_pattern(&info, "[a-z]+", 1, &inverted, &inverted_count));
+
+    /* one cached pattern, the inversion is kept by the groups */
+    assert_int_equal(1, info.pattern_count);
+    assert_true(plain->groups[0].pattern == inverted->groups[0].pattern);
+    assert_int_equal(2, plain->groups[0].pattern->refs);
+
+    tcheck_matches(plain, inverted);
+
+    augds_free_info_patterns(&info, inverted, inverted_count);
+    augds_free_info_patterns(&info, plain, plain_count);
+    assert_int_equal(0, info.pattern_count);
+
+    free(info.patterns);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_yang_pattern),
+        cmocka_unit_test(test_pcre2_pattern),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,332 @@
+/**
+ * @file test_regex.c
+ * @author agent <agent@local>
+ * @brief augyang regex minimization and label literals test
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmocka.h>
+#include <libyang/libyang.h>
+
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+
+#include "parse_regex.h"
+
+/**
+ * @brief Maximum length of the strings on which the languages are compared.
+ */
+#define TREGEX_MAX_LEN 6
+
+/**
+ * @brief Maximum number of literals requested from ay_regex_literals().
+ */
+#define TREGEX_MAX_LITERALS 16
+
+struct tregex_min {
+    const char *regex;      /**< Augeas regex. */
+    const char *min;        /**< Expected minimized regex, NULL if the regex is not shortened. */
+    const char *alphabet;   /**< Characters of the strings on which the languages are compared. */
+};
+
+struct tregex_lit {
+    const char *regex;      /**< Augeas regex. */
+    const char *literals;   /**< Expected literals separated by ' ', NULL if the language is not a small finite set. */
+    const char *alphabet;   /**< Characters of the strings on which the languages are compared. */
+};
+
+static const struct tregex_min tregex_min_table[] = {
+    {"a(bc)d", "abcd", "abcd"},
+    {"(a)*", "a*", "ab"},
+    {"((a))", "a", "ab"},
+    {"a|(b|c)", "[abc]", "abcd"},
+    {"(a)|(b)", "[ab]", "abc"},
+    {"[ab]|c|d", "[abcd]", "abcde"},
+    {"foo|foobar", "foo(bar)?", "fobar"},
+    {"a|ab|abc", "a|abc?", "abcd"},
+    {"ab|a", "ab?", "abc"},
+    {"on|one|once", "on(e|ce)?", "onec"},
+    {"x(y|z)w", "x[yz]w", "xyzw"},
+    {"(a|b)(c|d)", "[ab][cd]", "abcde"},
+    {"a(b|c)?d", "a[bc]?d", "abcd"},
+    {"(ab)+c|(ab)+d", "(ab)+[cd]", "abcd"},
+    {"a|b|c", NULL, "abcd"},
+    {"abc|abd|x", NULL, "abcdx"},
+    {"foo|bar|baz", NULL, "fobarz"},
+    {"(ab|ac)*", NULL, "abc"},
+    {"[a-c]+|[0-9]+", NULL, "abd01"},
+    {"a?|b", NULL, "abc"},
+    {"(a|)b", NULL, "ab"},
+    {"^a|b", NULL, "ab"},
+    {"a{2}|ab", NULL, "ab"},
+};
+
+static const struct tregex_lit tregex_lit_table[] = {
+    {"(no)?auth|[Dd]ebug", "Debug auth debug noauth", "noauthDd"},
+    {"yes|no|on|off", "no off on yes", "yesnof"},
+    {"[Tt]rue|[Ff]alse", "False True false true", "TtrueFals"},
+    {"a(b|c)?d", "abd acd ad", "abcd"},
+    {"(a|b)(c|d)", "ac ad bc bd", "abcd"},
+    {"on|one|once", "on once one", "onec"},
+    {"a|(b|c)", "a b c", "abcd"},
+    {"(a)*", NULL, "ab"},
+    {"[a-c]+|[0-9]+", NULL, "abd01"},
+    {"ab*|ac*", NULL, "abc"},
+    {"(ab)+c", NULL, "abc"},
+    {"^a|b", NULL, "ab"},
+};
+
+/**
+ * @brief Compile the Augeas regex so that it must match the whole subject.
+ *
+ * @param[in] regex Augeas regex.
+ * @return Compiled regex.
+ */
+static pcre2_code *
+tregex_compile(const char *regex)
+{
+    pcre2_code *code;
+    int err;
+    PCRE2_SIZE off;
+
+    code = pcre2_compile((PCRE2_SPTR)regex, PCRE2_ZERO_TERMINATED, PCRE2_ANCHORED | PCRE2_ENDANCHORED, &err, &off,
+            NULL);
+    if (!code) {
+        fail_msg("Failed to compile regex \"%s\" (error %d at %zu).", regex, err, (size_t)off);
+    }
+
+    return code;
+}
+
+/**
+ * @brief Check if the compiled regex matches the whole string.
+ *
+ * @param[in] code Compiled regex.
+ * @param[in] match_data Match data of @p code.
+ * @param[in] str String to match.
+ * @return 1 if it matches, 0 if not.
+ */
+static int
+tregex_match(const pcre2_code *code, pcre2_match_data *match_data, const char *str)
+{
+    int rc;
+
+    rc = pcre2_match(code, (PCRE2_SPTR)str, PCRE2_ZERO_TERMINATED, 0, 0, match_data, NULL);
+    if ((rc < 0) && (rc != PCRE2_ERROR_NOMATCH)) {
+        fail_msg("Matching \"%s\" failed (error %d).", str, rc);
+    }
+
+    return rc >= 0;
+}
+
+/**
+ * @brief Callback deciding if the string belongs to the expected language.
+ *
+ * @param[in] str String to check.
+ * @param[in] arg Argument of the callback.
+ * @return 1 if @p str belongs to the expected language, 0 if not.
+ */
+typedef int (*tregex_lang_cb)(const char *str, const void *arg);
+
+/**
+ * @brief Compare the language of the regex with the expected language on all the strings up to TREGEX_MAX_LEN.
+ *
+ * @param[in] regex Augeas regex.
+ * @param[in] alphabet Characters of the compared strings.
+ * @param[in] lang Callback with the expected language.
+ * @param[in] arg Argument of @p lang.
+ */
+static void
+tregex_assert_language(const char *regex, const char *alphabet, tregex_lang_cb lang, const void *arg)
+{
+    pcre2_code *code;
+    pcre2_match_data *match_data;
+    char str[TREGEX_MAX_LEN + 1];
+    uint32_t idx[TREGEX_MAX_LEN], len, i, alen;
+
+    code = tregex_compile(regex);
+    match_data = pcre2_match_data_create_from_pattern(code, NULL);
+    assert_non_null(match_data);
+    alen = strlen(alphabet);
+
+    /* Iterate over all the strings as over numbers in the base of the alphabet length. */
+    for (len = 0; len <= TREGEX_MAX_LEN; len++) {
+        memset(idx, 0, sizeof idx);
+        do {
+            for (i = 0; i < len; i++) {
+                str[i] = alphabet[idx[i]];
+            }
+            str[len] = '\0';
+            if (tregex_match(code, match_data, str) != lang(str, arg)) {
+                fail_msg("Regex \"%s\" differs on the string \"%s\".", regex, str);
+            }
+
+            for (i = 0; (i < len) && (++idx[i] == alen); i++) {
+                idx[i] = 0;
+            }
+        } while (i < len);
+    }
+
+    pcre2_match_data_free(match_data);
+    pcre2_code_free(code);
+}
+
+/**
+ * @brief Language of the compiled regex.
+ *
+ * @param[in] str String to check.
+ * @param[in] arg Compiled regex with match data at index 0 and 1.
+ * @return 1 if the regex matches @p str.
+ */
+static int
+tregex_lang_regex(const char *str, const void *arg)
+{
+    void * const *regex = arg;
+
+    return tregex_match(regex[0], regex[1], str);
+}
+
+/**
+ * @brief Language of the literals.
+ *
+ * @param[in] str String to check.
+ * @param[in] arg Literals in LY_ARRAY.
+ * @return 1 if @p str is one of the literals.
+ */
+static int
+tregex_lang_literals(const char *str, const void *arg)
+{
+    char * const *literals = arg;
+    LY_ARRAY_COUNT_TYPE i;
+
+    LY_ARRAY_FOR(literals, i) {
+        if (!strcmp(literals[i], str)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void
+test_minimize(void **state)
+{
+    const struct tregex_min *test;
+    void *orig[2];
+    char *min;
+    size_t i;
+
+    (void)state;
+
+    for (i = 0; i < sizeof tregex_min_table / sizeof *tregex_min_table; i++) {
+        test = &tregex_min_table[i];
+        assert_int_equal(0, ay_regex_minimize(test->regex, &min));
+        if (!test->min) {
+            if (min) {
+                fail_msg("Regex \"%s\" was minimized to \"%s\".", test->regex, min);
+            }
+            continue;
+        }
+        assert_non_null(min);
+        assert_string_equal(test->min, min);
+
+        /* The minimized regex must have the same language as the original one. */
+        orig[0] = tregex_compile(test->regex);
+        orig[1] = pcre2_match_data_create_from_pattern(orig[0], NULL);
+        assert_non_null(orig[1]);
+        tregex_assert_language(min, test->alphabet, tregex_lang_regex, orig);
+        pcre2_match_data_free(orig[1]);
+        pcre2_code_free(orig[0]);
+        free(min);
+    }
+}
+
+static void
+test_literals(void **state)
+{
+    const struct tregex_lit *test;
+    char **literals, *str;
+    size_t i, len;
+    LY_ARRAY_COUNT_TYPE j;
+
+    (void)state;
+
+    for (i = 0; i < sizeof tregex_lit_table / sizeof *tregex_lit_table; i++) {
+        test = &tregex_lit_table[i];
+        assert_int_equal(0, ay_regex_literals(test->regex, TREGEX_MAX_LITERALS, &literals));
+        if (!test->literals) {
+            if (literals) {
+                fail_msg("Regex \"%s\" has literals.", test->regex);
+            }
+            continue;
+        }
+        assert_non_null(literals);
+
+        /* Sorted literals separated by ' '. */
+        len = 0;
+        LY_ARRAY_FOR(literals, j) {
+            len += strlen(literals[j]) + 1;
+        }
+        str = calloc(1, len + 1);
+        assert_non_null(str);
+        LY_ARRAY_FOR(literals, j) {
+            if (j) {
+                strcat(str, " ");
+            }
+            strcat(str, literals[j]);
+        }
+        assert_string_equal(test->literals, str);
+        free(str);
+
+        /* The regex must match exactly the literals. */
+        tregex_assert_language(test->regex, test->alphabet, tregex_lang_literals, literals);
+        ay_regex_literals_free(literals);
+    }
+}
+
+static void
+test_literals_max(void **state)
+{
+    char **literals;
+
+    (void)state;
+
+    /* There are 4 literals, so the limit 3 is exceeded. */
+    assert_int_equal(0, ay_regex_literals("(no)?auth|[Dd]ebug", 3, &literals));
+    assert_null(literals);
+    assert_int_equal(0, ay_regex_literals("(no)?auth|[Dd]ebug", 4, &literals));
+    assert_non_null(literals);
+    assert_int_equal(4, LY_ARRAY_COUNT(literals));
+    ay_regex_literals_free(literals);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_minimize),
+        cmocka_unit_test(test_literals),
+        cmocka_unit_test(test_literals_max),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file test_warmup.c
+ * @author agent <agent@local>
+ * @brief SR DS plugin test of warming up the modules in the background
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include "tconfig.h"
+
+/* augeas SR DS plugin, the config files are in a temporary root */
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+#include <libyang/libyang.h>
+#include <sysrepo/plugins_datastore.h>
+
+#define AUG_TEST_MODULE "hosts"
+#define AUG_TEST_MODULE2 "passwd"
+
+/* second module warmed up with the test module */
+static const struct lys_module *mod2;
+
+static int
+setup_f(void **state)
+{
+    struct tstate *st;
+
+    setenv(AUG_WARMUP_ENV, AUG_TEST_MODULE " " AUG_TEST_MODULE2, 1);
+
+    if (tsetup_root(state, AUG_TEST_MODULE, &srpds__, AUG_TEST_MODULE, "/etc/hosts", AUG_TEST_MODULE2,
+            "/etc/passwd", NULL)) {
+        return 1;
+    }
+    st = *state;
+
+    mod2 = ly_ctx_load_module(st->ctx, AUG_TEST_MODULE2, NULL, NULL);
+    if (!mod2) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int
+teardown_f(void **state)
+{
+    unsetenv(AUG_WARMUP_ENV);
+
+    return tteardown_root(state);
+}
+
+static void
+test_warmup(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    uint32_t i, queued = 0;
+    char *str;
+
+    /* the thread cannot warm up any module while the callbacks are locked */
+    pthread_mutex_lock(&auglock);
+    assert_int_equal(SR_ERR_OK, st->ds_plg->init_cb(st->mod, SR_DS_STARTUP));
+    assert_int_equal(SR_ERR_OK, st->ds_plg->init_cb(mod2, SR_DS_STARTUP));
+    assert_int_equal(SR_ERR_OK, st->ds_plg->init_cb(mod2, SR_DS_STARTUP));
+
+    /* the first module may have been dequeued, the second one is queued once */
+    pthread_mutex_lock(&augwarm.lock);
+    assert_int_equal(1, augwarm.started);
+    assert_int_equal(1, augwarm.running);
+    for (i = 0; i < augwarm.mod_count; ++i) {
+        if (!strcmp(augwarm.mods[i].mod_name, AUG_TEST_MODULE2)) {
+            ++queued;
+            assert_string_equal("Passwd", augwarm.mods[i].lens);
+        }
+    }
+    assert_int_equal(1, queued);
+    pthread_mutex_unlock(&augwarm.lock);
+    pthread_mutex_unlock(&auglock);
+
+    /* the thread finishes once the queue is empty, join it as the next warm-up would */
+    pthread_join(augwarm.tid, NULL);
+    augwarm.started = 0;
+    assert_int_equal(0, augwarm.running);
+    assert_int_equal(0, augwarm.mod_count);
+
+    /* the config files are parsed but there is no information from the context of the modules */
+    assert_int_equal(0, auginfo.mod_count);
+    assert_int_equal(1, aug_match(auginfo.aug, "/files/etc/hosts", NULL));
+    assert_int_equal(1, aug_match(auginfo.aug, "/files/etc/passwd", NULL));
+
+    /* the first loads create it in the current context */
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    free(str);
+    assert_int_equal(0, tload_print(st, mod2, &str));
+    assert_non_null(strstr(str, "avahi"));
+    free(str);
+    assert_int_equal(2, auginfo.mod_count);
+}
+
+static void
+test_stop(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+
+    /* queue a module, the thread may be waiting for the callbacks or already warming it up */
+    pthread_mutex_lock(&auglock);
+    assert_int_equal(SR_ERR_OK, st->ds_plg->init_cb(mod2, SR_DS_STARTUP));
+    assert_int_equal(1, augwarm.started);
+    pthread_mutex_unlock(&auglock);
+
+    /* unloading the plugin drops the queue and joins the thread */
+    srpds_aug_warmup_stop();
+    assert_int_equal(1, augwarm.stop);
+    assert_int_equal(0, augwarm.started);
+    assert_int_equal(0, augwarm.running);
+    assert_null(augwarm.mods);
+    assert_int_equal(0, augwarm.mod_count);
+
+    /* nothing is queued anymore */
+    assert_int_equal(SR_ERR_OK, st->ds_plg->init_cb(st->mod, SR_DS_STARTUP));
+    assert_int_equal(0, augwarm.started);
+    assert_int_equal(0, augwarm.mod_count);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_teardown(test_warmup, tteardown),
+        cmocka_unit_test(test_stop),
+    };
+
+    return cmocka_run_group_tests(tests, setup_f, teardown_f);
+}
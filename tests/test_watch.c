@@ -0,0 +1,174 @@
+/**
+ * @file test_watch.c
+ * @author agent <agent@local>
+ * @brief SR DS plugin config file watcher test
+ *
+ * @copyright
+ * Copyright (c) 2026 Deutsche Telekom AG.
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include "tconfig.h"
+
+/* augeas SR DS plugin, the config files are in a temporary root */
+#include "srds_augeas.c"
+#include "srdsa_init.c"
+#include "srdsa_load.c"
+#include "srdsa_store.c"
+#include "srdsa_common.c"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+#include <libyang/libyang.h>
+#include <sysrepo/plugins_datastore.h>
+
+#define AUG_TEST_MODULE "hosts"
+
+static int
+setup_f(void **state)
+{
+    /* watch the config files, they are parsed only if changed */
+    setenv(AUG_WATCH_ENV, "1", 1);
+
+    return tsetup_root(state, AUG_TEST_MODULE, &srpds__, AUG_TEST_MODULE, "/etc/hosts", NULL);
+}
+
+static int
+teardown_f(void **state)
+{
+    unsetenv(AUG_WATCH_ENV);
+
+    return tteardown_root(state);
+}
+
+/**
+ * @brief Write a config file in the test root as another process would.
+ *
+ * @param[in] st Test state.
+ * @param[in] path Absolute path of the file in the root.
+ * @param[in] mode Mode of fopen().
+ * @param[in] content Content to write.
+ */
+static void
+twrite_file(const struct tstate *st, const char *path, const char *mode, const char *content)
+{
+    char *file;
+    FILE *f;
+
+    assert_int_not_equal(-1, asprintf(&file, "%s%s", st->root, path));
+    f = fopen(file, mode);
+    assert_non_null(f);
+    assert_int_not_equal(EOF, fputs(content, f));
+    assert_int_equal(0, fclose(f));
+    free(file);
+}
+
+static void
+test_append(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    char *str;
+
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    assert_null(strstr(str, "<canonical>appended</canonical>"));
+    free(str);
+
+    /* the files are watched and nothing changed since the load */
+    assert_int_not_equal(-1, auginfo.watch.fd);
+    assert_int_equal(0, augds_watch_reload(&auginfo, st->mod));
+
+    /* change the file behind the back of the plugin */
+    twrite_file(st, "/etc/hosts", "a", "10.0.0.1 appended\n");
+
+    /* the next load sees the change even if the watcher thread has not processed it yet */
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    assert_non_null(strstr(str, "<canonical>appended</canonical>"));
+    free(str);
+    assert_int_equal(0, augds_watch_reload(&auginfo, st->mod));
+}
+
+static void
+test_rename(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    char *str, *from, *to;
+
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    free(str);
+
+    /* replace the file atomically as editors do */
+    twrite_file(st, "/etc/hosts.new", "w", "10.0.0.2 renamed\n");
+    assert_int_not_equal(-1, asprintf(&from, "%s/etc/hosts.new", st->root));
+    assert_int_not_equal(-1, asprintf(&to, "%s/etc/hosts", st->root));
+    assert_int_equal(0, rename(from, to));
+    free(from);
+    free(to);
+
+    /* the next load sees only the new file */
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_null(strstr(str, "<canonical>foo</canonical>"));
+    assert_non_null(strstr(str, "<canonical>renamed</canonical>"));
+    free(str);
+}
+
+static void
+test_store_error(void **state)
+{
+    struct tstate *st = (struct tstate *)*state;
+    struct lyd_node *node;
+    struct rlimit lim, orig_lim;
+    void (*orig_handler)(int);
+    char *str;
+    int rc;
+
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    free(str);
+
+    /* change the data but make writing any file fail, even as root */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(st->data, "host-list[_seq='1']/canonical", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "bar"));
+    orig_handler = signal(SIGXFSZ, SIG_IGN);
+    assert_int_equal(0, getrlimit(RLIMIT_FSIZE, &orig_lim));
+    lim = orig_lim;
+    lim.rlim_cur = 0;
+    assert_int_equal(0, setrlimit(RLIMIT_FSIZE, &lim));
+    rc = st->ds_plg->store_cb(st->mod, SR_DS_STARTUP, NULL, st->data);
+    assert_int_equal(0, setrlimit(RLIMIT_FSIZE, &orig_lim));
+    signal(SIGXFSZ, orig_handler);
+    assert_int_not_equal(SR_ERR_OK, rc);
+
+    /* the rejected change is not loaded */
+    assert_int_equal(0, tload_print(st, st->mod, &str));
+    assert_non_null(strstr(str, "<canonical>foo</canonical>"));
+    assert_null(strstr(str, "<canonical>bar</canonical>"));
+    free(str);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_teardown(test_append, tteardown),
+        cmocka_unit_test_teardown(test_store_error, tteardown),
+        cmocka_unit_test_teardown(test_rename, tteardown),
+    };
+
+    return cmocka_run_group_tests(tests, setup_f, teardown_f);
+}